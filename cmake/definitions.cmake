@@ -166,6 +166,9 @@ endif()
 if(GT_ENABLE_PERFORMANCE_METERS)
     target_compile_definitions(GridToolsTest INTERFACE GT_ENABLE_METERS)
 endif()
+if(GT_ENABLE_STAGE_METERS)
+    target_compile_definitions(GridToolsTest INTERFACE GT_ENABLE_STAGE_METERS)
+endif()
 
 ## precision ##
 if(GT_SINGLE_PRECISION)
@@ -25,6 +25,9 @@ CMAKE_DEPENDENT_OPTION(
 CMAKE_DEPENDENT_OPTION(
     GT_ENABLE_PERFORMANCE_METERS "If on, meters will be reported for each stencil"
     OFF "BUILD_TESTING" OFF)
+CMAKE_DEPENDENT_OPTION(
+    GT_ENABLE_STAGE_METERS "If on, the stages of the host backends are profiled by the region_profiler"
+    OFF "BUILD_TESTING" OFF)
 CMAKE_DEPENDENT_OPTION(
     GT_SINGLE_PRECISION "Option determining number of bytes used to represent the floating poit types (see defs.hpp for configuration)"
     OFF "BUILD_TESTING" OFF)
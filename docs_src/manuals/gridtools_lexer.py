@@ -33,6 +33,7 @@ gridtools_keywords = ((
         'level',
         'local',
         'parallel',
+        'parallel_expand_factor',
         'storage_traits',
         'vertices',
         'direction',
@@ -59,6 +60,8 @@ gridtools_functions = ((
 	'make_positional_computation',
 	'make_expandable_computation',
 	'make_expandable_positional_computation',
+	'make_computation_sequence',
+	'intermediates',
 	'make_global_parameter',
 	'update_global_parameter',
 	'make_host_view',
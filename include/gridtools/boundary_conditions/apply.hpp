@@ -9,6 +9,9 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+
 #include "../common/defs.hpp"
 #include "../common/halo_descriptor.hpp"
 #include "direction.hpp"
@@ -25,6 +28,38 @@ namespace gridtools {
      * @{
      */
 
+    namespace boundary_apply_impl_ {
+        /**
+         * @brief A halo region of one direction. The points of the region are numbered with i running fastest, the
+         * boundary function is applied to them by `fun`, a function of the direction.
+         */
+        template <typename Fun>
+        struct region {
+            Fun fun;
+            int_t i_low, j_low, k_low;
+            int_t i_size, j_size, k_size;
+            int_t first; // number of the first point of the region among the points of all the regions
+
+            int_t size() const { return i_size * j_size * k_size; }
+        };
+
+        /**
+         * @brief The halo regions of the faces, of the edges or of the corners.
+         */
+        template <typename Fun>
+        struct phase {
+            region<Fun> regions[12];
+            int_t num_regions = 0;
+            int_t num_points = 0;
+        };
+
+        // the faces are applied first, then the edges and finally the corners
+        template <typename Direction>
+        constexpr int_t phase_index() {
+            return (Direction::i != zero_) + (Direction::j != zero_) + (Direction::k != zero_) - 1;
+        }
+    } // namespace boundary_apply_impl_
+
     template <typename BoundaryFunction,
         typename Predicate = default_predicate,
         typename HaloDescriptors = array<halo_descriptor, 3u>>
@@ -34,24 +69,79 @@ namespace gridtools {
         BoundaryFunction const boundary_function;
         Predicate predicate;
 
-        /** @brief loops on the halo region defined by the HaloDescriptor member parameter, and evaluates the
-           boundary_function in the specified direction, in the specified halo node.
-            this macro expands to n definitions of the function loop, taking a number of arguments ranging from 0 to n
-           (DataField0, Datafield1, DataField2, ...)*/
+        template <typename... DataField>
+        using apply_row_t = void (*)(boundary_apply const &, int_t, int_t, int_t, int_t, int_t, DataField &...);
+
+        template <typename... DataField>
+        using region_t = boundary_apply_impl_::region<apply_row_t<DataField...>>;
+
+        template <typename... DataField>
+        using phase_t = boundary_apply_impl_::phase<apply_row_t<DataField...>>;
+
+        /** @brief evaluates the boundary_function in the specified direction on the points i_begin to i_end - 1 of
+         * the row j, k. The inner loop is vectorized.
+         */
+        template <typename Direction, typename... DataField>
+        static void apply_row(boundary_apply const &self,
+            int_t i_low,
+            int_t i_begin,
+            int_t i_end,
+            int_t j,
+            int_t k,
+            DataField &... data_field) {
+#pragma omp simd
+            for (int_t i = i_low + i_begin; i < i_low + i_end; ++i)
+                self.boundary_function(Direction(), data_field..., i, j, k);
+        }
+
+        /** @brief adds the halo region of the direction to the list of regions of its phase, if the predicate is
+         * true for the direction and the region is not empty.
+         */
         template <typename Direction, typename... DataField>
-        void loop(DataField &... data_field) const {
-            const int_t i_low = halo_descriptors[0].loop_low_bound_outside(Direction::i);
-            const int_t i_high = halo_descriptors[0].loop_high_bound_outside(Direction::i);
-            const int_t j_low = halo_descriptors[1].loop_low_bound_outside(Direction::j);
-            const int_t j_high = halo_descriptors[1].loop_high_bound_outside(Direction::j);
-            const int_t k_low = halo_descriptors[2].loop_low_bound_outside(Direction::k);
-            const int_t k_high = halo_descriptors[2].loop_high_bound_outside(Direction::k);
-
-#pragma omp parallel for simd collapse(3)
-            for (int_t j = j_low; j <= j_high; ++j)
-                for (int_t k = k_low; k <= k_high; ++k)
-                    for (int_t i = i_low; i <= i_high; ++i)
-                        boundary_function(Direction(), data_field..., i, j, k);
+        void add_region(phase_t<DataField...> *phases) const {
+            if (!predicate(Direction()))
+                return;
+            region_t<DataField...> region;
+            region.fun = &boundary_apply::apply_row<Direction, DataField...>;
+            region.i_low = halo_descriptors[0].loop_low_bound_outside(Direction::i);
+            region.j_low = halo_descriptors[1].loop_low_bound_outside(Direction::j);
+            region.k_low = halo_descriptors[2].loop_low_bound_outside(Direction::k);
+            region.i_size = halo_descriptors[0].loop_high_bound_outside(Direction::i) - region.i_low + 1;
+            region.j_size = halo_descriptors[1].loop_high_bound_outside(Direction::j) - region.j_low + 1;
+            region.k_size = halo_descriptors[2].loop_high_bound_outside(Direction::k) - region.k_low + 1;
+            if (region.i_size <= 0 || region.j_size <= 0 || region.k_size <= 0)
+                return;
+            auto &phase = phases[boundary_apply_impl_::phase_index<Direction>()];
+            region.first = phase.num_points;
+            phase.num_points += region.size();
+            phase.regions[phase.num_regions++] = region;
+        }
+
+        /** @brief applies the boundary function on the points [begin, end) of the list of regions. */
+        template <typename... DataField>
+        void apply_regions(region_t<DataField...> const *regions,
+            int_t num_regions,
+            int_t begin,
+            int_t end,
+            DataField &... data_field) const {
+            for (int_t r = 0; r < num_regions; ++r) {
+                auto const &region = regions[r];
+                int_t first = std::max(begin, region.first) - region.first;
+                int_t last = std::min(end, region.first + region.size()) - region.first;
+                while (first < last) {
+                    int_t row = first / region.i_size;
+                    int_t i_begin = first % region.i_size;
+                    int_t i_end = std::min(region.i_size, i_begin + last - first);
+                    region.fun(*this,
+                        region.i_low,
+                        i_begin,
+                        i_end,
+                        region.j_low + row / region.k_size,
+                        region.k_low + row % region.k_size,
+                        data_field...);
+                    first += i_end - i_begin;
+                }
+            }
         }
 
       public:
@@ -64,75 +154,75 @@ namespace gridtools {
         /**
            @brief applies the boundary conditions looping on the halo region defined by the member parameter, in all
         possible directions.
-        this macro expands to n definitions of the function apply, taking a number of arguments ranging from 0 to n
-        (DataField0, Datafield1, DataField2, ...)
 
+        The halo regions of the directions selected by the predicate are applied in three phases: the faces, the
+        edges and the corners. Within a phase, the regions are collected in a single list of points, which is split
+        evenly among the threads of a single parallel region, with a barrier between the phases. Small regions, like
+        the corners, do not need a parallel region on their own, and the rows of the faces are still processed with
+        vectorized loops. Hence a boundary function may read the interior and the halo regions of the previous phases
+        (e.g. a corner may be computed from the adjacent edges), but not the other halo regions of its own phase.
         */
         template <typename... DataFieldViews>
         void apply(DataFieldViews const &... data_field_views) const {
-
-            if (predicate(direction<minus_, minus_, minus_>()))
-                this->loop<direction<minus_, minus_, minus_>>(data_field_views...);
-            if (predicate(direction<minus_, minus_, zero_>()))
-                this->loop<direction<minus_, minus_, zero_>>(data_field_views...);
-            if (predicate(direction<minus_, minus_, plus_>()))
-                this->loop<direction<minus_, minus_, plus_>>(data_field_views...);
-
-            if (predicate(direction<minus_, zero_, minus_>()))
-                this->loop<direction<minus_, zero_, minus_>>(data_field_views...);
-            if (predicate(direction<minus_, zero_, zero_>()))
-                this->loop<direction<minus_, zero_, zero_>>(data_field_views...);
-            if (predicate(direction<minus_, zero_, plus_>()))
-                this->loop<direction<minus_, zero_, plus_>>(data_field_views...);
-
-            if (predicate(direction<minus_, plus_, minus_>()))
-                this->loop<direction<minus_, plus_, minus_>>(data_field_views...);
-            if (predicate(direction<minus_, plus_, zero_>()))
-                this->loop<direction<minus_, plus_, zero_>>(data_field_views...);
-            if (predicate(direction<minus_, plus_, plus_>()))
-                this->loop<direction<minus_, plus_, plus_>>(data_field_views...);
-
-            if (predicate(direction<zero_, minus_, minus_>()))
-                this->loop<direction<zero_, minus_, minus_>>(data_field_views...);
-            if (predicate(direction<zero_, minus_, zero_>()))
-                this->loop<direction<zero_, minus_, zero_>>(data_field_views...);
-            if (predicate(direction<zero_, minus_, plus_>()))
-                this->loop<direction<zero_, minus_, plus_>>(data_field_views...);
-
-            if (predicate(direction<zero_, zero_, minus_>()))
-                this->loop<direction<zero_, zero_, minus_>>(data_field_views...);
-            if (predicate(direction<zero_, zero_, plus_>()))
-                this->loop<direction<zero_, zero_, plus_>>(data_field_views...);
-
-            if (predicate(direction<zero_, plus_, minus_>()))
-                this->loop<direction<zero_, plus_, minus_>>(data_field_views...);
-            if (predicate(direction<zero_, plus_, zero_>()))
-                this->loop<direction<zero_, plus_, zero_>>(data_field_views...);
-            if (predicate(direction<zero_, plus_, plus_>()))
-                this->loop<direction<zero_, plus_, plus_>>(data_field_views...);
-
-            if (predicate(direction<plus_, minus_, minus_>()))
-                this->loop<direction<plus_, minus_, minus_>>(data_field_views...);
-            if (predicate(direction<plus_, minus_, zero_>()))
-                this->loop<direction<plus_, minus_, zero_>>(data_field_views...);
-            if (predicate(direction<plus_, minus_, plus_>()))
-                this->loop<direction<plus_, minus_, plus_>>(data_field_views...);
-
-            if (predicate(direction<plus_, zero_, minus_>()))
-                this->loop<direction<plus_, zero_, minus_>>(data_field_views...);
-            if (predicate(direction<plus_, zero_, zero_>()))
-                this->loop<direction<plus_, zero_, zero_>>(data_field_views...);
-            if (predicate(direction<plus_, zero_, plus_>()))
-                this->loop<direction<plus_, zero_, plus_>>(data_field_views...);
-
-            if (predicate(direction<plus_, plus_, minus_>()))
-                this->loop<direction<plus_, plus_, minus_>>(data_field_views...);
-            if (predicate(direction<plus_, plus_, zero_>()))
-                this->loop<direction<plus_, plus_, zero_>>(data_field_views...);
-            if (predicate(direction<plus_, plus_, plus_>()))
-                this->loop<direction<plus_, plus_, plus_>>(data_field_views...);
-
-            // apply(data_field_views ...);
+            phase_t<DataFieldViews const...> phases[3];
+
+            add_region<direction<minus_, minus_, minus_>>(phases);
+            add_region<direction<minus_, minus_, zero_>>(phases);
+            add_region<direction<minus_, minus_, plus_>>(phases);
+
+            add_region<direction<minus_, zero_, minus_>>(phases);
+            add_region<direction<minus_, zero_, zero_>>(phases);
+            add_region<direction<minus_, zero_, plus_>>(phases);
+
+            add_region<direction<minus_, plus_, minus_>>(phases);
+            add_region<direction<minus_, plus_, zero_>>(phases);
+            add_region<direction<minus_, plus_, plus_>>(phases);
+
+            add_region<direction<zero_, minus_, minus_>>(phases);
+            add_region<direction<zero_, minus_, zero_>>(phases);
+            add_region<direction<zero_, minus_, plus_>>(phases);
+
+            add_region<direction<zero_, zero_, minus_>>(phases);
+            add_region<direction<zero_, zero_, plus_>>(phases);
+
+            add_region<direction<zero_, plus_, minus_>>(phases);
+            add_region<direction<zero_, plus_, zero_>>(phases);
+            add_region<direction<zero_, plus_, plus_>>(phases);
+
+            add_region<direction<plus_, minus_, minus_>>(phases);
+            add_region<direction<plus_, minus_, zero_>>(phases);
+            add_region<direction<plus_, minus_, plus_>>(phases);
+
+            add_region<direction<plus_, zero_, minus_>>(phases);
+            add_region<direction<plus_, zero_, zero_>>(phases);
+            add_region<direction<plus_, zero_, plus_>>(phases);
+
+            add_region<direction<plus_, plus_, minus_>>(phases);
+            add_region<direction<plus_, plus_, zero_>>(phases);
+            add_region<direction<plus_, plus_, plus_>>(phases);
+
+            if (phases[0].num_points + phases[1].num_points + phases[2].num_points == 0)
+                return;
+
+#pragma omp parallel
+            {
+                int_t threads = omp_get_num_threads();
+                int_t thread = omp_get_thread_num();
+                bool wait = false;
+                for (auto const &phase : phases) {
+                    if (phase.num_points == 0)
+                        continue;
+                    if (wait) {
+#pragma omp barrier
+                    }
+                    apply_regions(phase.regions,
+                        phase.num_regions,
+                        (std::int64_t)phase.num_points * thread / threads,
+                        (std::int64_t)phase.num_points * (thread + 1) / threads,
+                        data_field_views...);
+                    wait = true;
+                }
+            }
         }
 
       private:
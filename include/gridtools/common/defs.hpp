@@ -39,6 +39,8 @@ namespace gridtools {
     typedef int omp_int_t;
     inline omp_int_t omp_get_thread_num() { return 0; }
     inline omp_int_t omp_get_max_threads() { return 1; }
+    inline omp_int_t omp_get_num_threads() { return 1; }
+    inline void omp_set_num_threads(omp_int_t) {}
     inline double omp_get_wtime() { return 0; }
 } // namespace gridtools
 #endif
@@ -78,15 +80,31 @@ namespace gridtools {
         };
     } // namespace cuda
 
+    /** tags specifying how the cpu backends distribute the blocks of the domain to the threads */
+    namespace schedule {
+        /** contiguous chunks of blocks per thread, fixed upfront */
+        struct static_ {};
+        /** chunks of decreasing size, taken from a shared queue */
+        struct guided {};
+        /** contiguous chunks of blocks per thread, idle threads steal from the others */
+        struct work_stealing {};
+    } // namespace schedule
+
     namespace mc {
-        struct backend {};
+        template <class Schedule = schedule::static_>
+        struct backend {
+            using schedule_t = Schedule;
+        };
     } // namespace mc
 
     namespace x86 {
-        template <class IBlockSize = integral_constant<int_t, 8>, class JBlockSize = integral_constant<int_t, 8>>
+        template <class IBlockSize = integral_constant<int_t, 8>,
+            class JBlockSize = integral_constant<int_t, 8>,
+            class Schedule = schedule::static_>
         struct backend {
             using i_block_size_t = IBlockSize;
             using j_block_size_t = JBlockSize;
+            using schedule_t = Schedule;
 
             static constexpr i_block_size_t i_block_size() { return {}; }
             static constexpr j_block_size_t j_block_size() { return {}; }
@@ -96,7 +114,7 @@ namespace gridtools {
     /** tags specifying the backend to use */
     namespace backend {
         using cuda = cuda::backend<>;
-        using mc = mc::backend;
+        using mc = mc::backend<>;
         using x86 = x86::backend<>;
         using naive = naive::backend;
     } // namespace backend
@@ -0,0 +1,447 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ *  @file
+ *  Hierarchical profiling of named code regions.
+ *
+ *  The regions form a tree (computation, multistage, stage). Every thread accumulates the wall time and the number
+ *  of calls of the regions it executes and records a trace of them. If enabled, the `perf_event_open` hardware
+ *  counters (cycles and last level cache misses) of the calling thread are read at the beginning and at the end of
+ *  every stage region. The results can be exported as JSON or in the Chrome trace event format (to be loaded in
+ *  `chrome://tracing` or Perfetto).
+ *
+ *  The export and `reset` must not run concurrently with the profiled code.
+ */
+
+namespace gridtools {
+    namespace region_profiler_impl_ {
+        using clock = std::chrono::steady_clock;
+
+        enum class region_kind { computation, multistage, stage };
+
+        inline char const *to_string(region_kind kind) {
+            switch (kind) {
+            case region_kind::computation:
+                return "computation";
+            case region_kind::multistage:
+                return "multistage";
+            default:
+                return "stage";
+            }
+        }
+
+        struct counters {
+            std::uint64_t cycles = 0;
+            std::uint64_t llc_misses = 0;
+
+            counters &operator+=(counters const &other) {
+                cycles += other.cycles;
+                llc_misses += other.llc_misses;
+                return *this;
+            }
+
+            friend counters operator-(counters const &lhs, counters const &rhs) {
+                return {lhs.cycles - rhs.cycles, lhs.llc_misses - rhs.llc_misses};
+            }
+        };
+
+        /**
+         *  The cycles and the last level cache misses of the calling thread, read as a single group.
+         */
+        class perf_counters {
+            int m_leader = -1;
+            int m_member = -1;
+
+#ifdef __linux__
+            static int open_event(std::uint64_t config, int group) {
+                perf_event_attr attr = {};
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.size = sizeof(attr);
+                attr.config = config;
+                attr.disabled = group < 0;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP;
+                return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+            }
+#endif
+
+          public:
+            perf_counters() {
+#ifdef __linux__
+                m_leader = open_event(PERF_COUNT_HW_CPU_CYCLES, -1);
+                if (m_leader < 0)
+                    return;
+                m_member = open_event(PERF_COUNT_HW_CACHE_MISSES, m_leader);
+                if (m_member < 0) {
+                    close(m_leader);
+                    m_leader = -1;
+                    return;
+                }
+                ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+            }
+
+            perf_counters(perf_counters const &) = delete;
+            perf_counters &operator=(perf_counters const &) = delete;
+
+            ~perf_counters() {
+#ifdef __linux__
+                if (m_member >= 0)
+                    close(m_member);
+                if (m_leader >= 0)
+                    close(m_leader);
+#endif
+            }
+
+            bool valid() const { return m_leader >= 0; }
+
+            counters read() const {
+#ifdef __linux__
+                struct {
+                    std::uint64_t nr;
+                    std::uint64_t values[2];
+                } buf;
+                if (valid() && ::read(m_leader, &buf, sizeof(buf)) == sizeof(buf))
+                    return {buf.values[0], buf.values[1]};
+#endif
+                return {};
+            }
+        };
+
+        struct region_info {
+            std::string name;
+            int parent;
+            region_kind kind;
+        };
+
+        struct region_stats {
+            std::size_t count = 0;
+            double time = 0;
+            counters hw;
+        };
+
+        struct trace_event {
+            int region;
+            double start;
+            double duration;
+            counters hw;
+        };
+
+        struct thread_data {
+            int id;
+            std::vector<region_stats> stats;
+            std::vector<trace_event> events;
+            std::size_t dropped = 0;
+            std::unique_ptr<perf_counters> hw;
+        };
+
+        inline std::string escape(std::string const &src) {
+            std::string res;
+            for (char c : src) {
+                if (c == '"' || c == '\\') {
+                    res += '\\';
+                    res += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    res += buf;
+                } else {
+                    res += c;
+                }
+            }
+            return res;
+        }
+    } // namespace region_profiler_impl_
+
+    /**
+     *  The summary of a region, merged over all threads.
+     *
+     *  The time of a computation is the wall time of its runs, the time of a stage is the sum over the threads of
+     *  the time spent in it, the time of a multistage is the sum over its stages. The hardware counters are
+     *  collected in the stages and summed up over the tree, `bytes` is the estimated memory traffic of the last
+     *  level cache misses.
+     */
+    struct region_summary {
+        std::string name;
+        int parent;
+        std::string kind;
+        std::size_t count;
+        double time;
+        std::uint64_t cycles;
+        std::uint64_t llc_misses;
+        std::uint64_t bytes;
+    };
+
+    class region_profiler {
+        using clock = region_profiler_impl_::clock;
+        using counters = region_profiler_impl_::counters;
+        using thread_data = region_profiler_impl_::thread_data;
+
+        static constexpr std::uint64_t cache_line_size = 64;
+
+        mutable std::mutex m_mutex;
+        clock::time_point m_epoch = clock::now();
+        std::map<std::pair<int, std::string>, int> m_ids;
+        std::vector<region_profiler_impl_::region_info> m_regions;
+        std::vector<std::unique_ptr<thread_data>> m_threads;
+        std::atomic<bool> m_counters{false};
+        std::atomic<std::size_t> m_max_events{std::size_t(1) << 16};
+
+        region_profiler() = default;
+
+        thread_data &local() {
+            static thread_local thread_data *res = nullptr;
+            if (!res) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_threads.emplace_back(new thread_data{(int)m_threads.size(), {}, {}, 0, nullptr});
+                res = m_threads.back().get();
+            }
+            return *res;
+        }
+
+        double since_epoch(clock::time_point time) const {
+            return std::chrono::duration<double>(time - m_epoch).count();
+        }
+
+        bool has_counters() const {
+            for (auto const &data : m_threads)
+                if (data->hw && data->hw->valid())
+                    return true;
+            return false;
+        }
+
+        void write_region(std::ostream &out, std::vector<region_summary> const &regions, int id, bool hw) const {
+            auto const &region = regions[id];
+            out << "{\"name\":\"" << region_profiler_impl_::escape(region.name) << "\",\"kind\":\"" << region.kind
+                << "\",\"calls\":" << region.count << ",\"time\":" << region.time;
+            if (hw)
+                out << ",\"cycles\":" << region.cycles << ",\"llc_misses\":" << region.llc_misses
+                    << ",\"bytes\":" << region.bytes;
+            out << ",\"children\":[";
+            bool first = true;
+            for (int child = 0; child != (int)regions.size(); ++child) {
+                if (regions[child].parent != id)
+                    continue;
+                if (!first)
+                    out << ",";
+                first = false;
+                write_region(out, regions, child, hw);
+            }
+            out << "]}";
+        }
+
+      public:
+        using region_kind = region_profiler_impl_::region_kind;
+
+        region_profiler(region_profiler const &) = delete;
+        region_profiler &operator=(region_profiler const &) = delete;
+
+        static region_profiler &instance() {
+            static region_profiler res;
+            return res;
+        }
+
+        /**
+         *  Registers the region `name` below `parent` (-1 for the root) and returns its id, the same name below the
+         *  same parent always gives the same id.
+         */
+        int region(std::string const &name, int parent, region_kind kind) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto res = m_ids.emplace(std::make_pair(parent, name), (int)m_regions.size());
+            if (res.second)
+                m_regions.push_back({name, parent, kind});
+            return res.first->second;
+        }
+
+        /**
+         *  Enables the hardware counters, they are opened lazily by every thread. If `perf_event_open` is not
+         *  available (or not permitted, see `/proc/sys/kernel/perf_event_paranoid`) they are silently omitted.
+         */
+        void enable_counters(bool value = true) { m_counters = value; }
+
+        /**
+         *  Sets the maximal number of trace events that are recorded per thread, the later ones are dropped.
+         */
+        void set_max_events(std::size_t value) { m_max_events = value; }
+
+        /**
+         *  Clears all the measurements, the regions stay registered.
+         */
+        void reset() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto &data : m_threads) {
+                data->stats.clear();
+                data->events.clear();
+                data->dropped = 0;
+            }
+            m_epoch = clock::now();
+        }
+
+        /**
+         *  Measures the lifetime of the object as a call of `region`.
+         */
+        class scope {
+            region_profiler &m_profiler;
+            thread_data &m_data;
+            int m_region;
+            bool m_hw;
+            counters m_start_hw;
+            clock::time_point m_start;
+
+          public:
+            scope(int region, bool hw = true)
+                : m_profiler(instance()), m_data(m_profiler.local()), m_region(region),
+                  m_hw(hw && m_profiler.m_counters) {
+                if (m_hw) {
+                    if (!m_data.hw)
+                        m_data.hw.reset(new region_profiler_impl_::perf_counters());
+                    m_start_hw = m_data.hw->read();
+                }
+                m_start = clock::now();
+            }
+
+            scope(scope const &) = delete;
+            scope &operator=(scope const &) = delete;
+
+            ~scope() {
+                auto end = clock::now();
+                counters hw;
+                if (m_hw)
+                    hw = m_data.hw->read() - m_start_hw;
+                if (m_data.stats.size() <= (std::size_t)m_region)
+                    m_data.stats.resize(m_region + 1);
+                double duration = std::chrono::duration<double>(end - m_start).count();
+                auto &stats = m_data.stats[m_region];
+                ++stats.count;
+                stats.time += duration;
+                stats.hw += hw;
+                if (m_data.events.size() < m_profiler.m_max_events)
+                    m_data.events.push_back({m_region, m_profiler.since_epoch(m_start), duration, hw});
+                else
+                    ++m_data.dropped;
+            }
+        };
+
+        /**
+         *  The summaries of all regions indexed by their ids. The parents have smaller ids than their children.
+         */
+        std::vector<region_summary> summary() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::vector<region_profiler_impl_::region_stats> stats(m_regions.size());
+            for (auto const &data : m_threads)
+                for (std::size_t id = 0; id != data->stats.size() && id != stats.size(); ++id) {
+                    stats[id].count += data->stats[id].count;
+                    stats[id].time += data->stats[id].time;
+                    stats[id].hw += data->stats[id].hw;
+                }
+            for (std::size_t id = stats.size(); id-- != 0;) {
+                int parent = m_regions[id].parent;
+                if (parent < 0)
+                    continue;
+                stats[parent].hw += stats[id].hw;
+                if (m_regions[parent].kind == region_kind::multistage)
+                    stats[parent].time += stats[id].time;
+            }
+            std::vector<region_summary> res;
+            for (std::size_t id = 0; id != m_regions.size(); ++id) {
+                auto const &region = m_regions[id];
+                std::size_t count = stats[id].count;
+                if (region.kind == region_kind::multistage && region.parent >= 0)
+                    count = res[region.parent].count;
+                res.push_back({region.name,
+                    region.parent,
+                    region_profiler_impl_::to_string(region.kind),
+                    count,
+                    stats[id].time,
+                    stats[id].hw.cycles,
+                    stats[id].hw.llc_misses,
+                    stats[id].hw.llc_misses * cache_line_size});
+            }
+            return res;
+        }
+
+        /**
+         *  Writes the tree of the regions with their summaries.
+         */
+        void write_json(std::ostream &out) const {
+            auto regions = summary();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            bool hw = has_counters();
+            std::size_t dropped = 0;
+            for (auto const &data : m_threads)
+                dropped += data->dropped;
+            out << "{\"threads\":" << m_threads.size() << ",\"counters\":" << (hw ? "true" : "false")
+                << ",\"dropped_events\":" << dropped << ",\"regions\":[";
+            bool first = true;
+            for (int id = 0; id != (int)regions.size(); ++id) {
+                if (regions[id].parent >= 0)
+                    continue;
+                if (!first)
+                    out << ",";
+                first = false;
+                write_region(out, regions, id, hw);
+            }
+            out << "]}\n";
+        }
+
+        /**
+         *  Writes the recorded events in the Chrome trace event format, every thread is a separate track.
+         */
+        void write_chrome_trace(std::ostream &out) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto flags = out.flags();
+            auto precision = out.precision();
+            out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+            bool first = true;
+            for (auto const &data : m_threads)
+                for (auto const &event : data->events) {
+                    auto const &region = m_regions[event.region];
+                    if (!first)
+                        out << ",";
+                    first = false;
+                    out << "\n{\"name\":\"" << region_profiler_impl_::escape(region.name) << "\",\"cat\":\""
+                        << region_profiler_impl_::to_string(region.kind) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+                        << data->id << ",\"ts\":" << event.start * 1e6 << ",\"dur\":" << event.duration * 1e6;
+                    if (data->hw && data->hw->valid() && region.kind == region_kind::stage)
+                        out << ",\"args\":{\"cycles\":" << event.hw.cycles
+                            << ",\"llc_misses\":" << event.hw.llc_misses << "}";
+                    out << "}";
+                }
+            out << "\n]}\n";
+            out.flags(flags);
+            out.precision(precision);
+        }
+    };
+} // namespace gridtools
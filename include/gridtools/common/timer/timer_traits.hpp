@@ -44,8 +44,8 @@ namespace gridtools {
     struct timer_traits<backend::naive> {
         using timer_type = timer_omp;
     };
-    template <>
-    struct timer_traits<backend::mc> {
+    template <class... Params>
+    struct timer_traits<mc::backend<Params...>> {
         using timer_type = timer_omp;
     };
 #endif
@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include <utility>
+
 #include "../common/halo_descriptor.hpp"
 #include "low_level/Generic_All_to_All.hpp"
 #include "low_level/access_functions.hpp"
@@ -66,9 +68,6 @@ namespace gridtools {
          */
         template <typename arraytype1, typename arraytype2>
         void register_block_to(value_type *field, arraytype1 const &halo_block, arraytype2 const &coords) {
-#ifndef NDEBUG
-            std::cout << "register_block_to " << proc_grid.abs_proc(coords) << "\n";
-#endif
             a2a.to[proc_grid.abs_proc(coords)] =
                 packet<value_type>(_impl::make_datatype<value_type>::make(halo_block), field);
         }
@@ -91,14 +90,14 @@ namespace gridtools {
          */
         template <typename arraytype1, typename arraytype2>
         void register_block_from(value_type *field, arraytype1 const &halo_block, arraytype2 const &coords) {
-#ifndef NDEBUG
-            std::cout << "register_block_from " << proc_grid.abs_proc(coords) << "\n";
-#endif
             a2a.from[proc_grid.abs_proc(coords)] =
                 packet<value_type>(_impl::make_datatype<value_type>::make(halo_block), field);
         }
 
-        /** This method prepare the pattern to be ready to execute
+        /** This method prepare the pattern to be ready to execute. It is
+            collective and has to be called again after registering
+            different blocks; the exchanges in between reuse the
+            communication requests.
          */
         void setup() { a2a.setup(); }
 
@@ -119,5 +118,14 @@ namespace gridtools {
         /** This method waits for the data to arrive and be unpacked
          */
         void wait() { a2a.wait(); }
+
+        /** This method waits for the data to arrive and calls
+            `on_arrival(p)` as soon as the block from the process with
+            absolute id `p` has been received, in the order of arrival.
+         */
+        template <typename F>
+        void wait(F &&on_arrival) {
+            a2a.wait(std::forward<F>(on_arrival));
+        }
     };
 } // namespace gridtools
@@ -9,16 +9,20 @@
  */
 #pragma once
 
+#include <type_traits>
+
 #include "../common/boollist.hpp"
 #include "low_level/Halo_Exchange_3D.hpp"
 #include "low_level/proc_grids_3D.hpp"
 
 #include "high_level/descriptor_generic_manual.hpp"
 #include "high_level/descriptors.hpp"
+#include "high_level/descriptors_dt.hpp"
 #include "high_level/descriptors_fwd.hpp"
 #include "high_level/descriptors_manual_gpu.hpp"
 
 #include "high_level/field_on_the_fly.hpp"
+#include "high_level/gcl_parameters.hpp"
 
 namespace gridtools {
 
@@ -177,12 +181,15 @@ namespace gridtools {
        \tparam DIMS Number of dimensions of data arrays (equal to the dimension of the processor grid)
        \tparam GCL_ARCH Specification of the "architecture", that is the place where the data to be exchanged is.
        Possible coiches are defined in low_level/gcl_arch.h .
+       \tparam version Implementation of the exchange, see gridtools::halo_exchange_version. With version_datatype
+       the data is sent and received directly from the fields, which then must be the same for pack and unpack and
+       must not be modified between start_exchange and wait.
     */
     template <typename T_layout_map,
         typename layout2proc_map_abs,
         typename DataType,
         typename Gcl_Arch = gcl_cpu,
-        int version = 0>
+        int version = version_manual>
     class halo_exchange_dynamic_ut {
 
       private:
@@ -216,7 +223,12 @@ namespace gridtools {
             return CartComm;
         }
 
-        typedef hndlr_dynamic_ut<DataType, grid_type, pattern_type, layout2proc_map, Gcl_Arch> hd_t;
+        GT_STATIC_ASSERT((version != version_datatype || std::is_same<Gcl_Arch, gcl_cpu>::value),
+            "version_datatype is only available for gcl_cpu");
+
+        typedef typename std::conditional<version == version_datatype,
+            hndlr_datatype_ut<DataType, grid_type, pattern_type, layout2proc_map>,
+            hndlr_dynamic_ut<DataType, grid_type, pattern_type, layout2proc_map, Gcl_Arch>>::type hd_t;
 
         hd_t hd;
 
@@ -322,6 +334,15 @@ namespace gridtools {
             hd.halo.add_halo(layout_map::template at<DI>(), halo);
         }
 
+        /**
+           Function to enable (or disable) persistent communication requests. The requests for all the neighbors
+           are then created once and started at each exchange, instead of calling MPI_Isend and MPI_Irecv every
+           time. They are recreated when the number of fields changes.
+
+           \param[in] value True to use persistent requests
+        */
+        void use_persistent_requests(bool value = true) { hd.use_persistent_requests(value); }
+
         /**
            Function to pack data to be sent
 
@@ -550,6 +571,14 @@ namespace gridtools {
             hd.setup(max_fields_n, halo_example, typesize);
         }
 
+        /**
+           Function to enable (or disable) persistent communication requests, see
+           halo_exchange_dynamic_ut::use_persistent_requests.
+
+           \param[in] value True to use persistent requests
+        */
+        void use_persistent_requests(bool value = true) { hd.use_persistent_requests(value); }
+
         /**
            Function to pack data to be sent
 
@@ -41,6 +41,11 @@ namespace gridtools {
         */
         void exchange() { m_haloexch.exchange(); }
 
+        /**
+           function to enable (or disable) persistent communication requests, see Halo_Exchange_3D.
+        */
+        void use_persistent_requests(bool value) { m_haloexch.use_persistent_requests(value); }
+
         /**
            function to trigger posting of receives when using split-phase communication.
         */
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "../../common/array.hpp"
+#include "../../common/defs.hpp"
 #include "../../common/gt_assert.hpp"
 #include "../../common/make_array.hpp"
 #include "../low_level/Halo_Exchange_3D.hpp"
@@ -24,6 +25,7 @@
 #include "descriptors_fwd.hpp"
 #include "empty_field_base.hpp"
 #include "gcl_parameters.hpp"
+#include "halo_pack.hpp"
 #include "helpers_impl.hpp"
 
 namespace gridtools {
@@ -62,74 +64,90 @@ namespace gridtools {
 
         const halo_descriptor *raw_array() const { return &(base_type::halos[0]); }
 
+        /**
+           The region of the field to be sent to the neighbor eta (inside = true) or to be received from it.
+        */
+        halo_region region(gridtools::array<int, 3> const &eta, bool inside) const {
+            halo_region res;
+            for (int i = 0; i < 3; ++i) {
+                res.low[i] = inside ? halos[i].loop_low_bound_inside(eta[i]) : halos[i].loop_low_bound_outside(eta[i]);
+                res.high[i] =
+                    inside ? halos[i].loop_high_bound_inside(eta[i]) : halos[i].loop_high_bound_outside(eta[i]);
+                res.total_length[i] = halos[i].total_length();
+            }
+            return res;
+        }
+
+        /**
+           Packs the part `part` out of `num_parts` of the halo for the neighbor eta, see gridtools::pack_region.
+           The iterator is advanced past the data of the whole halo, independently of the part.
+        */
+        template <typename iterator_in, typename iterator_out>
+        void pack_part(gridtools::array<int, 3> const &eta,
+            iterator_in const *field_ptr,
+            iterator_out *&it,
+            int part,
+            int num_parts) const {
+            int size = pack_region(region(eta, true), field_ptr, it, part, num_parts);
+            reinterpret_cast<char *&>(it) += size * sizeof(iterator_in);
+        }
+
+        /**
+           Unpacks the part `part` out of `num_parts` of the halo from the neighbor eta, see gridtools::unpack_region.
+           The iterator is advanced past the data of the whole halo, independently of the part.
+        */
+        template <typename iterator_in, typename iterator_out>
+        void unpack_part(gridtools::array<int, 3> const &eta,
+            iterator_in *field_ptr,
+            iterator_out *&it,
+            int part,
+            int num_parts) const {
+            int size = unpack_region(region(eta, false), field_ptr, it, part, num_parts);
+            reinterpret_cast<char *&>(it) += size * sizeof(iterator_in);
+        }
+
         template <typename iterator_in, typename iterator_out>
         void pack(gridtools::array<int, 3> const &eta, iterator_in const *field_ptr, iterator_out *&it) const {
-            // std::cout << "BASE ADDR IN PACK " << std::hex << reinterpret_cast<void*>(it) << std::dec << std::endl;
-            // std::cout << "k=" << base_type::halos[2].loop_low_bound_inside(eta[2])
-            //           << " to <= " << base_type::halos[2].loop_high_bound_inside(eta[2]) << ",\n"
-            //           << "j=" << base_type::halos[1].loop_low_bound_inside(eta[1])
-            //           << " to <= " << base_type::halos[1].loop_high_bound_inside(eta[1]) << ",\n"
-            //           << "i=" << base_type::halos[0].loop_low_bound_inside(eta[0])
-            //           << " to <= " << base_type::halos[0].loop_high_bound_inside(eta[0])
-            //           << std::endl;
-            for (int k = halos[2].loop_low_bound_inside(eta[2]); k <= halos[2].loop_high_bound_inside(eta[2]); ++k) {
-                for (int j = halos[1].loop_low_bound_inside(eta[1]); j <= halos[1].loop_high_bound_inside(eta[1]);
-                     ++j) {
-                    for (int i = halos[0].loop_low_bound_inside(eta[0]); i <= halos[0].loop_high_bound_inside(eta[0]);
-                         ++i) {
-
-                        // std::cout << "      "
-                        //           << i << ", "
-                        //           << j << ", "
-                        //           << k << ", "
-                        //           << base_type::halos[0].total_length() << ", "
-                        //           << base_type::halos[1].total_length() << ", "
-                        //           << base_type::halos[2].total_length() << ", "
-                        //           << field_ptr[gridtools::access
-                        //                        (i,j,k,
-                        //                         base_type::halos[0].total_length(),
-                        //                         base_type::halos[1].total_length(),
-                        //                         base_type::halos[2].total_length())]
-                        //           << std::endl;
-
-                        *(reinterpret_cast<iterator_in *>(it)) = field_ptr[gridtools::access(
-                            i, j, k, halos[0].total_length(), halos[1].total_length(), halos[2].total_length())];
-                        reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                    }
-                }
-            }
+            pack_part(eta, field_ptr, it, 0, 1);
         }
 
         template <typename iterator_in, typename iterator_out>
         void unpack(gridtools::array<int, 3> const &eta, iterator_in *field_ptr, iterator_out *&it) const {
-            // std::cout << "k=" << base_type::halos[2].loop_low_bound_outside(eta[2])
-            //           << " to <= " << base_type::halos[2].loop_high_bound_outside(eta[2]) << ",\n"
-            //           << "j=" << base_type::halos[1].loop_low_bound_outside(eta[1])
-            //           << " to <= " << base_type::halos[1].loop_high_bound_outside(eta[1]) << ",\n"
-            //           << "i=" << base_type::halos[0].loop_low_bound_outside(eta[0])
-            //           << " to <= " << base_type::halos[0].loop_high_bound_outside(eta[0])
-            //           << std::endl;
-            for (int k = halos[2].loop_low_bound_outside(eta[2]); k <= halos[2].loop_high_bound_outside(eta[2]); ++k) {
-                for (int j = halos[1].loop_low_bound_outside(eta[1]); j <= halos[1].loop_high_bound_outside(eta[1]);
-                     ++j) {
-                    for (int i = halos[0].loop_low_bound_outside(eta[0]); i <= halos[0].loop_high_bound_outside(eta[0]);
-                         ++i) {
-                        // std::cout << "      "
-                        //           << i << ", "
-                        //           << j << ", "
-                        //           << k << ", "
-                        //           << base_type::halos[0].total_length() << ", "
-                        //           << base_type::halos[1].total_length() << ", "
-                        //           << base_type::halos[2].total_length() << ", "
-                        //           << *(reinterpret_cast<iterator_in*>(it))
-                        //           << std::endl;
-                        field_ptr[gridtools::access(
-                            i, j, k, halos[0].total_length(), halos[1].total_length(), halos[2].total_length())] =
-                            *(reinterpret_cast<iterator_in *>(it));
-                        reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                    }
-                }
-            }
+            unpack_part(eta, field_ptr, it, 0, 1);
+        }
+
+        template <typename iterator>
+        void pack_all_part(gridtools::array<int, DIMS> const &, iterator &, int, int) const {}
+
+        /**
+           Same as pack_all, but packs only the part `part` out of `num_parts` of the halo of each field.
+        */
+        template <typename iterator, typename FIRST, typename... FIELDS>
+        void pack_all_part(gridtools::array<int, DIMS> const &eta,
+            iterator &it,
+            int part,
+            int num_parts,
+            FIRST const &field,
+            const FIELDS &... args) const {
+            pack_part(eta, field, it, part, num_parts);
+            pack_all_part(eta, it, part, num_parts, args...);
+        }
+
+        template <typename iterator>
+        void unpack_all_part(gridtools::array<int, DIMS> const &, iterator &, int, int) const {}
+
+        /**
+           Same as unpack_all, but unpacks only the part `part` out of `num_parts` of the halo of each field.
+        */
+        template <typename iterator, typename FIRST, typename... FIELDS>
+        void unpack_all_part(gridtools::array<int, DIMS> const &eta,
+            iterator &it,
+            int part,
+            int num_parts,
+            FIRST const &field,
+            const FIELDS &... args) const {
+            unpack_part(eta, field, it, part, num_parts);
+            unpack_all_part(eta, it, part, num_parts, args...);
         }
 
         template <typename iterator>
@@ -548,6 +566,43 @@ namespace gridtools {
         // friend class _impl::unpack_service<this_type>;
 
       private:
+        /**
+           Calls `fun(eta, ii_P, jj_P, kk_P, buffer_index)` for all the neighbors that exist in the process grid.
+        */
+        template <typename T, typename Fun>
+        static void for_each_neighbor(T const &hm, Fun const &fun) {
+            for (int ii = -1; ii <= 1; ++ii) {
+                for (int jj = -1; jj <= 1; ++jj) {
+                    for (int kk = -1; kk <= 1; ++kk) {
+                        typedef proc_layout map_type;
+                        const int ii_P = make_array(ii, jj, kk)[map_type::template at<0>()];
+                        const int jj_P = make_array(ii, jj, kk)[map_type::template at<1>()];
+                        const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
+                        if ((ii != 0 || jj != 0 || kk != 0) &&
+                            (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
+                            fun(make_array(ii, jj, kk), ii_P, jj_P, kk_P, translate()(ii, jj, kk));
+                        }
+                    }
+                }
+            }
+        }
+
+        template <typename T>
+        static void set_message_sizes(T &hm, std::size_t num_fields) {
+            for_each_neighbor(hm, [&](array<int, 3> const &, int ii_P, int jj_P, int kk_P, int index) {
+                hm.m_haloexch.set_send_to_size(hm.send_size[index] * num_fields * sizeof(DataType), ii_P, jj_P, kk_P);
+                hm.m_haloexch.set_receive_from_size(
+                    hm.recv_size[index] * num_fields * sizeof(DataType), ii_P, jj_P, kk_P);
+            });
+        }
+
+        /*
+           The halos of all the neighbors and fields are packed (unpacked) in a single parallel region. Every
+           thread takes its share of the rows of each halo, so that all threads are busy even if only few
+           neighbors exist; the regions written by different threads are disjoint, so no synchronization is needed
+           until the end of the parallel region.
+        */
+
         template <int I, int dummy>
         struct pack_dims {};
 
@@ -555,33 +610,16 @@ namespace gridtools {
         struct pack_dims<3, dummy> {
             template <typename T, typename... FIELDS>
             void operator()(T &hm, const FIELDS &... _fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::template at<0>()];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::template at<1>()];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                hm.halo.pack_all(make_array(ii, jj, kk), it, _fields...);
-
-                                hm.m_haloexch.set_send_to_size(
-                                    hm.send_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                                hm.m_haloexch.set_receive_from_size(
-                                    hm.recv_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                            }
-                        }
-                    }
+#pragma omp parallel
+                {
+                    int part = omp_get_thread_num();
+                    int num_parts = omp_get_num_threads();
+                    for_each_neighbor(hm, [&](array<int, 3> const &eta, int, int, int, int index) {
+                        DataType *it = &(hm.send_buffer[index][0]);
+                        hm.halo.pack_all_part(eta, it, part, num_parts, _fields...);
+                    });
                 }
+                set_message_sizes(hm, sizeof...(_fields));
             }
         };
 
@@ -592,21 +630,14 @@ namespace gridtools {
         struct unpack_dims<3, dummy> {
             template <typename T, typename... FIELDS>
             void operator()(const T &hm, const FIELDS &... _fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::template at<0>()];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::template at<1>()];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                hm.halo.unpack_all(make_array(ii, jj, kk), it, _fields...);
-                            }
-                        }
-                    }
+#pragma omp parallel
+                {
+                    int part = omp_get_thread_num();
+                    int num_parts = omp_get_num_threads();
+                    for_each_neighbor(hm, [&](array<int, 3> const &eta, int, int, int, int index) {
+                        DataType *it = &(hm.recv_buffer[index][0]);
+                        hm.halo.unpack_all_part(eta, it, part, num_parts, _fields...);
+                    });
                 }
             }
         };
@@ -618,35 +649,18 @@ namespace gridtools {
         struct pack_vector_dims<3, dummy> {
             template <typename T>
             void operator()(T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::template at<0>()];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::template at<1>()];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                for (size_t i = 0; i < fields.size(); ++i) {
-                                    hm.halo.pack(make_array(ii, jj, kk), fields[i], it);
-                                }
-
-                                hm.m_haloexch.set_send_to_size(
-                                    hm.send_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                                hm.m_haloexch.set_receive_from_size(
-                                    hm.recv_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                            }
+#pragma omp parallel
+                {
+                    int part = omp_get_thread_num();
+                    int num_parts = omp_get_num_threads();
+                    for_each_neighbor(hm, [&](array<int, 3> const &eta, int, int, int, int index) {
+                        DataType *it = &(hm.send_buffer[index][0]);
+                        for (size_t i = 0; i < fields.size(); ++i) {
+                            hm.halo.pack_part(eta, fields[i], it, part, num_parts);
                         }
-                    }
+                    });
                 }
+                set_message_sizes(hm, fields.size());
             }
         };
 
@@ -657,23 +671,16 @@ namespace gridtools {
         struct unpack_vector_dims<3, dummy> {
             template <typename T>
             void operator()(const T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::template at<0>()];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::template at<1>()];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                for (size_t i = 0; i < fields.size(); ++i) {
-                                    hm.halo.unpack(make_array(ii, jj, kk), fields[i], it);
-                                }
-                            }
+#pragma omp parallel
+                {
+                    int part = omp_get_thread_num();
+                    int num_parts = omp_get_num_threads();
+                    for_each_neighbor(hm, [&](array<int, 3> const &eta, int, int, int, int index) {
+                        DataType *it = &(hm.recv_buffer[index][0]);
+                        for (size_t i = 0; i < fields.size(); ++i) {
+                            hm.halo.unpack_part(eta, fields[i], it, part, num_parts);
                         }
-                    }
+                    });
                 }
             }
         };
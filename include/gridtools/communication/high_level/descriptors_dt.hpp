@@ -0,0 +1,284 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "../../common/array.hpp"
+#include "../../common/make_array.hpp"
+#include "../../common/numerics.hpp"
+#include "../low_level/translate.hpp"
+#include "descriptor_base.hpp"
+#include "descriptors_fwd.hpp"
+#include "empty_field_base.hpp"
+
+namespace gridtools {
+
+    /**
+        Class containing the description of one halo and a communication pattern, as hndlr_dynamic_ut, but the
+        data is sent directly from and received directly into the memory of the data fields using MPI derived
+        datatypes, instead of being packed into (unpacked from) intermediate buffers.
+
+        A subarray datatype for the halo sent to (received from) each neighbor is built at setup(). The fields
+        passed to pack() are combined into a single message for each neighbor with a datatype holding the
+        subarray datatype at the offset of each field. These datatypes are cached and rebuilt only if pack() is
+        called with different fields than the previous time.
+
+        Since no copy is made, the fields passed to pack() must be the ones passed to unpack(), and they must not
+        be modified between start_exchange() and wait(). The receives are posted into the fields passed to the last
+        call to pack(), so pack() must be called before post_receives().
+
+        \tparam DataType Type of the elements of the data fields
+        \tparam GridType Processor grid
+        \tparam HaloExch Communication pattern with halo exchange.
+        \tparam proc_layout Map between the dimensions of the data and the dimensions of the processor grid
+    */
+    template <typename DataType, typename GridType, typename HaloExch, typename proc_layout>
+    class hndlr_datatype_ut : public descriptor_base<HaloExch> {
+
+        static const int DIMS = GridType::ndims;
+        static const int NEIGHBORS = _impl::static_pow3<DIMS>::value;
+
+      public:
+        empty_field_base<DataType> halo;
+
+      private:
+        int m_max_fields_n;
+        std::vector<DataType const *> m_fields;
+        array<MPI_Datatype, NEIGHBORS> m_send_types;
+        array<MPI_Datatype, NEIGHBORS> m_recv_types;
+
+      public:
+        typedef gcl_cpu arch_type;
+        typedef descriptor_base<HaloExch> base_type;
+        typedef typename base_type::pattern_type pattern_type;
+
+        /**
+           Type of the computin grid associated to the pattern
+         */
+        typedef typename pattern_type::grid_type grid_type;
+
+        /**
+           Type of the translation used to map dimensions to buffer addresses
+         */
+        typedef translate_t<DIMS, typename default_layout_map<DIMS>::type> translate;
+
+      private:
+        hndlr_datatype_ut(hndlr_datatype_ut const &) = delete;
+        hndlr_datatype_ut(hndlr_datatype_ut &&) = delete;
+
+      public:
+        /**
+           Constructor
+
+           \param[in] c The object of the class used to specify periodicity in each dimension
+           \param[in] comm MPI communicator (typically MPI_Comm_world)
+        */
+        explicit hndlr_datatype_ut(typename grid_type::period_type const &c, MPI_Comm const &comm)
+            : base_type(c, comm), halo(), m_max_fields_n(0) {
+            for (int i = 0; i < NEIGHBORS; ++i) {
+                m_send_types[i] = MPI_DATATYPE_NULL;
+                m_recv_types[i] = MPI_DATATYPE_NULL;
+                halo.MPDT_INSIDE[i] = std::make_pair(MPI_DATATYPE_NULL, false);
+                halo.MPDT_OUTSIDE[i] = std::make_pair(MPI_DATATYPE_NULL, false);
+            }
+        }
+
+        ~hndlr_datatype_ut() {
+            free_message_types();
+            for (int i = 0; i < NEIGHBORS; ++i) {
+                if (halo.MPDT_INSIDE[i].second)
+                    MPI_Type_free(&halo.MPDT_INSIDE[i].first);
+                if (halo.MPDT_OUTSIDE[i].second)
+                    MPI_Type_free(&halo.MPDT_OUTSIDE[i].first);
+            }
+        }
+
+        /**
+           Function to setup internal data structures for data exchange and preparing eventual underlying layers.
+           The subarray datatypes of the halos are built here, no buffer is allocated.
+
+           \param max_fields_n Maximum number of data fields that will be passed to the communication functions
+        */
+        void setup(int max_fields_n) {
+            m_max_fields_n = max_fields_n;
+            halo.setup();
+        }
+
+#ifdef GCL_TRACE
+        void set_pattern_tag(int tag) { base_type::m_haloexch.set_pattern_tag(tag); };
+#endif
+
+        /**
+           Function to register the data fields to be sent. No data is copied.
+
+           \param[in] _fields data fields to be sent
+        */
+        template <typename... FIELDS>
+        void pack(const FIELDS &... _fields) {
+            pack(std::vector<DataType const *>{_fields...});
+        }
+
+        /**
+           Function to unpack received data. Nothing has to be done since the data is received directly into the
+           fields.
+
+           \param[in] _fields data fields where the data has been received, must be the ones passed to pack
+        */
+        template <typename... FIELDS>
+        void unpack(const FIELDS &... _fields) const {
+            assert(std::vector<DataType const *>({_fields...}) == m_fields);
+        }
+
+        /**
+           Function to register the data fields to be sent. No data is copied.
+
+           \param[in] fields vector with data fields pointers to be sent
+        */
+        template <typename T>
+        void pack(std::vector<T *> const &fields) {
+            assert(fields.size() <= (std::size_t)m_max_fields_n);
+            if (std::equal(fields.begin(), fields.end(), m_fields.begin(), m_fields.end()))
+                return;
+            m_fields.assign(fields.begin(), fields.end());
+            unregister_message_types();
+            free_message_types();
+            if (!m_fields.empty())
+                register_message_types();
+        }
+
+        /**
+           Function to unpack received data. Nothing has to be done since the data is received directly into the
+           fields.
+
+           \param[in] fields vector with data fields pointers where the data has been received, must be the ones
+           passed to pack
+        */
+        void unpack(std::vector<DataType *> const &fields) const {
+            assert(std::equal(fields.begin(), fields.end(), m_fields.begin(), m_fields.end()));
+        }
+
+        /**
+           function to trigger data exchange, the fields must have been passed to pack before.
+        */
+        void exchange() {
+            assert(!m_fields.empty());
+            base_type::exchange();
+        }
+
+        /**
+           function to trigger posting of receives when using split-phase communication, the fields must have been
+           passed to pack before.
+        */
+        void post_receives() {
+            assert(!m_fields.empty());
+            base_type::post_receives();
+        }
+
+        /**
+           function to trigger data exchange initiation when using split-phase communication, the fields must have
+           been passed to pack before.
+        */
+        void start_exchange() {
+            assert(!m_fields.empty());
+            base_type::start_exchange();
+        }
+
+        /**
+           Retrieve the pattern from which the computing grid and other information
+           can be retrieved. The function is available only if the underlying
+           communication library is a Level 3 pattern. It would not make much
+           sense otherwise.
+
+           If used to get process grid information additional information can be
+           found in \link GRIDS_INTERACTION \endlink
+        */
+        pattern_type const &pattern() const { return base_type::pattern(); }
+
+      private:
+        /**
+           Builds a datatype with the subarray datatype `type` at the address of each field, relative to the first
+           field.
+        */
+        MPI_Datatype make_message_type(MPI_Datatype type) const {
+            std::vector<int> lengths(m_fields.size(), 1);
+            std::vector<MPI_Aint> displacements(m_fields.size());
+            MPI_Aint base;
+            MPI_Get_address(m_fields[0], &base);
+            for (std::size_t i = 0; i < m_fields.size(); ++i) {
+                MPI_Get_address(m_fields[i], &displacements[i]);
+                displacements[i] -= base;
+            }
+            MPI_Datatype res;
+            MPI_Type_create_hindexed(m_fields.size(), &lengths[0], &displacements[0], type, &res);
+            MPI_Type_commit(&res);
+            return res;
+        }
+
+        /**
+           Calls `fun(eta, ii_P, jj_P, kk_P, index)` for all the neighbors, with the coordinates of the neighbor in
+           the processor grid and the index of its datatypes.
+        */
+        template <typename Fun>
+        static void for_each_neighbor(Fun const &fun) {
+            for (int ii = -1; ii <= 1; ++ii) {
+                for (int jj = -1; jj <= 1; ++jj) {
+                    for (int kk = -1; kk <= 1; ++kk) {
+                        if (ii == 0 && jj == 0 && kk == 0)
+                            continue;
+                        const int ii_P = make_array(ii, jj, kk)[proc_layout::template at<0>()];
+                        const int jj_P = make_array(ii, jj, kk)[proc_layout::template at<1>()];
+                        const int kk_P = make_array(ii, jj, kk)[proc_layout::template at<2>()];
+                        fun(make_array(ii, jj, kk), ii_P, jj_P, kk_P, translate()(ii, jj, kk));
+                    }
+                }
+            }
+        }
+
+        void register_message_types() {
+            void *base = const_cast<DataType *>(m_fields[0]);
+            for_each_neighbor([&](array<int, 3> const &eta, int ii_P, int jj_P, int kk_P, int index) {
+                auto send = halo.mpdt_inside(eta);
+                auto recv = halo.mpdt_outside(eta);
+                if (send.second) {
+                    m_send_types[index] = make_message_type(send.first);
+                    base_type::m_haloexch.register_send_to_datatype(base, m_send_types[index], 1, ii_P, jj_P, kk_P);
+                }
+                if (recv.second) {
+                    m_recv_types[index] = make_message_type(recv.first);
+                    base_type::m_haloexch.register_receive_from_datatype(
+                        base, m_recv_types[index], 1, ii_P, jj_P, kk_P);
+                }
+            });
+        }
+
+        /**
+           Registers empty messages, so that the pattern does not refer to the datatypes about to be freed. A new
+           datatype may get the handle of a freed one.
+        */
+        void unregister_message_types() {
+            for_each_neighbor([&](array<int, 3> const &, int ii_P, int jj_P, int kk_P, int) {
+                base_type::m_haloexch.register_send_to_datatype(nullptr, MPI_CHAR, 0, ii_P, jj_P, kk_P);
+                base_type::m_haloexch.register_receive_from_datatype(nullptr, MPI_CHAR, 0, ii_P, jj_P, kk_P);
+            });
+        }
+
+        void free_message_types() {
+            for (int i = 0; i < NEIGHBORS; ++i) {
+                if (m_send_types[i] != MPI_DATATYPE_NULL)
+                    MPI_Type_free(&m_send_types[i]);
+                if (m_recv_types[i] != MPI_DATATYPE_NULL)
+                    MPI_Type_free(&m_recv_types[i]);
+            }
+        }
+    };
+} // namespace gridtools
@@ -17,3 +17,12 @@
  * 2 interface of halo exchange
  */
 #define GCL_MAX_FIELDS 24
+
+namespace gridtools {
+    /** Implementations of the halo exchange, to be passed as version to halo_exchange_dynamic_ut.
+        - version_manual: the halos are packed into (unpacked from) buffers that are sent (received) with MPI
+        - version_datatype: the halos are sent (received) directly from (into) the data fields using MPI derived
+          datatypes, only available for gcl_cpu
+     */
+    enum halo_exchange_version { version_manual = 0, version_datatype = 1 };
+} // namespace gridtools
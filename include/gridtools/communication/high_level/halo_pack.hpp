@@ -0,0 +1,83 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "../../common/array.hpp"
+
+namespace gridtools {
+    /**
+       A box of a 3D field to be packed into or unpacked from a contiguous buffer. The bounds are inclusive, the
+       field has unit stride in the first dimension, the buffer stores the box with the first dimension running
+       fastest.
+    */
+    struct halo_region {
+        array<int, 3> low;
+        array<int, 3> high;
+        array<int, 3> total_length;
+
+        int length(int dim) const { return high[dim] >= low[dim] ? high[dim] - low[dim] + 1 : 0; }
+
+        int size() const { return length(0) * length(1) * length(2); }
+    };
+
+    namespace halo_pack_impl_ {
+        /**
+           Calls `fun(buffer_offset, field_offset, length)` for the rows of the first dimension of the region that
+           belong to `part` out of `num_parts` equal parts.
+        */
+        template <typename Fun>
+        void for_each_row(halo_region const &region, int part, int num_parts, Fun const &fun) {
+            int length = region.length(0);
+            int j_length = region.length(1);
+            int rows = j_length * region.length(2);
+            if (length == 0 || rows == 0)
+                return;
+            int first = (long long)rows * part / num_parts;
+            int last = (long long)rows * (part + 1) / num_parts;
+            for (int row = first; row < last; ++row) {
+                int j = region.low[1] + row % j_length;
+                int k = region.low[2] + row / j_length;
+                std::size_t field_offset =
+                    region.low[0] + region.total_length[0] * (j + (std::size_t)region.total_length[1] * k);
+                fun((std::size_t)row * length, field_offset, length);
+            }
+        }
+    } // namespace halo_pack_impl_
+
+    /**
+       Copies the part `part` out of `num_parts` of the region of the field into the buffer. The parts are
+       disjoint, so the threads of a parallel region can share the work. Rows of the first dimension are copied with
+       std::copy_n, which is a memmove for trivially copyable types. Returns the number of elements of the whole region.
+    */
+    template <typename T>
+    int pack_region(halo_region const &region, T const *field, void *buffer, int part = 0, int num_parts = 1) {
+        halo_pack_impl_::for_each_row(
+            region, part, num_parts, [&](std::size_t buffer_offset, std::size_t field_offset, int length) {
+                std::copy_n(field + field_offset, length, static_cast<T *>(buffer) + buffer_offset);
+            });
+        return region.size();
+    }
+
+    /**
+       Copies the part `part` out of `num_parts` of the region from the buffer into the field, the inverse of
+       pack_region.
+    */
+    template <typename T>
+    int unpack_region(halo_region const &region, T *field, void const *buffer, int part = 0, int num_parts = 1) {
+        halo_pack_impl_::for_each_row(
+            region, part, num_parts, [&](std::size_t buffer_offset, std::size_t field_offset, int length) {
+                std::copy_n(static_cast<T const *>(buffer) + buffer_offset, length, field + field_offset);
+            });
+        return region.size();
+    }
+} // namespace gridtools
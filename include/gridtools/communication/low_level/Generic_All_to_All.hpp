@@ -42,15 +42,13 @@ namespace gridtools {
       private:
         MPI_Datatype mpidt;
         value_type *ptr;
-        MPI_Request send_r;
-        MPI_Request recv_r;
 
       public:
         /** Default constructor set pointer to null. This is useful since
             the pointer value is used to determine if a message should be
             sent or not. If not null, a mpi send/receive is issued.
          */
-        packet() : mpidt(), ptr(nullptr), send_r(), recv_r() {}
+        packet() : mpidt(), ptr(nullptr) {}
 
         /** This is the basic constructor. Given the MPI datatype and the
             pointer to data, the packet is constructed. If pointer is
@@ -59,7 +57,7 @@ namespace gridtools {
             \param[in] dt MPI datatype
             \param[in] p Pointer to the data of type value_type
          */
-        packet(MPI_Datatype const &dt, value_type *p) : mpidt(dt), ptr(p), send_r(), recv_r() {}
+        packet(MPI_Datatype const &dt, value_type *p) : mpidt(dt), ptr(p) {}
 
         /** Function to check if the packet is actually associated with
             some data or not. If not the MPI send or recv is not
@@ -90,6 +88,12 @@ namespace gridtools {
         MPI_Datatype element is also part of the information in the
         array elements.
 
+        setup() creates a communicator restricted to the processes this
+        process actually exchanges data with (MPI_Dist_graph_create_adjacent)
+        and persistent requests for all the messages, so that repeated
+        exchanges, e.g., one redistribution per output step, only start and
+        complete requests, independently of the number of processes.
+
         \tparam vtype The type of the elements pointed by the pointer do the data to be sent or received.
      */
     template <typename vtype>
@@ -110,6 +114,26 @@ namespace gridtools {
          */
         std::vector<packet<value_type>> from;
 
+      private:
+        MPI_Comm m_graph_comm;
+        std::vector<int> m_sources;
+        std::vector<MPI_Request> m_recv_requests;
+        std::vector<MPI_Request> m_send_requests;
+        std::vector<int> m_indices;
+
+        void free() {
+            for (auto &request : m_recv_requests)
+                MPI_Request_free(&request);
+            for (auto &request : m_send_requests)
+                MPI_Request_free(&request);
+            m_recv_requests.clear();
+            m_send_requests.clear();
+            m_sources.clear();
+            if (m_graph_comm != MPI_COMM_NULL)
+                MPI_Comm_free(&m_graph_comm);
+        }
+
+      public:
         /** Constructor that takes the number of process (this work with
             MPI_COMM_WORLD, or gridtools::GCL_WORLD communicators). The elements
             of the arrays are then initialized with empty packets (that
@@ -117,7 +141,7 @@ namespace gridtools {
 
             \param[in] nprocs Number of processes in the MPI world
          */
-        all_to_all(int nprocs) : a2a_comm(GCL_WORLD), to(nprocs), from(nprocs) {}
+        all_to_all(int nprocs) : a2a_comm(GCL_WORLD), to(nprocs), from(nprocs), m_graph_comm(MPI_COMM_NULL) {}
 
         /** Constructor that takes the number of process which takes a
             communicator to use during communication. The elements of the
@@ -127,59 +151,75 @@ namespace gridtools {
             \param[in] nprocs Number of processes in the MPI world
             \param[in] a2a_comm the MPI communicator to use
          */
-        all_to_all(int nprocs, MPI_Comm a2a_comm) : a2a_comm(a2a_comm), to(nprocs), from(nprocs) {}
+        all_to_all(int nprocs, MPI_Comm a2a_comm)
+            : a2a_comm(a2a_comm), to(nprocs), from(nprocs), m_graph_comm(MPI_COMM_NULL) {}
+
+        all_to_all(all_to_all const &) = delete;
 
-        /** This method prepare the pattern to be ready to execute
+        ~all_to_all() { free(); }
+
+        /** This method prepare the pattern to be ready to execute. It is
+            collective over a2a_comm and has to be called again whenever a
+            packet in "to" or "from" is changed.
          */
-        void setup() { MPI_Barrier(a2a_comm); }
+        void setup() {
+            free();
+
+            std::vector<int> destinations;
+            for (unsigned int i = 0; i < from.size(); ++i)
+                if (from[i].full())
+                    m_sources.push_back(i);
+            for (unsigned int i = 0; i < to.size(); ++i)
+                if (to[i].full())
+                    destinations.push_back(i);
+
+            // the ranks are not reordered, so they are the same as in a2a_comm
+            MPI_Dist_graph_create_adjacent(a2a_comm,
+                m_sources.size(),
+                m_sources.data(),
+                MPI_UNWEIGHTED,
+                destinations.size(),
+                destinations.data(),
+                MPI_UNWEIGHTED,
+                MPI_INFO_NULL,
+                0,
+                &m_graph_comm);
+
+            int tpid;
+            MPI_Comm_rank(m_graph_comm, &tpid);
+
+            m_recv_requests.resize(m_sources.size());
+            for (unsigned int i = 0; i < m_sources.size(); ++i) {
+                int source = m_sources[i];
+                MPI_Recv_init(
+                    from[source].ptr, 1, from[source].mpidt, source, source, m_graph_comm, &m_recv_requests[i]);
+            }
+            m_send_requests.resize(destinations.size());
+            for (unsigned int i = 0; i < destinations.size(); ++i) {
+                int dest = destinations[i];
+                MPI_Send_init(to[dest].ptr, 1, to[dest].mpidt, dest, tpid, m_graph_comm, &m_send_requests[i]);
+            }
+            m_indices.resize(m_sources.size());
+        }
 
-        /** This method performs Irecevs from Isends to each process whose entry in the array of
+        /** This method starts the receives from each process whose entry in the array of
             "from"s has a non null pointer.
          */
         void post_receives() {
-            int tpid;
-            MPI_Comm_rank(a2a_comm, &tpid);
-
-            for (unsigned int i = 0; i < from.size(); ++i) {
-                if (from[i].full()) {
-#ifndef NDEBUG
-                    int tpid;
-                    MPI_Comm_rank(a2a_comm, &tpid);
-                    std::cout << "@" << tpid << "@ RECV " << i << " " << (void *)(from[i].ptr) << " " << from[i].mpidt
-                              << " "
-                              << "\n";
-                    std::cout.flush();
-#endif
-                    MPI_Irecv(from[i].ptr,
-                        1,
-
-                        from[i].mpidt,
-                        i,
-                        i,
-                        a2a_comm,
-                        &(from[i].recv_r));
-                }
-            }
+            if (m_graph_comm == MPI_COMM_NULL)
+                setup();
+            if (!m_recv_requests.empty())
+                MPI_Startall(m_recv_requests.size(), m_recv_requests.data());
         }
 
-        /** This method performs Isends to each process whose entry in the array of
+        /** This method starts the sends to each process whose entry in the array of
             "to"s has a non null pointer.
          */
         void do_sends() {
-            int tpid;
-            MPI_Comm_rank(a2a_comm, &tpid);
-
-            for (unsigned int i = 0; i < to.size(); ++i) {
-                if (to[i].full()) {
-#ifndef NDEBUG
-                    std::cout << "@" << tpid << "@ SEND " << i << " " << (void *)(to[i].ptr) << " " << to[i].mpidt
-                              << " "
-                              << "\n";
-                    std::cout.flush();
-#endif
-                    MPI_Isend(to[i].ptr, 1, to[i].mpidt, i, tpid, a2a_comm, &(to[i].send_r));
-                }
-            }
+            if (m_graph_comm == MPI_COMM_NULL)
+                setup();
+            if (!m_send_requests.empty())
+                MPI_Startall(m_send_requests.size(), m_send_requests.data());
         }
 
         /** This method starts the data exchange by posting receives and
@@ -193,20 +233,29 @@ namespace gridtools {
 
         /** This function is called after the start_exchange() function to
             wait for the data that is supposed to arrive to each process.
+            `on_arrival(i)` is called as soon as the data from process i has
+            arrived, in the order of arrival, so that it can be processed
+            while the other messages are still in flight.
          */
-        void wait() {
-            MPI_Status status;
-            for (unsigned int i = 0; i < from.size(); ++i) {
-                if (from[i].full()) {
-#ifndef NDEBUG
-                    int tpid;
-                    MPI_Comm_rank(a2a_comm, &tpid);
-
-                    std::cout << "@" << tpid << "@ WAIT " << i << "\n";
-#endif
-                    MPI_Wait(&(from[i].recv_r), &status);
-                }
+        template <typename F>
+        void wait(F &&on_arrival) {
+            int count;
+            while (true) {
+                MPI_Waitsome(
+                    m_recv_requests.size(), m_recv_requests.data(), &count, m_indices.data(), MPI_STATUSES_IGNORE);
+                if (count == MPI_UNDEFINED)
+                    break;
+                for (int i = 0; i < count; ++i)
+                    on_arrival(m_sources[m_indices[i]]);
             }
+            MPI_Waitall(m_send_requests.size(), m_send_requests.data(), MPI_STATUSES_IGNORE);
+        }
+
+        /** This function is called after the start_exchange() function to
+            wait for the data that is supposed to arrive to each process.
+         */
+        void wait() {
+            wait([](int) {});
         }
     };
 } // namespace gridtools
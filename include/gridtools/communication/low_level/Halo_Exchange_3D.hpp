@@ -12,6 +12,7 @@
 #ifdef GT_VERBOSE
 #include <iostream>
 #endif
+#include <vector>
 
 #include "../../common/defs.hpp"
 #include "../../common/gt_assert.hpp"
@@ -154,7 +155,9 @@ namespace gridtools {
 
         class sr_buffers {
             char *m_buffers[27]; // there is ona buffer more to allow for a simple indexing
-            int m_size[27];      // Sizes in bytes
+            int m_size[27];      // Sizes in number of elements of m_types (bytes by default)
+            MPI_Datatype m_types[27];
+
           public:
             explicit sr_buffers() {
                 m_buffers[0] = nullptr;
@@ -212,11 +215,15 @@ namespace gridtools {
                 m_size[24] = 0;
                 m_size[25] = 0;
                 m_size[26] = 0;
+
+                for (int i = 0; i < 27; ++i)
+                    m_types[i] = MPI_CHAR;
             }
 
             char *&buffer(int I, int J, int K) { return m_buffers[translate()(I, J, K)]; }
             int &size(int I, int J, int K) { return m_size[translate()(I, J, K)]; }
             int size(int I, int J, int K) const { return m_size[translate()(I, J, K)]; }
+            MPI_Datatype &type(int I, int J, int K) { return m_types[translate()(I, J, K)]; }
         };
 
         template <int I, int J, int K>
@@ -246,11 +253,91 @@ namespace gridtools {
         sr_buffers m_send_buffers;
         sr_buffers m_recv_buffers;
 
+        /**
+           Persistent requests for the messages to (from) all the neighbors, see use_persistent_requests. They are
+           created when the exchange is started and kept until a buffer or a size is changed.
+        */
+        struct persistent_requests {
+            std::vector<MPI_Request> m_requests;
+            bool m_valid = false;
+
+            void free() {
+                for (auto &request : m_requests)
+                    MPI_Request_free(&request);
+                m_requests.clear();
+                m_valid = false;
+            }
+        };
+
         request_t request;
         request_t_mark send_request;
 
+        bool m_persistent;
+        persistent_requests m_persistent_sends;
+        persistent_requests m_persistent_recvs;
+
         const PROC_GRID /*&*/ m_proc_grid;
 
+        static int tag(int I, int J, int K) { return (K + 1) * 9 + (I + 1) * 3 + J + 1; }
+
+        /**
+           Sets the message to (from) a neighbor, the persistent requests are invalidated only if it changes.
+        */
+        static void register_message(sr_buffers &buffers,
+            persistent_requests &persistent,
+            void *p,
+            MPI_Datatype type,
+            int count,
+            int I,
+            int J,
+            int K) {
+            if (buffers.buffer(I, J, K) != p || buffers.type(I, J, K) != type || buffers.size(I, J, K) != count)
+                persistent.m_valid = false;
+            buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
+            buffers.size(I, J, K) = count;
+            buffers.type(I, J, K) = type;
+        }
+
+        void init_persistent_receives() {
+            m_persistent_recvs.free();
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k)
+                        if ((i != 0 || j != 0 || k != 0) && m_proc_grid.proc(i, j, k) != -1 &&
+                            m_recv_buffers.size(i, j, k)) {
+                            MPI_Request req;
+                            MPI_Recv_init(m_recv_buffers.buffer(i, j, k),
+                                m_recv_buffers.size(i, j, k),
+                                m_recv_buffers.type(i, j, k),
+                                m_proc_grid.proc(i, j, k),
+                                tag(-i, -j, -k),
+                                get_communicator(m_proc_grid),
+                                &req);
+                            m_persistent_recvs.m_requests.push_back(req);
+                        }
+            m_persistent_recvs.m_valid = true;
+        }
+
+        void init_persistent_sends() {
+            m_persistent_sends.free();
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k)
+                        if ((i != 0 || j != 0 || k != 0) && m_proc_grid.proc(i, j, k) != -1 &&
+                            m_send_buffers.size(i, j, k)) {
+                            MPI_Request req;
+                            MPI_Send_init(m_send_buffers.buffer(i, j, k),
+                                m_send_buffers.size(i, j, k),
+                                m_send_buffers.type(i, j, k),
+                                m_proc_grid.proc(i, j, k),
+                                tag(i, j, k),
+                                get_communicator(m_proc_grid),
+                                &req);
+                            m_persistent_sends.m_requests.push_back(req);
+                        }
+            m_persistent_sends.m_valid = true;
+        }
+
         template <int I, int J, int K>
         void post_receive() {
             if (m_recv_buffers.size(I, J, K)) {
@@ -268,7 +355,7 @@ namespace gridtools {
 
                 MPI_Irecv(static_cast<char *>(m_recv_buffers.buffer(I, J, K)),
                     m_recv_buffers.size(I, J, K),
-                    MPI_CHAR,
+                    m_recv_buffers.type(I, J, K),
                     m_proc_grid.template proc<I, J, K>(),
                     TAG<-I, -J, -K>::value,
                     get_communicator(m_proc_grid),
@@ -303,7 +390,7 @@ namespace gridtools {
 
                 MPI_Isend(static_cast<char *>(m_send_buffers.buffer(I, J, K)),
                     m_send_buffers.size(I, J, K),
-                    MPI_CHAR,
+                    m_send_buffers.type(I, J, K),
                     m_proc_grid.template proc<I, J, K>(),
                     TAG<I, J, K>::value,
                     get_communicator(m_proc_grid),
@@ -398,7 +485,7 @@ namespace gridtools {
          *
          */
         explicit Halo_Exchange_3D(PROC_GRID /*const&*/ _pg)
-            : m_send_buffers(), m_recv_buffers(), request(), send_request(), m_proc_grid(_pg)
+            : m_send_buffers(), m_recv_buffers(), request(), send_request(), m_persistent(false), m_proc_grid(_pg)
 #ifdef GCL_TRACE
               ,
               pattern_tag(-1)
@@ -406,6 +493,29 @@ namespace gridtools {
         {
         }
 
+        Halo_Exchange_3D(Halo_Exchange_3D const &) = delete;
+
+        ~Halo_Exchange_3D() {
+            m_persistent_sends.free();
+            m_persistent_recvs.free();
+        }
+
+        /** Function to enable (or disable) the use of persistent communication requests. When enabled, the
+            messages are started with MPI_Startall on requests created once with MPI_Send_init and MPI_Recv_init,
+            instead of calling MPI_Isend and MPI_Irecv at every exchange. This reduces the overhead of repeated
+            exchanges of the same pattern. The requests are recreated only when a buffer is registered again or a
+            size is changed.
+
+           \param[in] value True to use persistent requests
+        */
+        void use_persistent_requests(bool value = true) {
+            m_persistent = value;
+            if (!value) {
+                m_persistent_sends.free();
+                m_persistent_recvs.free();
+            }
+        }
+
         /** Function to retrieve the grid from the pattern, from which user can query
             location information.
 
@@ -444,8 +554,7 @@ namespace gridtools {
 //                 << " (" << translate()(I,J,K) << ")\n";
 #endif
 
-            m_send_buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
-            m_send_buffers.size(I, J, K) = s;
+            register_message(m_send_buffers, m_persistent_sends, p, MPI_CHAR, s, I, J, K);
         }
 
         /** Function to register send buffers with the communication patter.
@@ -507,8 +616,7 @@ namespace gridtools {
 //                 <<  " (" << translate()(I,J,K) << ")\n";
 #endif
 
-            m_recv_buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
-            m_recv_buffers.size(I, J, K) = s;
+            register_message(m_recv_buffers, m_persistent_recvs, p, MPI_CHAR, s, I, J, K);
         }
 
         /** Function to register buffers for received data with the communication patter.
@@ -539,6 +647,43 @@ namespace gridtools {
             register_receive_from_buffer(p, s, I, J, K);
         }
 
+        /** Function to register the data to be sent to a neighbor as an MPI datatype instead of a buffer of bytes.
+            This allows to send directly from the memory of the fields, without packing them into a buffer. The
+            datatype is not copied, it must be valid until it is replaced by another registration.
+
+           \param[in] p Address the datatype is relative to
+           \param[in] type Datatype describing the data to be sent
+           \param[in] count Number of elements of the datatype to be sent
+           \param[in] I Relative coordinates of the receiving process along the first dimension
+           \param[in] J Relative coordinates of the receiving process along the second dimension
+           \param[in] K Relative coordinates of the receiving process along the third dimension
+        */
+        void register_send_to_datatype(void *p, MPI_Datatype type, int count, int I, int J, int K) {
+            assert((I >= -1 && I <= 1));
+            assert((J >= -1 && J <= 1));
+            assert((K >= -1 && K <= 1));
+
+            register_message(m_send_buffers, m_persistent_sends, p, type, count, I, J, K);
+        }
+
+        /** Function to register the data to be received from a neighbor as an MPI datatype instead of a buffer of
+            bytes, see register_send_to_datatype.
+
+           \param[in] p Address the datatype is relative to
+           \param[in] type Datatype describing where the received data has to be put
+           \param[in] count Number of elements of the datatype to be received
+           \param[in] I Relative coordinates of the sending process along the first dimension
+           \param[in] J Relative coordinates of the sending process along the second dimension
+           \param[in] K Relative coordinates of the sending process along the third dimension
+        */
+        void register_receive_from_datatype(void *p, MPI_Datatype type, int count, int I, int J, int K) {
+            assert((I >= -1 && I <= 1));
+            assert((J >= -1 && J <= 1));
+            assert((K >= -1 && K <= 1));
+
+            register_message(m_recv_buffers, m_persistent_recvs, p, type, count, I, J, K);
+        }
+
         /* Setting sizes */
 
         /** Function to set send buffers sizes if the size must be updated
@@ -561,6 +706,8 @@ namespace gridtools {
             assert((J >= -1 && J <= 1));
             assert((K >= -1 && K <= 1));
 
+            if (m_send_buffers.size(I, J, K) != s)
+                m_persistent_sends.m_valid = false;
             m_send_buffers.size(I, J, K) = s;
         }
 
@@ -611,6 +758,8 @@ namespace gridtools {
             assert((J >= -1 && J <= 1));
             assert((K >= -1 && K <= 1));
 
+            if (m_recv_buffers.size(I, J, K) != s)
+                m_persistent_recvs.m_valid = false;
             m_recv_buffers.size(I, J, K) = s;
         }
 
@@ -668,6 +817,13 @@ namespace gridtools {
         }
 
         void post_receives() {
+            if (m_persistent) {
+                if (!m_persistent_recvs.m_valid)
+                    init_persistent_receives();
+                MPI_Startall(m_persistent_recvs.m_requests.size(), m_persistent_recvs.m_requests.data());
+                return;
+            }
+
             /* Posting receives face -1
              */
             if (m_proc_grid.template proc<1, 0, -1>() != -1) {
@@ -786,6 +942,13 @@ namespace gridtools {
         }
 
         void do_sends() {
+            if (m_persistent) {
+                if (!m_persistent_sends.m_valid)
+                    init_persistent_sends();
+                MPI_Startall(m_persistent_sends.m_requests.size(), m_persistent_sends.m_requests.data());
+                return;
+            }
+
             /* Sending data face -1
              */
             if (m_proc_grid.template proc<-1, 0, -1>() != -1) {
@@ -934,6 +1097,13 @@ namespace gridtools {
         }
 
         void wait() {
+            if (m_persistent) {
+                MPI_Waitall(
+                    m_persistent_sends.m_requests.size(), m_persistent_sends.m_requests.data(), MPI_STATUSES_IGNORE);
+                MPI_Waitall(
+                    m_persistent_recvs.m_requests.size(), m_persistent_recvs.m_requests.data(), MPI_STATUSES_IGNORE);
+                return;
+            }
 
             wait_for_sends();
 
@@ -13,6 +13,9 @@
 /** \defgroup Distributed-Boundaries Distributed Boundary Conditions
  */
 
+#include <functional>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
 #include "../boundary_conditions/predicate.hpp"
@@ -92,6 +95,7 @@ namespace gridtools {
         array<int_t, 3> m_sizes;
         uint_t m_max_stores;
         pattern_type m_he;
+        std::function<void(distributed_boundaries &)> m_pending_finish;
 
         performance_meter_t m_meter_pack;
         performance_meter_t m_meter_exchange;
@@ -129,6 +133,19 @@ namespace gridtools {
             m_he.setup(m_max_stores);
         }
 
+        // a pending split-phase exchange refers to the communication buffers of this object
+        distributed_boundaries(distributed_boundaries const &) = delete;
+        distributed_boundaries &operator=(distributed_boundaries const &) = delete;
+
+        /**
+            @brief Waits for the messages of a pending split-phase exchange, if any. The received data is discarded:
+            the data stores are not updated and the boundary conditions are not applied.
+        */
+        ~distributed_boundaries() {
+            if (m_pending_finish)
+                m_he.wait();
+        }
+
         /**
             @brief Member function to perform boundary condition only
             on a list of jobs.  A job is either a
@@ -163,11 +180,7 @@ namespace gridtools {
         template <typename... Jobs>
         void exchange(Jobs const &... jobs) {
             auto all_stores_for_exc = std::tuple_cat(collect_stores(jobs)...);
-            if (m_max_stores < sizeof...(jobs)) {
-                std::string err{"Too many data stores to be exchanged" + std::to_string(sizeof...(jobs)) +
-                                " instead of the maximum allowed, which is " + std::to_string(m_max_stores)};
-                throw std::runtime_error(err);
-            }
+            check_max_stores(sizeof...(jobs));
 
             m_meter_pack.start();
             call_pack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
@@ -182,6 +195,105 @@ namespace gridtools {
             boundary_only(jobs...);
         }
 
+        /**
+            @brief First phase of a split-phase distributed_boundaries::exchange: packs the data stores and starts the
+            communication, without waiting for it to complete.
+
+            The data stores must not be modified until distributed_boundaries::finish_exchange returns. Only
+            one split-phase exchange can be pending at a time. If the object is destroyed while an exchange is pending,
+            the destructor waits for the messages and discards them.
+
+            \param jobs Variadic list of jobs, as for distributed_boundaries::exchange
+        */
+        template <typename... Jobs>
+        void start_exchange(Jobs const &... jobs) {
+            if (m_pending_finish)
+                throw std::runtime_error("start_exchange called while another exchange is pending");
+            auto all_stores_for_exc = std::tuple_cat(collect_stores(jobs)...);
+            check_max_stores(sizeof...(jobs));
+
+            m_meter_pack.start();
+            call_pack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
+            m_he.start_exchange();
+            m_meter_pack.pause();
+
+            // the stores of bound_bc jobs are returned by reference, so they are collected again from the copies
+            m_pending_finish = [jobs...](distributed_boundaries &self) {
+                auto all_stores_for_exc = std::tuple_cat(self.collect_stores(jobs)...);
+                self.m_meter_pack.start();
+                self.call_unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
+                self.m_meter_pack.pause();
+
+                self.boundary_only(jobs...);
+            };
+        }
+
+        /**
+            @brief Second phase of a split-phase distributed_boundaries::exchange: waits for the communication
+            started by distributed_boundaries::start_exchange, unpacks the data stores and applies the boundary
+            conditions.
+
+            In the split-phase mode the exchange meter measures only the time spent waiting for the messages, i.e.
+            the part of the communication that is not hidden behind computation.
+        */
+        void finish_exchange() {
+            if (!m_pending_finish)
+                throw std::runtime_error("finish_exchange called without a pending exchange");
+            m_meter_exchange.start();
+            m_he.wait();
+            m_meter_exchange.pause();
+
+            auto finish = std::move(m_pending_finish);
+            m_pending_finish = nullptr;
+            finish(*this);
+        }
+
+        /**
+            @brief Performs the exchange of the jobs overlapped with a computation that reads the exchanged data
+            stores.
+
+            `compute(grid)` is called first for the interior of `grid`, i.e. the compute domain shrunk by the
+            horizontal halo widths, while the messages are in flight. After the exchange has finished (including the
+            boundary conditions), it is called for the rim of `grid`, split into at most four non-overlapping parts.
+            `compute` typically builds and runs a computation for the grid it is given.
+
+            The horizontal extents of the computation must not exceed the halo widths and the computation must not
+            write to the exchanged data stores.
+
+            \param grid The compute domain, a gridtools::grid
+            \param compute Callable taking a gridtools::grid
+            \param jobs Variadic list of jobs, as for distributed_boundaries::exchange
+        */
+        template <typename Grid, typename Compute, typename... Jobs>
+        void exchange_overlapped(Grid const &grid, Compute &&compute, Jobs const &... jobs) {
+            int_t i_minus = m_halos[0].minus();
+            int_t i_plus = m_halos[0].plus();
+            int_t j_minus = m_halos[1].minus();
+            int_t j_plus = m_halos[1].plus();
+            int_t i_size = grid.i_size();
+            int_t j_size = grid.j_size();
+            int_t interior_i_size = i_size - i_minus - i_plus;
+            int_t interior_j_size = j_size - j_minus - j_plus;
+
+            start_exchange(jobs...);
+            if (interior_i_size <= 0 || interior_j_size <= 0) {
+                finish_exchange();
+                compute(grid);
+                return;
+            }
+            compute(grid.sub_grid(i_minus, interior_i_size, j_minus, interior_j_size));
+            finish_exchange();
+
+            auto compute_rim = [&](int_t i_offset, int_t i_size, int_t j_offset, int_t j_size) {
+                if (i_size > 0 && j_size > 0)
+                    compute(grid.sub_grid(i_offset, i_size, j_offset, j_size));
+            };
+            compute_rim(0, i_minus, 0, j_size);
+            compute_rim(i_size - i_plus, i_plus, 0, j_size);
+            compute_rim(i_minus, interior_i_size, 0, j_minus);
+            compute_rim(i_minus, interior_i_size, j_size - j_plus, j_plus);
+        }
+
         typename pattern_type::grid_type const &proc_grid() const { return m_he.comm(); }
 
         std::string print_meters() const {
@@ -203,6 +315,14 @@ namespace gridtools {
         }
 
       private:
+        void check_max_stores(uint_t num_stores) const {
+            if (m_max_stores < num_stores) {
+                std::string err{"Too many data stores to be exchanged" + std::to_string(num_stores) +
+                                " instead of the maximum allowed, which is " + std::to_string(m_max_stores)};
+                throw std::runtime_error(err);
+            }
+        }
+
         template <typename BoundaryApply, typename ArgsTuple, uint_t... Ids>
         static void call_apply(
             BoundaryApply boundary_apply, ArgsTuple const &args, std::integer_sequence<uint_t, Ids...>) {
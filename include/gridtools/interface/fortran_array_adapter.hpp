@@ -9,6 +9,13 @@
  */
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "../common/array.hpp"
+#include "../common/cuda_is_ptr.hpp"
+#include "../storage/common/definitions.hpp"
 #include "../storage/common/storage_info_rt.hpp"
 #include "./layout_transformation/layout_transformation.hpp"
 #include <cpp_bindgen/fortran_array_view.hpp>
@@ -34,6 +41,57 @@ namespace gridtools {
         using bindgen_view_element_type = typename DataStore::data_t;
         using bindgen_is_acc_present = bool_constant<true>;
 
+        /**
+         * @brief true if a DataStore can use the memory of the Fortran array directly.
+         *
+         * This is the case if the unmasked dimensions of the Layout are ordered as in Fortran, i.e., the first one is
+         * the contiguous one, and if the array fulfills the alignment of the StorageInfo: the length of the
+         * contiguous dimension is a multiple of the alignment and the first element of the inner region is aligned.
+         */
+        bool is_wrappable() const {
+            int previous = Layout::max() + 1;
+            for (uint_t i = 0; i < Layout::masked_length; ++i) {
+                if (Layout::at(i) >= 0) {
+                    if (Layout::at(i) >= previous)
+                        return false;
+                    previous = Layout::at(i);
+                }
+            }
+            constexpr uint_t alignment = StorageInfo::alignment_t::value;
+            if (alignment <= 1)
+                return true;
+            if (m_descriptor.dims[0] % alignment != 0)
+                return false;
+            auto first = static_cast<typename DataStore::data_t *>(m_descriptor.data) +
+                         make_wrapping_storage_info().first_index_of_inner_region();
+            return reinterpret_cast<std::uintptr_t>(first) % (alignment * sizeof(typename DataStore::data_t)) == 0;
+        }
+
+        /**
+         * @brief returns a DataStore holding the content of the Fortran array.
+         *
+         * If the array is wrappable (see is_wrappable()), the DataStore does not own its memory but uses the one of
+         * the Fortran array, with a storage info built from the strides of the array. No data is copied, the array
+         * must outlive the DataStore. Otherwise, a DataStore of the dimensions of the array is allocated and the
+         * array is copied into it, and the result must be copied back with transform(adapter, data_store) if it is
+         * modified. The latter is a no-op for a wrapping DataStore, so the calling code does not need to distinguish
+         * the two cases.
+         */
+        DataStore make_data_store(std::string const &name = "") const {
+            if (!m_descriptor.data)
+                throw std::runtime_error("No array to assigned to fortran_array_adapter");
+            if (is_wrappable()) {
+                auto ptr = static_cast<typename DataStore::data_t *>(m_descriptor.data);
+                return DataStore(make_wrapping_storage_info(),
+                    ptr,
+                    is_gpu_ptr(ptr) ? ownership::external_gpu : ownership::external_cpu,
+                    name);
+            }
+            DataStore res(make_storage_info(std::make_integer_sequence<uint_t, Layout::masked_length>()), name);
+            transform(res, *this);
+            return res;
+        }
+
         friend void transform(DataStore &dest, const fortran_array_adapter &src) {
             adapter{const_cast<fortran_array_adapter &>(src), dest}.from_array();
         }
@@ -42,6 +100,33 @@ namespace gridtools {
         }
 
       private:
+        // the lengths of the dimensions of the array, 1 for the masked dimensions
+        array<uint_t, Layout::masked_length> lengths() const {
+            array<uint_t, Layout::masked_length> res;
+            for (uint_t c_dim = 0, fortran_dim = 0; c_dim < Layout::masked_length; ++c_dim)
+                res[c_dim] = Layout::at(c_dim) >= 0 ? m_descriptor.dims[fortran_dim++] : 1;
+            return res;
+        }
+
+        template <uint_t... Dims>
+        StorageInfo make_storage_info(std::integer_sequence<uint_t, Dims...>) const {
+            auto dims = lengths();
+            return StorageInfo(dims[Dims]...);
+        }
+
+        // a storage info with the strides of the Fortran array, 0 for the masked dimensions
+        StorageInfo make_wrapping_storage_info() const {
+            auto dims = lengths();
+            array<uint_t, Layout::masked_length> strides;
+            uint_t current_stride = 1;
+            for (uint_t i = 0; i < Layout::masked_length; ++i) {
+                strides[i] = Layout::at(i) >= 0 ? current_stride : 0;
+                if (Layout::at(i) >= 0)
+                    current_stride *= dims[i];
+            }
+            return StorageInfo(dims, strides);
+        }
+
         class adapter {
             using ElementType = typename DataStore::data_t;
 
@@ -88,10 +173,15 @@ namespace gridtools {
                 }
             }
 
+            // nothing to be copied if the data_store uses the memory of the array
             void from_array() const {
+                if (m_cpp_pointer == m_fortran_pointer)
+                    return;
                 interface::transform(m_cpp_pointer, m_fortran_pointer, m_dims, m_cpp_strides, m_fortran_strides);
             }
             void to_array() const {
+                if (m_cpp_pointer == m_fortran_pointer)
+                    return;
                 interface::transform(m_fortran_pointer, m_cpp_pointer, m_dims, m_fortran_strides, m_cpp_strides);
             }
 
@@ -10,56 +10,229 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+#include "../../common/array.hpp"
 #include "../../common/defs.hpp"
-#include "../../common/hypercube_iterator.hpp"
-#include "../../common/layout_map_metafunctions.hpp"
-#include "../../common/make_array.hpp"
-#include "../../common/tuple_util.hpp"
 #include "../../storage/storage_facility.hpp"
 #include "layout_transformation_config.hpp"
 #include "layout_transformation_helper.hpp"
 
 namespace gridtools {
     namespace impl {
+        namespace transform_openmp_impl_ {
+            // side of the tiles of the two dimensions which are transposed, a tile of each of the source and the
+            // destination fits into the L1 cache
+            constexpr std::size_t block_size = 32;
+
+            // number of elements copied at once along the contiguous dimension if no transposition is needed, large
+            // enough to reach the bandwidth of memcpy, small enough to share a single large dimension among threads
+            constexpr std::size_t chunk_size = 1 << 15;
+
+            /**
+             * @brief The dimensions of the transformation, without the ones of size 1, in increasing order of the
+             * destination strides, and with the neighboring dimensions merged if they are contiguous in both the
+             * source and the destination.
+             */
+            struct loop_nest {
+                int n = 0;
+                array<std::size_t, GT_TRANSFORM_MAX_DIM> dims;
+                array<std::size_t, GT_TRANSFORM_MAX_DIM> dst_strides;
+                array<std::size_t, GT_TRANSFORM_MAX_DIM> src_strides;
+
+                loop_nest(array<uint_t, GT_TRANSFORM_MAX_DIM> const &a_dims,
+                    array<uint_t, GT_TRANSFORM_MAX_DIM> const &a_dst_strides,
+                    array<uint_t, GT_TRANSFORM_MAX_DIM> const &a_src_strides) {
+                    for (int d = 0; d < GT_TRANSFORM_MAX_DIM; ++d) {
+                        if (a_dims[d] == 1)
+                            continue;
+                        // insertion sort by the destination strides
+                        int pos = n++;
+                        for (; pos > 0 && dst_strides[pos - 1] > a_dst_strides[d]; --pos) {
+                            dims[pos] = dims[pos - 1];
+                            dst_strides[pos] = dst_strides[pos - 1];
+                            src_strides[pos] = src_strides[pos - 1];
+                        }
+                        dims[pos] = a_dims[d];
+                        dst_strides[pos] = a_dst_strides[d];
+                        src_strides[pos] = a_src_strides[d];
+                    }
+                    int merged = 0;
+                    for (int d = 1; d < n; ++d) {
+                        if (dst_strides[d] == dst_strides[merged] * dims[merged] &&
+                            src_strides[d] == src_strides[merged] * dims[merged]) {
+                            dims[merged] *= dims[d];
+                        } else {
+                            ++merged;
+                            dims[merged] = dims[d];
+                            dst_strides[merged] = dst_strides[d];
+                            src_strides[merged] = src_strides[d];
+                        }
+                    }
+                    if (n > 0)
+                        n = merged + 1;
+                }
+
+                std::size_t size() const {
+                    std::size_t res = 1;
+                    for (int d = 0; d < n; ++d)
+                        res *= dims[d];
+                    return res;
+                }
+
+                /**
+                 * @brief the dimension with the smallest source stride, the one along which the source is read
+                 * contiguously.
+                 */
+                int src_contiguous_dim() const {
+                    int res = 0;
+                    for (int d = 1; d < n; ++d)
+                        if (src_strides[d] < src_strides[res])
+                            res = d;
+                    return res;
+                }
+            };
+
+            template <typename DataType>
+            void copy_chunk(DataType *dst,
+                DataType const *src,
+                std::size_t length,
+                std::size_t dst_stride,
+                std::size_t src_stride,
+                std::true_type) {
+                if (dst_stride == 1 && src_stride == 1) {
+                    std::memcpy(dst, src, length * sizeof(DataType));
+                    return;
+                }
+                for (std::size_t i = 0; i < length; ++i)
+                    dst[i * dst_stride] = src[i * src_stride];
+            }
+
+            template <typename DataType>
+            void copy_chunk(DataType *dst,
+                DataType const *src,
+                std::size_t length,
+                std::size_t dst_stride,
+                std::size_t src_stride,
+                std::false_type) {
+                for (std::size_t i = 0; i < length; ++i)
+                    dst[i * dst_stride] = src[i * src_stride];
+            }
+
+            /**
+             * @brief copies a tile of the dimensions 0 and b, the destination is written contiguously along the
+             * inner loop while the source lines along b stay in cache.
+             */
+            template <typename DataType>
+            void transpose_tile(DataType *__restrict__ dst,
+                DataType const *__restrict__ src,
+                std::size_t length_0,
+                std::size_t length_b,
+                std::size_t dst_stride_0,
+                std::size_t dst_stride_b,
+                std::size_t src_stride_0,
+                std::size_t src_stride_b) {
+                if (dst_stride_0 == 1 && src_stride_b == 1) {
+                    for (std::size_t b = 0; b < length_b; ++b)
+#pragma omp simd
+                        for (std::size_t i = 0; i < length_0; ++i)
+                            dst[i + b * dst_stride_b] = src[i * src_stride_0 + b];
+                    return;
+                }
+                for (std::size_t b = 0; b < length_b; ++b)
+                    for (std::size_t i = 0; i < length_0; ++i)
+                        dst[i * dst_stride_0 + b * dst_stride_b] = src[i * src_stride_0 + b * src_stride_b];
+            }
+        } // namespace transform_openmp_impl_
+
+        /**
+         * @brief copies the elements of src into dst, laid out with the given strides.
+         *
+         * The dimensions are reordered by increasing destination stride and the ones which are contiguous in both
+         * the source and the destination are merged. If the dimension with unit stride in the destination has unit
+         * stride in the source too, chunks of it are copied with memcpy. Otherwise the tiles of that dimension and of
+         * the dimension along which the source is contiguous are transposed. The tiles (or chunks) of all the other
+         * dimensions form a single iteration space which is shared among the threads.
+         */
         template <typename DataType>
         void transform_openmp_loop(DataType *dst,
             DataType *src,
             const std::vector<uint_t> &dims,
             const std::vector<uint_t> &dst_strides,
             const std::vector<uint_t> &src_strides) {
+            using namespace transform_openmp_impl_;
 
             if (dims.size() > GT_TRANSFORM_MAX_DIM)
                 throw std::runtime_error("Reached compile time GT_TRANSFORM_MAX_DIM in layout transformation. Increase "
                                          "the value for higher dimensional transformations.");
 
-            using dummy_layout_map =
-                default_layout_map_t<GT_TRANSFORM_MAX_DIM>; // not used since we pass strides directly
-
-            using storage_info = gridtools::storage_info<0, dummy_layout_map>;
-            auto a_dims = impl::vector_to_dims_array<GT_TRANSFORM_MAX_DIM>(dims);
-            auto a_dst_strides = impl::vector_to_strides_array<GT_TRANSFORM_MAX_DIM>(dst_strides);
-            auto a_src_strides = impl::vector_to_strides_array<GT_TRANSFORM_MAX_DIM>(src_strides);
-
-            storage_info si_dst(a_dims, a_dst_strides);
-            storage_info si_src(a_dims, a_src_strides);
-
-            array<size_t, GT_TRANSFORM_MAX_DIM - 3> outer_dims;
-            for (size_t i = 0; i < GT_TRANSFORM_MAX_DIM - 3; ++i)
-                outer_dims[i] = a_dims[3 + i];
-
-            for (auto &&outer : make_hypercube_view(outer_dims)) {
-                uint_t size_i = a_dims[0]; // because ICC 17 complains otherwise...
-                uint_t size_j = a_dims[1];
-                uint_t size_k = a_dims[2];
-#pragma omp parallel for collapse(3)
-                for (int i = 0; i < (int)size_i; ++i)
-                    for (int j = 0; j < (int)size_j; ++j)
-                        for (int k = 0; k < (int)size_k; ++k) {
-                            auto index = tuple_util::push_front(tuple_util::convert_to<array, int>(outer), i, j, k);
-                            dst[si_dst.index(index)] = src[si_src.index(index)];
-                        }
+            loop_nest nest(impl::vector_to_dims_array<GT_TRANSFORM_MAX_DIM>(dims),
+                impl::vector_to_strides_array<GT_TRANSFORM_MAX_DIM>(dst_strides),
+                impl::vector_to_strides_array<GT_TRANSFORM_MAX_DIM>(src_strides));
+
+            if (nest.size() == 0)
+                return;
+            if (nest.n == 0) {
+                *dst = *src;
+                return;
+            }
+
+            // the dimension to be transposed with dimension 0, 0 if there is none
+            int b = nest.src_contiguous_dim();
+
+            std::size_t tile_0 = b == 0 ? chunk_size : block_size;
+            std::size_t tile_b = b == 0 ? 1 : block_size;
+
+            // number of tiles along each dimension
+            array<std::size_t, GT_TRANSFORM_MAX_DIM> tiles;
+            std::size_t num_tiles = 1;
+            for (int d = 0; d < nest.n; ++d) {
+                std::size_t tile = d == 0 ? tile_0 : d == b ? tile_b : 1;
+                tiles[d] = (nest.dims[d] + tile - 1) / tile;
+                num_tiles *= tiles[d];
+            }
+
+            using is_trivial_t = std::integral_constant<bool, std::is_trivially_copyable<DataType>::value>;
+
+#pragma omp parallel for schedule(static)
+            for (std::ptrdiff_t t = 0; t < (std::ptrdiff_t)num_tiles; ++t) {
+                std::size_t rest = t;
+                std::size_t dst_offset = 0;
+                std::size_t src_offset = 0;
+                std::size_t length_0 = 0;
+                std::size_t length_b = 1;
+                for (int d = 0; d < nest.n; ++d) {
+                    std::size_t tile = d == 0 ? tile_0 : d == b ? tile_b : 1;
+                    std::size_t first = rest % tiles[d] * tile;
+                    rest /= tiles[d];
+                    dst_offset += first * nest.dst_strides[d];
+                    src_offset += first * nest.src_strides[d];
+                    if (d == 0)
+                        length_0 = std::min(tile, nest.dims[d] - first);
+                    else if (d == b)
+                        length_b = std::min(tile, nest.dims[d] - first);
+                }
+                if (b == 0)
+                    copy_chunk(dst + dst_offset,
+                        src + src_offset,
+                        length_0,
+                        nest.dst_strides[0],
+                        nest.src_strides[0],
+                        is_trivial_t());
+                else
+                    transpose_tile(dst + dst_offset,
+                        src + src_offset,
+                        length_0,
+                        length_b,
+                        nest.dst_strides[0],
+                        nest.dst_strides[b],
+                        nest.src_strides[0],
+                        nest.src_strides[b]);
             }
         }
     } // namespace impl
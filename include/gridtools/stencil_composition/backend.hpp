@@ -11,13 +11,17 @@
 
 #include <functional>
 #include <utility>
+#include <vector>
 
+#include "../common/defs.hpp"
 #include "../common/hymap.hpp"
 #include "../common/tuple.hpp"
 #include "../common/tuple_util.hpp"
+#include "../meta.hpp"
 #include "dim.hpp"
 #include "make_stage_matrix.hpp"
 #include "positional.hpp"
+#include "roofline.hpp"
 #include "sid/sid_shift_origin.hpp"
 
 namespace gridtools {
@@ -43,17 +47,133 @@ namespace gridtools {
             return {};
         }
 
+        struct stateless {};
+
+        /**
+         *  Backends that need to keep resources alive between the runs of the same computation overload
+         *  `make_backend_state` for their backend type. The returned object is owned by the computation and passed
+         *  by reference as the last argument to `gridtools_backend_entry_point`.
+         */
+        template <class Backend>
+        stateless make_backend_state(Backend) {
+            return {};
+        }
+
         template <class Backend, class NeedPositionals, class Msses>
-        struct backend_entry_point_f {
+        class backend_entry_point_f {
+            using state_t = decltype(make_backend_state(Backend()));
+
+            state_t m_state = make_backend_state(Backend());
+            traffic_estimate m_traffic;
+
+            template <class... Args>
+            static void invoke(stateless &, Args &&... args) {
+                gridtools_backend_entry_point(std::forward<Args>(args)...);
+            }
+
+            template <class State, class... Args>
+            static void invoke(State &state, Args &&... args) {
+                gridtools_backend_entry_point(std::forward<Args>(args)..., state);
+            }
+
+          public:
             template <class Grid, class DataStores>
-            void operator()(Grid const &grid, DataStores data_stores) const {
-                gridtools_backend_entry_point(Backend(),
-                    make_stage_matrices<Msses, NeedPositionals, typename Grid::interval_t, DataStores>(),
+            void operator()(Grid const &grid, DataStores data_stores) {
+                using spec_t = make_stage_matrices<Msses, NeedPositionals, typename Grid::interval_t, DataStores>;
+                m_traffic = estimate_traffic(spec_t(), grid);
+                invoke(m_state,
+                    Backend(),
+                    spec_t(),
                     grid,
                     hymap::concat(
                         shift_origin(grid, std::move(data_stores)), make_positionals(grid, NeedPositionals())));
             }
+
+            /**
+             *  The estimated traffic of the last run, see `roofline.hpp`.
+             */
+            traffic_estimate const &traffic() const { return m_traffic; }
+
+            static double peak_bandwidth() { return gridtools::peak_bandwidth(Backend()); }
+        };
+
+        template <class NeedPositionals, class Grid, class DataStores>
+        auto convert_chunks(Grid const &grid, std::vector<DataStores> chunks) {
+            using chunk_t = decltype(hymap::concat(
+                shift_origin(grid, std::declval<DataStores>()), make_positionals(grid, NeedPositionals())));
+            std::vector<chunk_t> res;
+            res.reserve(chunks.size());
+            for (auto &chunk : chunks)
+                res.push_back(
+                    hymap::concat(shift_origin(grid, std::move(chunk)), make_positionals(grid, NeedPositionals())));
+            return res;
+        }
+
+        /**
+         *  Runs the computations given by the stage matrices `Specs` on the chunks of data stores `chunks`: a tuple
+         *  that holds a vector of data store maps per computation.
+         *
+         *  This default runs the chunks one after the other, backends that can schedule all of them at once overload
+         *  `gridtools_backend_chunked_entry_point` for their backend type.
+         */
+        template <class Backend, class Specs, class Grid, class Chunks, class... State>
+        void gridtools_backend_chunked_entry_point(
+            Backend, Specs, Grid const &grid, Chunks chunks, State &... state) {
+            tuple_util::for_each(
+                [&](auto spec, auto &chunks) {
+                    for (auto &chunk : chunks)
+                        gridtools_backend_entry_point(Backend(), spec, grid, std::move(chunk), state...);
+                },
+                meta::rename<tuple, Specs>(),
+                chunks);
+        }
+
+        /**
+         *  Like `backend_entry_point_f`, but runs several computations, the `i`th one on a vector of data store maps
+         *  given as the `i`th argument. All of them share the backend state.
+         */
+        template <class Backend, class NeedPositionals, class MssesList>
+        class backend_chunked_entry_point_f;
+
+        template <class Backend, class NeedPositionals, class... Msses>
+        class backend_chunked_entry_point_f<Backend, NeedPositionals, meta::list<Msses...>> {
+            using state_t = decltype(make_backend_state(Backend()));
+
+            state_t m_state = make_backend_state(Backend());
+            traffic_estimate m_traffic;
+
+            template <class... Args>
+            static void invoke(stateless &, Args &&... args) {
+                gridtools_backend_chunked_entry_point(std::forward<Args>(args)...);
+            }
+
+            template <class State, class... Args>
+            static void invoke(State &state, Args &&... args) {
+                gridtools_backend_chunked_entry_point(std::forward<Args>(args)..., state);
+            }
+
+          public:
+            template <class Grid, class... DataStores>
+            void operator()(Grid const &grid, std::vector<DataStores>... chunks) {
+                GT_STATIC_ASSERT(sizeof...(DataStores) == sizeof...(Msses), GT_INTERNAL_ERROR);
+                using specs_t =
+                    meta::list<make_stage_matrices<Msses, NeedPositionals, typename Grid::interval_t, DataStores>...>;
+                m_traffic = {};
+                tuple_util::for_each([&](auto spec, size_t size) { m_traffic += estimate_traffic(spec, grid) * size; },
+                    meta::rename<tuple, specs_t>(),
+                    tuple_util::make<tuple>(chunks.size()...));
+                invoke(m_state,
+                    Backend(),
+                    specs_t(),
+                    grid,
+                    tuple_util::make<tuple>(convert_chunks<NeedPositionals>(grid, std::move(chunks))...));
+            }
+
+            traffic_estimate const &traffic() const { return m_traffic; }
+
+            static double peak_bandwidth() { return gridtools::peak_bandwidth(Backend()); }
         };
     } // namespace backend_impl_
+    using backend_impl_::backend_chunked_entry_point_f;
     using backend_impl_::backend_entry_point_f;
 } // namespace gridtools
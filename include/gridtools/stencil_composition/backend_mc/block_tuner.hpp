@@ -0,0 +1,236 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "../../common/defs.hpp"
+#include "../../meta.hpp"
+#include "execinfo_mc.hpp"
+
+namespace gridtools {
+    namespace mc {
+        namespace _impl_block_tuner {
+            inline std::uint64_t fnv1a(char const *str) {
+                std::uint64_t hash = 14695981039346656037ull;
+                for (; *str; ++str) {
+                    hash ^= static_cast<unsigned char>(*str);
+                    hash *= 1099511628211ull;
+                }
+                return hash;
+            }
+
+            inline bool env_flag(char const *name) {
+                char const *value = std::getenv(name);
+                return value && *value && std::string(value) != "0";
+            }
+
+            inline std::string env_string(char const *name) {
+                char const *value = std::getenv(name);
+                return value ? value : "";
+            }
+        } // namespace _impl_block_tuner
+
+        /**
+         * @brief Hash of a stencil type that is stable between the runs of the same executable.
+         *
+         * The type is wrapped into a list to support incomplete types.
+         */
+        template <class Spec>
+        std::uint64_t stencil_hash() {
+            return _impl_block_tuner::fnv1a(typeid(meta::list<Spec>).name());
+        }
+
+        /**
+         * @brief Identifies the problems for which the tuned block sizes are valid.
+         */
+        struct tuning_key {
+            std::uint64_t stencil;
+            int_t i_size;
+            int_t j_size;
+            int_t k_size;
+            int_t threads;
+
+            friend bool operator==(tuning_key const &lhs, tuning_key const &rhs) {
+                return lhs.stencil == rhs.stencil && lhs.i_size == rhs.i_size && lhs.j_size == rhs.j_size &&
+                       lhs.k_size == rhs.k_size && lhs.threads == rhs.threads;
+            }
+            friend bool operator!=(tuning_key const &lhs, tuning_key const &rhs) { return !(lhs == rhs); }
+        };
+
+        struct block_sizes {
+            int_t i;
+            int_t j;
+
+            friend bool operator==(block_sizes const &lhs, block_sizes const &rhs) {
+                return lhs.i == rhs.i && lhs.j == rhs.j;
+            }
+        };
+
+        /**
+         * @brief Persistent block size cache.
+         *
+         * The cache is a text file with one entry per line:
+         * `<stencil hash> <i size> <j size> <k size> <threads> <i block size> <j block size>`.
+         * New entries are appended, the last matching entry wins.
+         */
+        class tuning_cache {
+            std::string m_file;
+
+          public:
+            explicit tuning_cache(std::string file) : m_file(std::move(file)) {}
+
+            bool empty() const { return m_file.empty(); }
+
+            bool find(tuning_key const &key, block_sizes &res) const {
+                if (m_file.empty())
+                    return false;
+                std::ifstream in(m_file);
+                bool found = false;
+                std::string line;
+                while (std::getline(in, line)) {
+                    std::istringstream entry(line);
+                    tuning_key cur;
+                    block_sizes sizes;
+                    if (entry >> cur.stencil >> cur.i_size >> cur.j_size >> cur.k_size >> cur.threads >> sizes.i >>
+                            sizes.j &&
+                        cur == key && sizes.i > 0 && sizes.j > 0) {
+                        res = sizes;
+                        found = true;
+                    }
+                }
+                return found;
+            }
+
+            void store(tuning_key const &key, block_sizes const &sizes) const {
+                if (m_file.empty())
+                    return;
+                std::ostringstream entry;
+                entry << key.stencil << ' ' << key.i_size << ' ' << key.j_size << ' ' << key.k_size << ' '
+                      << key.threads << ' ' << sizes.i << ' ' << sizes.j << '\n';
+                // a single write keeps concurrent appends from several processes on separate lines
+                std::ofstream(m_file, std::ios::app) << entry.str() << std::flush;
+            }
+        };
+
+        /**
+         * @brief Candidate block sizes for the auto-tuning. The first one is the default heuristic.
+         *
+         * All candidates provide at least one block per thread.
+         */
+        inline std::vector<block_sizes> block_size_candidates(int_t i_size, int_t j_size, int_t threads) {
+            execinfo_mc heuristic(i_size, j_size);
+            std::vector<block_sizes> res = {{heuristic.i_block_size(), heuristic.j_block_size()}};
+            for (int_t i_block_size : {i_size, int_t(256), int_t(128), int_t(64), int_t(32)}) {
+                if (i_block_size > i_size)
+                    continue;
+                int_t i_blocks = (i_size + i_block_size - 1) / i_block_size;
+                int_t min_j_blocks = (threads + i_blocks - 1) / i_blocks;
+                // one block per thread or two blocks per thread for better load balancing
+                for (int_t j_blocks : {min_j_blocks, 2 * min_j_blocks}) {
+                    if (j_blocks > j_size)
+                        continue;
+                    block_sizes candidate = {i_block_size, (j_size + j_blocks - 1) / j_blocks};
+                    if (std::find(res.begin(), res.end(), candidate) == res.end())
+                        res.push_back(candidate);
+                }
+            }
+            return res;
+        }
+
+        /**
+         * @brief Chooses the block sizes for the runs of an mc computation.
+         *
+         * Without tuning the default heuristic of `execinfo_mc` is used. If a cache file is given, block sizes found
+         * there for the same stencil, grid size and thread count are used. Otherwise, if the tuning is enabled, the
+         * first runs of the computation benchmark the candidate block sizes (one candidate per run after a warm-up
+         * run), the fastest one is used from then on and stored in the cache.
+         *
+         * The defaults are taken from the environment: `GT_MC_AUTOTUNE=1` enables the tuning and
+         * `GT_MC_TUNING_CACHE` names the cache file.
+         */
+        class block_tuner {
+            bool m_enabled;
+            tuning_cache m_cache;
+            bool m_has_key = false;
+            tuning_key m_key;
+            block_sizes m_best;
+            bool m_tuned = true;
+            bool m_warmed_up = false;
+            std::vector<block_sizes> m_candidates;
+            std::vector<double> m_timings;
+
+            void start(tuning_key const &key) {
+                m_has_key = true;
+                m_key = key;
+                m_candidates.clear();
+                m_timings.clear();
+                m_warmed_up = false;
+                execinfo_mc heuristic(key.i_size, key.j_size);
+                m_best = {heuristic.i_block_size(), heuristic.j_block_size()};
+                m_tuned = m_cache.find(key, m_best) || !m_enabled;
+                if (!m_tuned)
+                    m_candidates = block_size_candidates(key.i_size, key.j_size, key.threads);
+            }
+
+            void finish() {
+                auto best = std::min_element(m_timings.begin(), m_timings.end()) - m_timings.begin();
+                m_best = m_candidates[best];
+                m_tuned = true;
+                m_cache.store(m_key, m_best);
+            }
+
+          public:
+            block_tuner()
+                : block_tuner(_impl_block_tuner::env_flag("GT_MC_AUTOTUNE"),
+                      _impl_block_tuner::env_string("GT_MC_TUNING_CACHE")) {}
+
+            block_tuner(bool enabled, std::string cache_file) : m_enabled(enabled), m_cache(std::move(cache_file)) {}
+
+            /**
+             * @brief Executes `fun(execinfo_mc const &)` with the block sizes chosen for the given key.
+             */
+            template <class Fun>
+            void run(tuning_key const &key, Fun &&fun) {
+                if (!m_has_key || key != m_key)
+                    start(key);
+                if (m_tuned) {
+                    fun(execinfo_mc(key.i_size, key.j_size, m_best.i, m_best.j));
+                    return;
+                }
+                if (!m_warmed_up) {
+                    fun(execinfo_mc(key.i_size, key.j_size, m_best.i, m_best.j));
+                    m_warmed_up = true;
+                    return;
+                }
+                auto const &candidate = m_candidates[m_timings.size()];
+                double start = omp_get_wtime();
+                fun(execinfo_mc(key.i_size, key.j_size, candidate.i, candidate.j));
+                m_timings.push_back(omp_get_wtime() - start);
+                if (m_timings.size() == m_candidates.size())
+                    finish();
+            }
+
+            /** @brief Whether the block sizes are final for the last used key. */
+            bool tuned() const { return m_tuned; }
+
+            /** @brief The block sizes used after the tuning. */
+            block_sizes best() const { return m_best; }
+        };
+    } // namespace mc
+} // namespace gridtools
@@ -9,19 +9,26 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "../../common/defs.hpp"
 #include "../../common/hymap.hpp"
 #include "../../common/tuple_util.hpp"
 #include "../../meta.hpp"
+#include "../caches/cache_metafunctions.hpp"
+#include "../caches/host_k_caches.hpp"
 #include "../dim.hpp"
 #include "../pos3.hpp"
-#include "../sid/as_const.hpp"
 #include "../sid/block.hpp"
-#include "../sid/composite.hpp"
 #include "../sid/concept.hpp"
+#include "../sid/sid_shift_origin.hpp"
 #include "../stage_matrix.hpp"
+#include "../stage_meters.hpp"
+#include "block_tuner.hpp"
 #include "execinfo_mc.hpp"
 #include "loops.hpp"
 #include "tmp_storage_sid.hpp"
@@ -38,35 +45,116 @@ namespace gridtools {
                 return m_grid.k_size(Cell::interval());
             }
         };
-
-        template <class DataStores>
-        struct make_sid_f {
-            DataStores &m_data_stores;
-            template <class PtrInfo>
-            auto operator()(PtrInfo) const {
-                return sid::add_const(PtrInfo::is_const(), at_key<decltype(PtrInfo::plh())>(m_data_stores));
-            }
-        };
 #endif
 
-        template <class Spec, class Grid, class DataStores>
-        void gridtools_backend_entry_point(backend, Spec, Grid const &grid, DataStores external_data_stores) {
-            using stages_t = stage_matrix::make_split_view<Spec>;
-            using all_parrallel_t = typename meta::all_of<execute::is_parallel,
-                meta::transform<stage_matrix::get_execution, stages_t>>::type;
+        template <class T, class Extent, bool LevelWise, class Allocator>
+        auto make_temporary(std::false_type, Allocator &alloc, pos3<std::size_t> const &block_size) {
+            return make_tmp_storage_mc<T, Extent, LevelWise>(alloc, block_size);
+        }
 
-            tmp_allocator_mc alloc;
+        template <class T, class Extent, bool LevelWise, class Allocator>
+        auto make_temporary(std::true_type, Allocator &alloc, pos3<std::size_t> const &block_size) {
+            return make_ij_cache_mc<T, Extent>(alloc, block_size);
+        }
+
+        template <class Schedule>
+        block_tuner make_backend_state(backend<Schedule>) {
+            return {};
+        }
 
-            execinfo_mc info(grid);
+        /**
+         * @brief How the stages of `Spec` are executed.
+         */
+        template <class Spec>
+        struct execution_modes {
+            using stages_t = stage_matrix::make_split_view<Spec>;
+            using executions_t = meta::transform<stage_matrix::get_execution, stages_t>;
+            using all_parrallel_t = typename meta::all_of<execute::is_parallel, executions_t>::type;
+            // k-serial stages are pipelined level by level if there is more than one and the dependencies allow it
+            using k_wavefront_t = bool_constant<!all_parrallel_t::value && (meta::length<stages_t>::value > 1) &&
+                                                stage_matrix::can_pipeline_levels<stages_t>::value>;
+            // in both modes a thread finishes a k-level of a block before going to the next one
+            using level_wise_t = bool_constant<all_parrallel_t::value || k_wavefront_t::value>;
+            // otherwise the stages are applied to a j-row of a block one after the other if the dependencies between
+            // them are purely vertical, e.g. a backward sweep picks up the columns of a forward sweep from the cache
+            using fuse_columns_t = bool_constant<!level_wise_t::value && (meta::length<stages_t>::value > 1) &&
+                                                 stage_matrix::can_fuse_columns<stages_t>::value>;
+            using k_direction_t =
+                meta::if_<meta::any_of<execute::is_backward, executions_t>, execute::backward, execute::forward>;
+            using schedule_t = meta::if_<k_wavefront_t, k_wavefront<k_direction_t>, all_parrallel_t>;
+            // k-caches are rolled only if the items are executed column by column
+            using k_cached_items_t = meta::if_<level_wise_t, meta::list<>, stages_t>;
+            // ij-cached temporaries hold a single k-plane per thread if a thread finishes a level before the next one
+            using ij_cached_plhs_t =
+                meta::if_<level_wise_t, ij_cached_plhs<typename stages_t::tmp_plh_map_t>, meta::list<>>;
+            using tmp_plh_map_t = host_k_caches::tmp_plh_map<k_cached_items_t, typename stages_t::tmp_plh_map_t>;
+        };
+
+        template <class Spec>
+        using get_schedule = typename execution_modes<Spec>::schedule_t;
 
-            using tmp_plh_map_t = stage_matrix::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
-            auto temporaries = stage_matrix::make_data_stores(tmp_plh_map_t(),
+        /**
+         * @brief The temporaries of `Spec`. They are indexed by the thread, so they can be shared by several runs of
+         * `Spec` within the same parallel region.
+         */
+        template <class Spec, class Grid>
+        auto make_temporaries(Spec, Grid const &grid, execinfo_mc const &info, tmp_allocator_mc &alloc) {
+            using modes_t = execution_modes<Spec>;
+            using level_wise_t = typename modes_t::level_wise_t;
+            using ij_cached_plhs_t = typename modes_t::ij_cached_plhs_t;
+            return stage_matrix::make_data_stores(typename modes_t::tmp_plh_map_t(),
                 [&alloc,
                     block_size = make_pos3(
                         (size_t)info.i_block_size(), (size_t)info.j_block_size(), (size_t)grid.k_size())](auto info) {
-                    return make_tmp_storage_mc<decltype(info.data()), decltype(info.extent()), all_parrallel_t::value>(
-                        alloc, block_size);
+                    using extent_t = decltype(info.extent());
+                    using is_plane_t = bool_constant<meta::st_contains<ij_cached_plhs_t, decltype(info.plh())>::value &&
+                                                     extent_t::kminus::value == 0 && extent_t::kplus::value == 0>;
+                    return make_temporary<decltype(info.data()), extent_t, level_wise_t::value>(
+                        is_plane_t(), alloc, block_size);
                 });
+        }
+
+        template <class Spec, class Loops>
+        auto fuse_loops(std::false_type, Loops loops) {
+            return tuple_util::transform(
+                [](auto &&loop, auto stage) { return meter_stage<Spec, decltype(stage)>(std::move(loop)); },
+                std::move(loops),
+                meta::rename<tuple, typename execution_modes<Spec>::stages_t>());
+        }
+
+        /**
+         * @brief A single loop that applies all the column-wise loops of `Spec` to a j-row of a block before it goes to
+         * the next row.
+         */
+        template <class Spec, class Loops>
+        auto fuse_loops(std::true_type, Loops loops) {
+            using stages_t = meta::rename<tuple, typename execution_modes<Spec>::stages_t>;
+            using extent_t = typename meta::first<stages_t>::extent_t;
+            return tuple_util::make<tuple>([loops = std::move(loops)](execinfo_block_kserial_mc const &info) {
+                int_t j_size = extent_t::extend(dim::j(), info.j_block_size);
+                for (int_t j = 0; j < j_size; ++j)
+                    tuple_util::for_each(
+                        [&](auto const &loop, auto stage) {
+                            stage_meter<Spec, decltype(stage)> meter;
+                            loop.row(info, j);
+                        },
+                        loops,
+                        stages_t());
+            });
+        }
+
+        /**
+         * @brief The tuple of the loops over the stages of `Spec`, see `make_loop`.
+         */
+        template <class Spec, class Grid, class DataStores, class Temporaries>
+        auto make_loops(Spec,
+            Grid const &grid,
+            DataStores external_data_stores,
+            Temporaries temporaries,
+            execinfo_mc const &info,
+            tmp_allocator_mc &alloc) {
+            using modes_t = execution_modes<Spec>;
+            using k_cached_items_t = typename modes_t::k_cached_items_t;
 
             auto blocked_externals = tuple_util::transform(
                 [block_size = tuple_util::make<hymap::keys<dim::i, dim::j>::values>(
@@ -89,23 +177,82 @@ namespace gridtools {
                         ,
                         stage_t::cells());
 
-                    using plh_map_t = typename stage_t::plh_map_t;
-                    using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
-                    auto composite = tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
-#if defined(__INTEL_COMPILER) && __INTEL_COMPILER < 1900
-                        make_sid_f<decltype(data_stores)> { data_stores }
-#else
-                        [&](auto info) {
-                            return sid::add_const(info.is_const(), at_key<decltype(info.plh())>(data_stores));
-                        }
-#endif
-                        ,
-                        stage_t::plh_map()));
-                    return make_loop<stage_t>(all_parrallel_t(), grid, std::move(composite), std::move(k_sizes));
+                    auto windows = host_k_caches::make_windows<k_cached_items_t>(stage, [&](auto plh_info) {
+                        auto window = make_k_cache_window_mc<decltype(plh_info.data()), decltype(plh_info.key())>(
+                            alloc,
+                            stage_t::extent_t::extend(dim::i(), info.i_block_size()),
+                            host_k_caches::window_size(plh_info));
+                        auto offsets = tuple_util::make<hymap::keys<dim::i, dim::k>::values>(
+                            -stage_t::extent_t::minus(dim::i()),
+                            host_k_caches::window_start(plh_info, stage.k_step()) -
+                                grid.k_start(stage_t::interval(), stage_t::execution()));
+                        return sid::shift_sid_origin(std::move(window), offsets);
+                    });
+                    auto composite = host_k_caches::make_composite(stage, data_stores, windows);
+                    return make_loop<stage_t>(typename modes_t::level_wise_t(),
+                        grid,
+                        std::move(composite),
+                        std::move(k_sizes),
+                        host_k_caches::make_k_caches<k_cached_items_t>(stage));
                 },
-                meta::rename<tuple, stages_t>());
+                meta::rename<tuple, typename modes_t::stages_t>());
+            return fuse_loops<Spec>(typename modes_t::fuse_columns_t(), std::move(loops));
+        }
 
-            run_loops(all_parrallel_t(), grid, std::move(loops));
+        template <class Schedule, class Spec, class Grid, class DataStores>
+        void run_with_blocks(
+            Schedule, Spec, Grid const &grid, DataStores external_data_stores, execinfo_mc const &info) {
+            tmp_allocator_mc alloc;
+            auto temporaries = make_temporaries(Spec(), grid, info, alloc);
+            auto loops = make_loops(Spec(), grid, std::move(external_data_stores), std::move(temporaries), info, alloc);
+            run_loops(Schedule(), get_schedule<Spec>(), grid, info, std::move(loops));
+        }
+
+        template <class Schedule, class Specs, class Grid, class Chunks>
+        void run_chunks_with_blocks(Schedule, Specs, Grid const &grid, Chunks chunks, execinfo_mc const &info) {
+            GT_STATIC_ASSERT((meta::length<meta::dedup<meta::transform<get_schedule, Specs>>>::value == 1),
+                "all chunks have to be executed in the same mode");
+            tmp_allocator_mc alloc;
+            auto loops = tuple_util::transform(
+                [&](auto spec, auto &data_stores) {
+                    auto temporaries = make_temporaries(spec, grid, info, alloc);
+                    std::vector<decltype(make_loops(spec, grid, std::move(data_stores[0]), temporaries, info, alloc))>
+                        res;
+                    res.reserve(data_stores.size());
+                    for (auto &chunk : data_stores)
+                        res.push_back(make_loops(spec, grid, std::move(chunk), temporaries, info, alloc));
+                    return res;
+                },
+                meta::rename<tuple, Specs>(),
+                chunks);
+            run_chunks(Schedule(), get_schedule<meta::first<Specs>>(), grid, info, loops);
+        }
+
+        template <class Schedule, class Spec, class Grid, class DataStores>
+        void gridtools_backend_entry_point(
+            backend<Schedule>, Spec, Grid const &grid, DataStores external_data_stores, block_tuner &tuner) {
+            computation_meter<Spec> meter;
+            static std::uint64_t const hash = stencil_hash<Spec>();
+            tuner.run({hash, grid.i_size(), grid.j_size(), grid.k_size(), omp_get_max_threads()},
+                [&](execinfo_mc const &info) {
+                    run_with_blocks(Schedule(), Spec(), grid, std::move(external_data_stores), info);
+                });
+        }
+
+        /**
+         * @brief Runs all chunks within a single parallel region, the work items are pairs of a block and a chunk.
+         * The chunks of all `Specs` have to be executed in the same mode, which is the case for the chunks of
+         * expandable parameters.
+         */
+        template <class Schedule, class Specs, class Grid, class Chunks>
+        void gridtools_backend_chunked_entry_point(
+            backend<Schedule>, Specs, Grid const &grid, Chunks chunks, block_tuner &tuner) {
+            computation_meter<meta::first<Specs>> meter;
+            static std::uint64_t const hash = stencil_hash<Specs>();
+            tuner.run({hash, grid.i_size(), grid.j_size(), grid.k_size(), omp_get_max_threads()},
+                [&](execinfo_mc const &info) {
+                    run_chunks_with_blocks(Schedule(), Specs(), grid, std::move(chunks), info);
+                });
         }
     } // namespace mc
 } // namespace gridtools
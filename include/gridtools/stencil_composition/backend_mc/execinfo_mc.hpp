@@ -12,6 +12,7 @@
 
 #include "../../common/defs.hpp"
 #include "../../common/host_device.hpp"
+#include "../../storage/common/block_decomposition.hpp"
 
 namespace gridtools {
     namespace mc {
@@ -51,22 +52,26 @@ namespace gridtools {
                 return (block_index == blocks - 1) ? grid_size - block_index * block_size : block_size;
             }
 
+            GT_FORCE_INLINE execinfo_mc(int_t i_grid_size, int_t j_grid_size, block_decomposition const &blocks)
+                : m_i_grid_size(i_grid_size), m_j_grid_size(j_grid_size), m_i_block_size(blocks.i_block_size),
+                  m_j_block_size(blocks.j_block_size), m_i_blocks(blocks.i_blocks), m_j_blocks(blocks.j_blocks) {}
+
           public:
             template <class Grid>
-            GT_FORCE_INLINE execinfo_mc(const Grid &grid) : m_i_grid_size(grid.i_size()), m_j_grid_size(grid.j_size()) {
-                int_t threads = omp_get_max_threads();
+            GT_FORCE_INLINE execinfo_mc(const Grid &grid) : execinfo_mc(grid.i_size(), grid.j_size()) {}
 
-                // if domain is large enough (relative to the number of threads),
-                // we split only along j-axis (for prefetching reasons)
-                // for smaller domains we also split along i-axis
-                m_j_block_size = (m_j_grid_size + threads - 1) / threads;
-                m_j_blocks = (m_j_grid_size + m_j_block_size - 1) / m_j_block_size;
-                int_t max_i_blocks = threads / m_j_blocks;
-                m_i_block_size = (m_i_grid_size + max_i_blocks - 1) / max_i_blocks;
-                m_i_blocks = (m_i_grid_size + m_i_block_size - 1) / m_i_block_size;
+            GT_FORCE_INLINE execinfo_mc(int_t i_grid_size, int_t j_grid_size)
+                : execinfo_mc(i_grid_size,
+                      j_grid_size,
+                      block_decomposition::make_default(i_grid_size, j_grid_size, omp_get_max_threads())) {}
 
-                assert(m_i_block_size > 0 && m_j_block_size > 0);
-            }
+            /**
+             * @brief Uses the given block sizes instead of the default heuristic.
+             */
+            GT_FORCE_INLINE execinfo_mc(int_t i_grid_size, int_t j_grid_size, int_t i_block_size, int_t j_block_size)
+                : execinfo_mc(i_grid_size,
+                      j_grid_size,
+                      block_decomposition::with_block_sizes(i_grid_size, j_grid_size, i_block_size, j_block_size)) {}
 
             /**
              * @brief Computes the effective (clamped) block size and position for k-serial stencils.
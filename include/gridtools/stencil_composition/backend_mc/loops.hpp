@@ -11,20 +11,30 @@
 
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "../../common/defs.hpp"
 #include "../../common/generic_metafunctions/for_each.hpp"
 #include "../../common/tuple_util.hpp"
 #include "../../meta.hpp"
+#include "../block_schedule.hpp"
 #include "../dim.hpp"
+#include "../execution_types.hpp"
 #include "../sid/concept.hpp"
 #include "execinfo_mc.hpp"
+#include "simd.hpp"
 
 namespace gridtools {
     namespace mc {
         namespace loops_impl_ {
+            /**
+             * @brief Tag for `run_loops` to pipeline k-serial stages level by level.
+             */
+            template <class Execution>
+            struct k_wavefront {};
+
             template <class Stage, class Ptr, class Strides>
-            GT_FORCE_INLINE void i_loop(int_t size, Stage stage, Ptr &ptr, Strides const &strides) {
+            GT_FORCE_INLINE void i_loop(std::false_type, int_t size, Stage stage, Ptr &ptr, Strides const &strides) {
 #ifdef NDEBUG
 // TODO(anstaf & fthaler):
 //   Maybe we have to re-run tests with different combinations of pragmas on different compilers,
@@ -42,38 +52,91 @@ namespace gridtools {
                 sid::shift(ptr, sid::get_stride<dim::i>(strides), -size);
             }
 
-            template <class Ptr, class Strides>
+            template <class Stage, class Ptr, class Strides>
+            GT_FORCE_INLINE void i_loop(std::true_type, int_t size, Stage stage, Ptr &ptr, Strides const &strides) {
+                if (simd_impl_::is_contiguous<Stage>(strides))
+                    simd_impl_::i_loop(size, stage, ptr, strides);
+                else
+                    i_loop(std::false_type(), size, stage, ptr, strides);
+            }
+
+            /**
+             * @brief Applies `stage` to a row of `size` points, with explicit SIMD if the stage opted in (see
+             * `simd.hpp`).
+             */
+            template <class Stage, class Ptr, class Strides>
+            GT_FORCE_INLINE void i_loop(int_t size, Stage stage, Ptr &ptr, Strides const &strides) {
+                i_loop(simd_impl_::is_vectorizable<Stage, Ptr>(), size, stage, ptr, strides);
+            }
+
+            template <class Ptr, class Strides, class KCaches>
             struct k_i_loops_f {
                 int_t m_i_size;
                 Ptr &m_ptr;
                 Strides const &m_strides;
+                KCaches const &m_k_caches;
+                int_t &m_count;
 
                 template <class Cell, class KSize>
                 GT_FORCE_INLINE void operator()(Cell cell, KSize k_size) const {
                     for (int_t k = 0; k < k_size; ++k) {
                         i_loop(m_i_size, cell, m_ptr, m_strides);
                         cell.inc_k(m_ptr, m_strides);
+                        m_k_caches.slide(m_ptr, m_strides, cell.k_step(), m_count, m_i_size);
                     }
                 }
             };
 
-            template <class Ptr, class Strides>
-            GT_FORCE_INLINE k_i_loops_f<Ptr, Strides> make_k_i_loops(int_t i_size, Ptr &ptr, Strides const &strides) {
-                return {i_size, ptr, strides};
+            template <class Ptr, class Strides, class KCaches>
+            GT_FORCE_INLINE k_i_loops_f<Ptr, Strides, KCaches> make_k_i_loops(
+                int_t i_size, Ptr &ptr, Strides const &strides, KCaches const &k_caches, int_t &count) {
+                return {i_size, ptr, strides, k_caches, count};
+            }
+
+            /**
+             * @brief The index of the cell of `Stage` that covers a level for every level of the grid, -1 for the
+             * levels that are not covered by the stage.
+             */
+            template <class Stage, class Grid, class KSizes>
+            std::vector<int_t> make_level_cells(Grid const &grid, KSizes const &k_sizes) {
+                std::vector<int_t> res(grid.k_size(), -1);
+                int_t index = 0;
+                tuple_util::for_each(
+                    [&](auto cell, int_t k_size) {
+                        int_t k_start = grid.k_start(cell.interval());
+                        for (int_t k = k_start; k < k_start + k_size; ++k)
+                            res[k] = index;
+                        ++index;
+                    },
+                    Stage::cells(),
+                    k_sizes);
+                return res;
             }
 
-            template <class Stage, class Grid, class Composite, class KSizes>
-            auto make_loop(std::true_type, Grid const &grid, Composite composite, KSizes k_sizes) {
+            /**
+             * @brief Level-wise loop, k-caches are never rolled in this mode.
+             *
+             * The cell that covers a level is looked up in a table that is computed once, the loop over the block is
+             * then instantiated for that cell only. Thus the cost per block does not grow with the number of
+             * splitters of the axis, and the levels that the stage does not cover are skipped right away.
+             */
+            template <class Stage, class Grid, class Composite, class KSizes, class KCaches>
+            auto make_loop(std::true_type, Grid const &grid, Composite composite, KSizes k_sizes, KCaches) {
                 using extent_t = typename Stage::extent_t;
                 using ptr_diff_t = sid::ptr_diff_type<Composite>;
+                using cells_t = decltype(Stage::cells());
                 auto strides = sid::get_strides(composite);
                 ptr_diff_t offset{};
                 sid::shift(offset, sid::get_stride<dim::i>(strides), extent_t::minus(dim::i()));
                 sid::shift(offset, sid::get_stride<dim::j>(strides), extent_t::minus(dim::j()));
                 return [origin = sid::get_origin(composite) + offset,
                            strides = std::move(strides),
-                           k_start = grid.k_start(Stage::interval()),
-                           k_sizes = std::move(k_sizes)](execinfo_block_kparallel_mc const &info) {
+                           level_cells = make_level_cells<Stage>(grid, k_sizes)](
+                           execinfo_block_kparallel_mc const &info) {
+                    int_t cell_index = level_cells[info.k];
+                    if (cell_index < 0)
+                        return;
+
                     ptr_diff_t offset{};
                     sid::shift(offset, sid::get_stride<dim::thread>(strides), omp_get_thread_num());
                     sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::i>>(strides), info.i_block);
@@ -84,40 +147,95 @@ namespace gridtools {
                     int_t j_count = extent_t::extend(dim::j(), info.j_block_size);
                     int_t i_size = extent_t::extend(dim::i(), info.i_block_size);
 
-                    for (int_t j = 0; j < j_count; ++j) {
-                        using namespace literals;
-                        int_t cur = k_start;
-                        tuple_util::for_each(
-                            [&ptr, &strides, &cur, k = info.k, i_size](auto cell, auto k_size) {
-                                if (k >= cur && k < cur + k_size)
-                                    i_loop(i_size, cell, ptr, strides);
-                                cur += k_size;
-                            },
-                            Stage::cells(),
-                            k_sizes);
-                        sid::shift(ptr, sid::get_stride<dim::j>(strides), 1_c);
-                    }
+                    for_each<meta::make_indices_for<cells_t>>([&](auto index) {
+                        if (cell_index != decltype(index)::value)
+                            return;
+                        auto cell = tuple_util::get<decltype(index)::value>(cells_t());
+                        for (int_t j = 0; j < j_count; ++j) {
+                            using namespace literals;
+                            i_loop(i_size, cell, ptr, strides);
+                            sid::shift(ptr, sid::get_stride<dim::j>(strides), 1_c);
+                        }
+                    });
                 };
             }
 
-            template <class Grid, class Loops>
-            void run_loops(std::true_type, Grid const &grid, Loops loops) {
-                execinfo_mc info(grid);
+            /**
+             * @brief Calls `fun(chunk, block)` for the `chunks` chunks of all level-wise blocks, the blocks of a chunk
+             * are neighbouring work items.
+             */
+            template <class Schedule, class Grid, class Fun>
+            void run_blocks(
+                Schedule, std::true_type, Grid const &grid, execinfo_mc const &info, int_t chunks, Fun const &fun) {
                 int_t i_blocks = info.i_blocks();
                 int_t j_blocks = info.j_blocks();
                 int_t k_size = grid.k_size();
-#pragma omp parallel for collapse(3)
-                for (int_t j = 0; j < j_blocks; ++j) {
-                    for (int_t k = 0; k < k_size; ++k) {
-                        for (int_t i = 0; i < i_blocks; ++i) {
-                            tuple_util::for_each([block = info.block(i, j, k)](auto &&loop) { loop(block); }, loops);
-                        }
+                // blocks are enumerated with j outermost and i innermost
+                int_t blocks = j_blocks * k_size * i_blocks;
+                parallel_for_blocks(Schedule(), blocks * chunks, [&](int_t index) {
+                    int_t chunk = index / blocks;
+                    int_t block = index % blocks;
+                    int_t i = block % i_blocks;
+                    int_t k = block / i_blocks % k_size;
+                    int_t j = block / i_blocks / k_size;
+                    fun(chunk, info.block(i, j, k));
+                });
+            }
+
+            /**
+             * @brief Column-wise loop, the rolled k-caches (see `host_k_caches.hpp`) are windows of k-planes of the
+             * block that slide along the columns of a j-row. `operator()` processes a block, `row` a single j-row of
+             * a block.
+             */
+            template <class Stage, class PtrDiff, class Origin, class Strides, class KSizes, class KCaches>
+            struct column_wise_loop {
+                using stage_t = Stage;
+                using extent_t = typename Stage::extent_t;
+
+                Origin m_origin;
+                Strides m_strides;
+                KSizes m_k_sizes;
+                KCaches m_k_caches;
+
+                auto block_ptr(execinfo_block_kserial_mc const &info) const {
+                    PtrDiff offset{};
+                    sid::shift(offset, sid::get_stride<dim::thread>(m_strides), omp_get_thread_num());
+                    sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::i>>(m_strides), info.i_block);
+                    sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::j>>(m_strides), info.j_block);
+                    return m_origin() + offset;
+                }
+
+                template <class Ptr>
+                GT_FORCE_INLINE void run_row(Ptr const &ptr, int_t i_size) const {
+                    auto k_ptr = ptr;
+                    int_t count = 0;
+                    tuple_util::for_each(
+                        make_k_i_loops(i_size, k_ptr, m_strides, m_k_caches, count), Stage::cells(), m_k_sizes);
+                }
+
+                void operator()(execinfo_block_kserial_mc const &info) const {
+                    auto ptr = block_ptr(info);
+                    int_t j_size = extent_t::extend(dim::j(), info.j_block_size);
+                    int_t i_size = extent_t::extend(dim::i(), info.i_block_size);
+                    for (int_t j = 0; j < j_size; ++j) {
+                        using namespace literals;
+                        run_row(ptr, i_size);
+                        sid::shift(ptr, sid::get_stride<dim::j>(m_strides), 1_c);
                     }
                 }
-            }
 
-            template <class Stage, class Grid, class Composite, class KSizes>
-            auto make_loop(std::false_type, Grid const &grid, Composite composite, KSizes k_sizes) {
+                /**
+                 * @brief Processes the j-th row of a block, the rows are counted from the lower end of the extent.
+                 */
+                void row(execinfo_block_kserial_mc const &info, int_t j) const {
+                    auto ptr = block_ptr(info);
+                    sid::shift(ptr, sid::get_stride<dim::j>(m_strides), j);
+                    run_row(ptr, extent_t::extend(dim::i(), info.i_block_size));
+                }
+            };
+
+            template <class Stage, class Grid, class Composite, class KSizes, class KCaches>
+            auto make_loop(std::false_type, Grid const &grid, Composite composite, KSizes k_sizes, KCaches k_caches) {
                 using extent_t = typename Stage::extent_t;
                 using ptr_diff_t = sid::ptr_diff_type<Composite>;
 
@@ -128,43 +246,87 @@ namespace gridtools {
                 sid::shift(
                     offset, sid::get_stride<dim::k>(strides), grid.k_start(Stage::interval(), Stage::execution()));
 
-                return [origin = sid::get_origin(composite) + offset,
-                           strides = std::move(strides),
-                           k_shift_back = -grid.k_size(Stage::interval()) * Stage::k_step(),
-                           k_sizes = std::move(k_sizes)](execinfo_block_kserial_mc const &info) {
-                    sid::ptr_diff_type<Composite> offset{};
-                    sid::shift(offset, sid::get_stride<dim::thread>(strides), omp_get_thread_num());
-                    sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::i>>(strides), info.i_block);
-                    sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::j>>(strides), info.j_block);
-                    auto ptr = origin() + offset;
-
-                    int_t j_size = extent_t::extend(dim::j(), info.j_block_size);
-                    int_t i_size = extent_t::extend(dim::i(), info.i_block_size);
+                auto origin = sid::get_origin(composite) + offset;
+                return column_wise_loop<Stage,
+                    ptr_diff_t,
+                    decltype(origin),
+                    decltype(strides),
+                    KSizes,
+                    KCaches>{std::move(origin), std::move(strides), std::move(k_sizes), std::move(k_caches)};
+            }
 
-                    auto k_i_loops = make_k_i_loops(i_size, ptr, strides);
-                    for (int_t j = 0; j < j_size; ++j) {
-                        using namespace literals;
-                        tuple_util::for_each(k_i_loops, Stage::cells(), k_sizes);
-                        sid::shift(ptr, sid::get_stride<dim::k>(strides), k_shift_back);
-                        sid::shift(ptr, sid::get_stride<dim::j>(strides), 1_c);
-                    }
-                };
+            template <class Schedule, class Grid, class Fun>
+            void run_blocks(
+                Schedule, std::false_type, Grid const &, execinfo_mc const &info, int_t chunks, Fun const &fun) {
+                int_t i_blocks = info.i_blocks();
+                int_t blocks = info.j_blocks() * i_blocks;
+                parallel_for_blocks(Schedule(), blocks * chunks, [&](int_t index) {
+                    int_t chunk = index / blocks;
+                    int_t block = index % blocks;
+                    int_t i = block % i_blocks;
+                    int_t j = block / i_blocks;
+                    fun(chunk, info.block(i, j));
+                });
             }
 
-            template <class Grid, class Loops>
-            void run_loops(std::false_type, Grid const &grid, Loops loops) {
-                execinfo_mc info(grid);
+            /**
+             * @brief Executes the level-wise loops (see `make_loop(std::true_type, ...)`) of k-serial stages as a
+             * wavefront: every thread processes its blocks level by level in the direction given by `Execution`, all
+             * stages are applied to a level before the next one is touched.
+             */
+            template <class Schedule, class Execution, class Grid, class Fun>
+            void run_blocks(Schedule,
+                k_wavefront<Execution>,
+                Grid const &grid,
+                execinfo_mc const &info,
+                int_t chunks,
+                Fun const &fun) {
                 int_t i_blocks = info.i_blocks();
-                int_t j_blocks = info.j_blocks();
-#pragma omp parallel for collapse(2)
-                for (int_t j = 0; j < j_blocks; ++j) {
-                    for (int_t i = 0; i < i_blocks; ++i) {
-                        tuple_util::for_each([block = info.block(i, j)](auto &&loop) { loop(block); }, loops);
+                int_t k_size = grid.k_size();
+                int_t blocks = info.j_blocks() * i_blocks;
+                parallel_for_blocks(Schedule(), blocks * chunks, [&](int_t index) {
+                    int_t chunk = index / blocks;
+                    int_t block = index % blocks;
+                    int_t i = block % i_blocks;
+                    int_t j = block / i_blocks;
+                    for (int_t k = 0; k < k_size; ++k) {
+                        int_t level = execute::is_backward<Execution>::value ? k_size - 1 - k : k;
+                        fun(chunk, info.block(i, j, level));
                     }
-                }
+                });
+            }
+
+            template <class Schedule, class Mode, class Grid, class Loops>
+            void run_loops(Schedule, Mode, Grid const &grid, execinfo_mc const &info, Loops loops) {
+                run_blocks(Schedule(), Mode(), grid, info, 1, [&](int_t, auto const &block) {
+                    tuple_util::for_each([&](auto &&loop) { loop(block); }, loops);
+                });
+            }
+
+            /**
+             * @brief Executes all chunks within a single parallel region, `chunks` is a tuple of vectors of loops,
+             * the chunks are numbered through all of them.
+             */
+            template <class Schedule, class Mode, class Grid, class Chunks>
+            void run_chunks(Schedule, Mode, Grid const &grid, execinfo_mc const &info, Chunks const &chunks) {
+                int_t total = 0;
+                tuple_util::for_each([&](auto const &loops) { total += loops.size(); }, chunks);
+                if (total == 0)
+                    return;
+                run_blocks(Schedule(), Mode(), grid, info, total, [&](int_t chunk, auto const &block) {
+                    tuple_util::for_each(
+                        [&](auto const &loops) {
+                            if (chunk >= 0 && chunk < (int_t)loops.size())
+                                tuple_util::for_each([&](auto const &loop) { loop(block); }, loops[chunk]);
+                            chunk -= loops.size();
+                        },
+                        chunks);
+                });
             }
         } // namespace loops_impl_
+        using loops_impl_::k_wavefront;
         using loops_impl_::make_loop;
+        using loops_impl_::run_chunks;
         using loops_impl_::run_loops;
     } // namespace mc
 } // namespace gridtools
@@ -0,0 +1,373 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "../../common/defs.hpp"
+#include "../../common/gt_math.hpp"
+#include "../../common/host_device.hpp"
+#include "../../common/hymap.hpp"
+#include "../../meta.hpp"
+#include "../accessor_intent.hpp"
+#include "../dim.hpp"
+#include "../expressions/expr_base.hpp"
+#include "../sid/concept.hpp"
+#include "../sid/multi_shift.hpp"
+#include "../stage.hpp"
+
+/**
+ *  @file
+ *  Explicit SIMD execution of stages in the mc backend.
+ *
+ *  The stages of elementary functors that declare
+ *
+ *      struct lap_function {
+ *          static constexpr bool simd = true;
+ *          ...
+ *      };
+ *
+ *  are evaluated for `GT_MC_SIMD_BYTES / sizeof(T)` consecutive points along i at once, where `T` is the largest value
+ *  type accessed by the stage. The accessors then evaluate to `simd_vec`s (`simd_ref`s for inout accessors), on which
+ *  the arithmetic operators, the expressions and the functions `math::fabs`, `abs`, `sqrt`, `exp`, `log`, `pow`, `max`
+ *  and `min` are defined. The remainder at the end of a block row is evaluated with partial vectors, whose inactive
+ *  lanes are neither loaded nor stored.
+ *
+ *  Such functors must not branch on field values, access the positionals or mix value types in an arithmetic
+ *  operation. If the fields of a stage are not contiguous along i, the stage is evaluated point by point.
+ */
+
+#ifndef GT_MC_SIMD_BYTES
+#if defined(__AVX512F__)
+#define GT_MC_SIMD_BYTES 64
+#elif defined(__AVX__)
+#define GT_MC_SIMD_BYTES 32
+#else
+#define GT_MC_SIMD_BYTES 16
+#endif
+#endif
+
+namespace gridtools {
+    namespace mc {
+        namespace simd_impl_ {
+            /**
+             * @brief `N` values of type `T`, stored in a GCC vector type.
+             */
+            template <class T, int_t N>
+            struct simd_vec {
+                GT_STATIC_ASSERT(N > 0 && (N & (N - 1)) == 0, "the number of lanes has to be a power of two");
+
+                typedef T native_t __attribute__((vector_size(N * sizeof(T))));
+
+                native_t m_value;
+
+                simd_vec() = default;
+                GT_FORCE_INLINE simd_vec(T value) : m_value(native_t{} + value) {}
+
+                static GT_FORCE_INLINE simd_vec wrap(native_t value) {
+                    simd_vec res;
+                    res.m_value = value;
+                    return res;
+                }
+
+                /**
+                 * @brief Loads the first `count` lanes from `ptr`, the others are set to the first value.
+                 */
+                template <class Count>
+                static GT_FORCE_INLINE simd_vec load(T const *ptr, Count count) {
+                    native_t res;
+                    if (count == N) {
+                        std::memcpy(&res, ptr, sizeof(res));
+                    } else {
+                        res = native_t{} + ptr[0];
+                        for (int_t i = 1; i < count; ++i)
+                            res[i] = ptr[i];
+                    }
+                    return wrap(res);
+                }
+
+                /**
+                 * @brief Stores the first `count` lanes to `ptr`.
+                 */
+                template <class Count>
+                GT_FORCE_INLINE void store(T *ptr, Count count) const {
+                    if (count == N) {
+                        std::memcpy(ptr, &m_value, sizeof(m_value));
+                    } else {
+                        for (int_t i = 0; i < count; ++i)
+                            ptr[i] = m_value[i];
+                    }
+                }
+
+                GT_FORCE_INLINE T operator[](int_t i) const { return m_value[i]; }
+
+                friend GT_FORCE_INLINE simd_vec operator+(simd_vec const &arg) { return arg; }
+                friend GT_FORCE_INLINE simd_vec operator-(simd_vec const &arg) { return wrap(-arg.m_value); }
+
+                friend GT_FORCE_INLINE simd_vec operator+(simd_vec const &lhs, simd_vec const &rhs) {
+                    return wrap(lhs.m_value + rhs.m_value);
+                }
+                friend GT_FORCE_INLINE simd_vec operator-(simd_vec const &lhs, simd_vec const &rhs) {
+                    return wrap(lhs.m_value - rhs.m_value);
+                }
+                friend GT_FORCE_INLINE simd_vec operator*(simd_vec const &lhs, simd_vec const &rhs) {
+                    return wrap(lhs.m_value * rhs.m_value);
+                }
+                friend GT_FORCE_INLINE simd_vec operator/(simd_vec const &lhs, simd_vec const &rhs) {
+                    return wrap(lhs.m_value / rhs.m_value);
+                }
+
+                GT_FORCE_INLINE simd_vec &operator+=(simd_vec const &rhs) { return *this = *this + rhs; }
+                GT_FORCE_INLINE simd_vec &operator-=(simd_vec const &rhs) { return *this = *this - rhs; }
+                GT_FORCE_INLINE simd_vec &operator*=(simd_vec const &rhs) { return *this = *this * rhs; }
+                GT_FORCE_INLINE simd_vec &operator/=(simd_vec const &rhs) { return *this = *this / rhs; }
+            };
+
+            /**
+             * @brief The value of an inout accessor: the loaded lanes and the location they are stored to on
+             * assignment.
+             */
+            template <class T, int_t N, class Count>
+            class simd_ref : public simd_vec<T, N> {
+                T *m_ptr;
+                Count m_count;
+
+              public:
+                GT_FORCE_INLINE simd_ref(T *ptr, Count count)
+                    : simd_vec<T, N>(simd_vec<T, N>::load(ptr, count)), m_ptr(ptr), m_count(count) {}
+
+                simd_ref(simd_ref const &) = default;
+
+                GT_FORCE_INLINE simd_ref &operator=(simd_vec<T, N> const &value) {
+                    this->m_value = value.m_value;
+                    this->store(m_ptr, m_count);
+                    return *this;
+                }
+                GT_FORCE_INLINE simd_ref &operator=(simd_ref const &value) {
+                    return *this = static_cast<simd_vec<T, N> const &>(value);
+                }
+
+                GT_FORCE_INLINE simd_ref &operator+=(simd_vec<T, N> const &rhs) { return *this = *this + rhs; }
+                GT_FORCE_INLINE simd_ref &operator-=(simd_vec<T, N> const &rhs) { return *this = *this - rhs; }
+                GT_FORCE_INLINE simd_ref &operator*=(simd_vec<T, N> const &rhs) { return *this = *this * rhs; }
+                GT_FORCE_INLINE simd_ref &operator/=(simd_vec<T, N> const &rhs) { return *this = *this / rhs; }
+            };
+
+            template <class T, int_t N, class Fun, class... Args>
+            GT_FORCE_INLINE simd_vec<T, N> lanewise(Fun fun, simd_vec<T, N> const &arg, Args const &... args) {
+                simd_vec<T, N> res;
+                for (int_t i = 0; i < N; ++i)
+                    res.m_value[i] = fun(arg[i], args[i]...);
+                return res;
+            }
+
+            template <class Ptr, class Key>
+            using value_type = std::remove_const_t<std::remove_pointer_t<
+                std::decay_t<decltype(host_device::at_key<Key>(std::declval<Ptr const &>()))>>>;
+
+            template <class Ptr>
+            struct is_pointer_key {
+                template <class Key>
+                using apply = std::is_pointer<
+                    std::decay_t<decltype(host_device::at_key<Key>(std::declval<Ptr const &>()))>>;
+            };
+
+            template <class Ptr>
+            struct value_size {
+                template <class Key>
+                using apply = integral_constant<int_t, sizeof(value_type<Ptr, Key>)>;
+            };
+
+            template <class Functor, class = void>
+            struct functor_simd : std::false_type {};
+
+            template <class Functor>
+            struct functor_simd<Functor, std::enable_if_t<Functor::simd>> : std::true_type {};
+
+            template <class>
+            struct stage_functor {
+                using type = void;
+            };
+
+            template <class Functor, class PlhMap>
+            struct stage_functor<stage<Functor, PlhMap>> {
+                using type = Functor;
+            };
+
+            template <class>
+            struct stage_keys {
+                using type = meta::list<>;
+            };
+
+            template <class Functor, class PlhMap>
+            struct stage_keys<stage<Functor, PlhMap>> {
+                using type = meta::rename<meta::list, PlhMap>;
+            };
+
+            template <class Stage>
+            using is_simd_stage = functor_simd<typename stage_functor<Stage>::type>;
+
+            template <class Cell>
+            using cell_keys = meta::dedup<
+                meta::flatten<meta::transform<meta::force<stage_keys>::apply, typename Cell::funs_t>>>;
+
+            /**
+             * @brief Whether all stages of `Cell` opted in and all their fields are accessed through raw pointers.
+             */
+            template <class Cell, class Ptr>
+            using is_vectorizable = bool_constant<meta::all_of<is_simd_stage, typename Cell::funs_t>::value &&
+                                                  meta::all_of<is_pointer_key<Ptr>::template apply,
+                                                      cell_keys<Cell>>::value>;
+
+            template <class... Sizes>
+            struct max_size : integral_constant<int_t, std::max({int_t(1), Sizes::value...})> {};
+
+            template <class Cell, class Ptr>
+            using lanes = integral_constant<int_t,
+                std::max(int_t(1),
+                    GT_MC_SIMD_BYTES /
+                        meta::rename<max_size,
+                            meta::transform<value_size<Ptr>::template apply, cell_keys<Cell>>>::value)>;
+
+            template <int_t N, class Ptr, class Strides, class Keys, class Count>
+            struct evaluator {
+                Ptr const &m_ptr;
+                Strides const &m_strides;
+                Count m_count;
+
+                template <class T>
+                GT_FORCE_INLINE simd_vec<std::remove_const_t<T>, N> deref(
+                    std::integral_constant<intent, intent::in>, T *ptr) const {
+                    return simd_vec<std::remove_const_t<T>, N>::load(ptr, m_count);
+                }
+
+                template <class T>
+                GT_FORCE_INLINE simd_ref<T, N, Count> deref(
+                    std::integral_constant<intent, intent::inout>, T *ptr) const {
+                    return {ptr, m_count};
+                }
+
+                template <class Accessor>
+                GT_FORCE_INLINE auto operator()(Accessor acc) const {
+                    using key_t = meta::at_c<Keys, Accessor::index_t::value>;
+                    auto ptr = host_device::at_key<key_t>(m_ptr);
+                    sid::multi_shift<key_t>(ptr, m_strides, std::move(acc));
+                    return deref(std::integral_constant<intent, Accessor::intent_v>(), ptr);
+                }
+
+                template <class Op, class... Ts>
+                GT_FORCE_INLINE auto operator()(expr<Op, Ts...> arg) const {
+                    return expressions::evaluation::value(*this, std::move(arg));
+                }
+            };
+
+            template <int_t N, class Ptr, class Strides, class Count>
+            struct apply_stage_f {
+                Ptr const &m_ptr;
+                Strides const &m_strides;
+                Count m_count;
+
+                template <class Functor, class PlhMap>
+                GT_FORCE_INLINE void operator()(stage<Functor, PlhMap>) const {
+                    using eval_t = evaluator<N, Ptr, Strides, PlhMap, Count>;
+                    eval_t eval{m_ptr, m_strides, m_count};
+                    Functor::template apply<eval_t &>(eval);
+                }
+            };
+
+            template <class Cell, class Strides>
+            struct is_contiguous_f {
+                Strides const &m_strides;
+                bool &m_res;
+
+                template <class Key>
+                GT_FORCE_INLINE void operator()() const {
+                    m_res = m_res && sid::get_stride_element<Key, dim::i>(m_strides) == 1;
+                }
+            };
+
+            /**
+             * @brief Whether the fields of `Cell` are contiguous along i.
+             */
+            template <class Cell, class Strides>
+            GT_FORCE_INLINE bool is_contiguous(Strides const &strides) {
+                bool res = true;
+                host_device::for_each_type<cell_keys<Cell>>(is_contiguous_f<Cell, Strides>{strides, res});
+                return res;
+            }
+
+            /**
+             * @brief Applies the stages of `Cell` to `size` points along i, starting at `ptr`, with vectors of
+             * `lanes<Cell, Ptr>` lanes.
+             */
+            template <class Cell, class Ptr, class Strides>
+            GT_FORCE_INLINE void i_loop(int_t size, Cell, Ptr &ptr, Strides const &strides) {
+                using lanes_t = lanes<Cell, Ptr>;
+                using full_t = apply_stage_f<lanes_t::value, Ptr, Strides, lanes_t>;
+                using partial_t = apply_stage_f<lanes_t::value, Ptr, Strides, int_t>;
+                int_t i = 0;
+                for (; i + lanes_t::value <= size; i += lanes_t::value) {
+                    host_device::for_each<typename Cell::funs_t>(full_t{ptr, strides, lanes_t()});
+                    sid::shift(ptr, sid::get_stride<dim::i>(strides), lanes_t());
+                }
+                if (i < size)
+                    host_device::for_each<typename Cell::funs_t>(partial_t{ptr, strides, size - i});
+                sid::shift(ptr, sid::get_stride<dim::i>(strides), -i);
+            }
+        } // namespace simd_impl_
+        using simd_impl_::simd_ref;
+        using simd_impl_::simd_vec;
+    } // namespace mc
+
+    namespace math {
+        template <class T, int_t N>
+        GT_FORCE_INLINE mc::simd_vec<T, N> fabs(mc::simd_vec<T, N> const &arg) {
+            return mc::simd_impl_::lanewise([](T val) { return math::fabs(val); }, arg);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE mc::simd_vec<T, N> abs(mc::simd_vec<T, N> const &arg) {
+            return mc::simd_impl_::lanewise([](T val) { return math::abs(val); }, arg);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE mc::simd_vec<T, N> sqrt(mc::simd_vec<T, N> const &arg) {
+            return mc::simd_impl_::lanewise([](T val) { return math::sqrt(val); }, arg);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE mc::simd_vec<T, N> exp(mc::simd_vec<T, N> const &arg) {
+            return mc::simd_impl_::lanewise([](T val) { return math::exp(val); }, arg);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE mc::simd_vec<T, N> log(mc::simd_vec<T, N> const &arg) {
+            return mc::simd_impl_::lanewise([](T val) { return math::log(val); }, arg);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE mc::simd_vec<T, N> pow(mc::simd_vec<T, N> const &base, mc::simd_vec<T, N> const &exponent) {
+            return mc::simd_impl_::lanewise([](T b, T e) { return math::pow(b, e); }, base, exponent);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE mc::simd_vec<T, N> max(mc::simd_vec<T, N> const &lhs, mc::simd_vec<T, N> const &rhs) {
+            return mc::simd_impl_::lanewise([](T l, T r) { return l > r ? l : r; }, lhs, rhs);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE mc::simd_vec<T, N> min(mc::simd_vec<T, N> const &lhs, mc::simd_vec<T, N> const &rhs) {
+            return mc::simd_impl_::lanewise([](T l, T r) { return l < r ? l : r; }, lhs, rhs);
+        }
+    } // namespace math
+} // namespace gridtools
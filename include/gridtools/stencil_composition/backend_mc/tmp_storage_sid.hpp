@@ -63,6 +63,16 @@ namespace gridtools {
                 return bs.i * bs.j * bs.k * omp_get_max_threads() + extra;
             }
 
+            /**
+             * @brief Size of the allocation of a temporary buffer that holds a single k-plane per thread.
+             */
+            template <class T, class Extent>
+            std::size_t plane_storage_size(pos3<std::size_t> const &block_size) {
+                auto bs = full_block_size<T, Extent>(block_size);
+                constexpr std::size_t extra = (byte_alignment::value + sizeof(T) - 1) / sizeof(T);
+                return bs.i * bs.j * omp_get_max_threads() + extra;
+            }
+
             template <std::size_t, class>
             struct strides_kind_impl;
 
@@ -135,5 +145,41 @@ namespace gridtools {
                 .template set<sid::property::strides_kind, _impl_tmp_mc::strides_kind<T, Extent>>()
                 .template set<sid::property::ptr_diff, int_t>();
         }
+
+        /**
+         * @brief ij-cached temporary for the level-wise loops: a single k-plane of the block (including extents) per
+         * thread, which is reused for all k-levels and stays in the L1/L2 cache while the stages of a level run.
+         *
+         * The strides are the ones of `make_tmp_storage_mc` for level-wise loops, only the allocation is smaller.
+         */
+        template <class T, class Extent, class Allocator>
+        auto make_ij_cache_mc(Allocator &allocator, pos3<std::size_t> const &block_size) {
+            GT_STATIC_ASSERT(Extent::kminus::value == 0 && Extent::kplus::value == 0,
+                "ij-cached temporaries can not be accessed with k-offsets");
+            return sid::synthetic()
+                .set<sid::property::origin>(
+                    allocate(allocator, meta::lazy::id<T>(), _impl_tmp_mc::plane_storage_size<T, Extent>(block_size)) +
+                    _impl_tmp_mc::origin_offset<T, Extent, true>(block_size))
+                .template set<sid::property::strides>(_impl_tmp_mc::strides<T, Extent, true>(block_size))
+                .template set<sid::property::strides_kind, _impl_tmp_mc::strides_kind<T, Extent>>()
+                .template set<sid::property::ptr_diff, int_t>();
+        }
+
+        /**
+         * @brief Per thread window of a rolled k-cache: `size` k-planes of `plane_size` elements along i.
+         */
+        template <class T, class StridesKind, class Allocator>
+        auto make_k_cache_window_mc(Allocator &allocator, std::size_t plane_size, std::size_t size) {
+            int_t plane_stride = _impl_tmp_mc::pad<T>(plane_size);
+            int_t thread_stride = plane_stride * size;
+            return sid::synthetic()
+                .set<sid::property::origin>(
+                    allocate(allocator, meta::lazy::id<T>(), thread_stride * omp_get_max_threads()))
+                .template set<sid::property::strides>(
+                    hymap::keys<dim::i, dim::k, dim::thread>::values<integral_constant<int_t, 1>, int_t, int_t>(
+                        integral_constant<int_t, 1>(), plane_stride, thread_stride))
+                .template set<sid::property::strides_kind, StridesKind>()
+                .template set<sid::property::ptr_diff, int_t>();
+        }
     } // namespace mc
 } // namespace gridtools
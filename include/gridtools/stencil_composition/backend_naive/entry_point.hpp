@@ -26,11 +26,13 @@
 #include "../sid/loop.hpp"
 #include "../sid/sid_shift_origin.hpp"
 #include "../stage_matrix.hpp"
+#include "../stage_meters.hpp"
 
 namespace gridtools {
     namespace naive {
         template <class Spec, class Grid, class DataStores>
         void gridtools_backend_entry_point(backend, Spec, Grid const &grid, DataStores external_data_stores) {
+            computation_meter<Spec> meter;
             auto alloc = sid::make_allocator(&std::make_unique<char[]>);
             using stages_t = stage_matrix::make_split_view<Spec>;
             using tmp_plh_map_t = stage_matrix::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
@@ -55,6 +57,7 @@ namespace gridtools {
             auto origin = sid::get_origin(composite);
             auto strides = sid::get_strides(composite);
             for_each<stages_t>([&](auto stage) {
+                stage_meter<Spec, decltype(stage)> meter;
                 tuple_util::for_each(
                     [&](auto cell) {
                         auto ptr = origin();
@@ -9,73 +9,111 @@
  */
 #pragma once
 
-#include <memory>
+#include <cstddef>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "../../common/defs.hpp"
 #include "../../common/generic_metafunctions/for_each.hpp"
 #include "../../common/host_device.hpp"
 #include "../../common/integral_constant.hpp"
+#include "../../common/stride_util.hpp"
 #include "../../common/tuple.hpp"
 #include "../../common/tuple_util.hpp"
 #include "../../meta.hpp"
+#include "../block_schedule.hpp"
+#include "../caches/host_k_caches.hpp"
 #include "../dim.hpp"
-#include "../sid/allocator.hpp"
-#include "../sid/as_const.hpp"
 #include "../sid/block.hpp"
 #include "../sid/concept.hpp"
-#include "../sid/contiguous.hpp"
 #include "../sid/loop.hpp"
 #include "../sid/sid_shift_origin.hpp"
 #include "../stage_matrix.hpp"
+#include "../stage_meters.hpp"
+#include "tmp_storage_sid.hpp"
 
 namespace gridtools {
     namespace x86 {
 #if defined(__INTEL_COMPILER) && __INTEL_COMPILER < 1900
-        template <class DataStores>
-        struct make_sid_f {
-            DataStores &m_data_stores;
-            template <class PtrInfo>
-            auto operator()(PtrInfo) const {
-                return sid::add_const(PtrInfo::is_const(), at_key<decltype(PtrInfo::plh())>(m_data_stores));
-            }
-        };
-
-        template <class Stage, class Sizes, class ShiftBack>
+        template <class Stage, class Sizes, class KCaches>
         struct k_loop_f {
             Sizes m_sizes;
-            ShiftBack m_shift_back;
+            KCaches m_k_caches;
 
             template <class Ptr, class Strides>
-            GT_FORCE_INLINE void operator()(Ptr &ptr, Strides const &strides) const {
+            GT_FORCE_INLINE void operator()(Ptr const &ptr, Strides const &strides) const {
+                auto k_ptr = ptr;
+                int_t count = 0;
                 tuple_util::for_each(
-                    [&ptr, &strides](auto cell, auto size) {
+                    [&](auto cell, auto size) {
                         for (int_t k = 0; k < size; ++k) {
-                            cell(ptr, strides);
-                            cell.inc_k(ptr, strides);
+                            cell(k_ptr, strides);
+                            cell.inc_k(k_ptr, strides);
+                            m_k_caches.slide(k_ptr, strides, cell.k_step(), count, integral_constant<int_t, 1>());
                         }
                     },
                     Stage::cells(),
                     m_sizes);
-                sid::shift(ptr, sid::get_stride<dim::k>(strides), m_shift_back);
             }
         };
 #endif
 
-        template <class Stage, class Grid, class DataStores>
-        auto make_stage_loop(Stage, Grid const &grid, DataStores &data_stores) {
+        /**
+         * @brief The loops of a stage: `operator()` processes a block, `column` a single column of a block.
+         */
+        template <class Stage, class PtrDiff, class Origin, class Strides, class KLoop>
+        struct stage_loop {
+            using stage_t = Stage;
             using extent_t = typename Stage::extent_t;
 
-            using plh_map_t = typename Stage::plh_map_t;
-            using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
-            auto composite = tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
-#if defined(__INTEL_COMPILER) && __INTEL_COMPILER < 1900
-                make_sid_f<decltype(data_stores)> { data_stores }
-#else
-                [&](auto info) { return sid::add_const(info.is_const(), at_key<decltype(info.plh())>(data_stores)); }
-#endif
-                ,
-                Stage::plh_map()));
+            Origin m_origin;
+            Strides m_strides;
+            KLoop m_k_loop;
+
+            auto block_ptr(int_t i_block, int_t j_block) const {
+                PtrDiff offset{};
+                sid::shift(offset, sid::get_stride<dim::thread>(m_strides), omp_get_thread_num());
+                sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::i>>(m_strides), i_block);
+                sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::j>>(m_strides), j_block);
+                return m_origin() + offset;
+            }
+
+            void operator()(int_t i_block, int_t j_block, int_t i_size, int_t j_size) const {
+                auto ptr = block_ptr(i_block, j_block);
+                auto i_loop = sid::make_loop<dim::i>(extent_t::extend(dim::i(), i_size));
+                auto j_loop = sid::make_loop<dim::j>(extent_t::extend(dim::j(), j_size));
+                i_loop(j_loop(m_k_loop))(ptr, m_strides);
+            }
+
+            /**
+             * @brief Processes the column (i, j) of a block, the indices start at the lower end of the extent.
+             */
+            void column(int_t i_block, int_t j_block, int_t i, int_t j) const {
+                auto ptr = block_ptr(i_block, j_block);
+                sid::shift(ptr, sid::get_stride<dim::i>(m_strides), i);
+                sid::shift(ptr, sid::get_stride<dim::j>(m_strides), j);
+                m_k_loop(ptr, m_strides);
+            }
+        };
+
+        /**
+         * @brief The loop over the blocks of a stage, the rolled k-caches (see `host_k_caches.hpp`) are windows of a
+         * single column.
+         */
+        template <class Items, class Stage, class Grid, class DataStores>
+        auto make_stage_loop(Stage, Grid const &grid, DataStores &data_stores, tmp_arena &arena) {
+            using extent_t = typename Stage::extent_t;
+
+            auto windows = host_k_caches::make_windows<Items>(Stage(), [&](auto info) {
+                auto sizes = tuple_util::make<hymap::keys<dim::k>::values>(host_k_caches::window_size(info));
+                auto offsets = tuple_util::make<hymap::keys<dim::k>::values>(
+                    host_k_caches::window_start(info, Stage::k_step()) -
+                    grid.k_start(Stage::interval(), Stage::execution()));
+                return sid::shift_sid_origin(
+                    make_tmp_storage_x86<decltype(info.data()), decltype(info.key())>(arena, sizes), offsets);
+            });
+            auto composite = host_k_caches::make_composite(Stage(), data_stores, windows);
             using ptr_diff_t = sid::ptr_diff_type<decltype(composite)>;
 
             auto strides = sid::get_strides(composite);
@@ -84,78 +122,154 @@ namespace gridtools {
             sid::shift(offset, sid::get_stride<dim::j>(strides), extent_t::minus(dim::j()));
             sid::shift(offset, sid::get_stride<dim::k>(strides), grid.k_start(Stage::interval(), Stage::execution()));
 
-            auto shift_back = -grid.k_size(Stage::interval()) * Stage::k_step();
             auto k_sizes =
                 tuple_util::transform([&](auto cell) { return grid.k_size(cell.interval()); }, Stage::cells());
+            auto k_caches = host_k_caches::make_k_caches<Items>(Stage());
 #if defined(__INTEL_COMPILER) && __INTEL_COMPILER < 1900
-            k_loop_f<Stage, decltype(k_sizes), decltype(shift_back)> k_loop{std::move(k_sizes), shift_back};
+            k_loop_f<Stage, decltype(k_sizes), decltype(k_caches)> k_loop{std::move(k_sizes), k_caches};
 #else
-            auto k_loop = [k_sizes = std::move(k_sizes), shift_back](auto &ptr, auto const &strides) {
+            auto k_loop = [k_sizes = std::move(k_sizes), k_caches](auto const &ptr, auto const &strides) {
+                auto k_ptr = ptr;
+                int_t count = 0;
                 tuple_util::for_each(
-                    [&ptr, &strides](auto cell, auto size) {
+                    [&](auto cell, auto size) {
                         for (int_t k = 0; k < size; ++k) {
-                            cell(ptr, strides);
-                            cell.inc_k(ptr, strides);
+                            cell(k_ptr, strides);
+                            cell.inc_k(k_ptr, strides);
+                            k_caches.slide(k_ptr, strides, cell.k_step(), count, integral_constant<int_t, 1>());
                         }
                     },
                     Stage::cells(),
                     k_sizes);
-                sid::shift(ptr, sid::get_stride<dim::k>(strides), shift_back);
             };
 #endif
-            return [origin = sid::get_origin(composite) + offset,
-                       strides = std::move(strides),
-                       k_loop = std::move(k_loop)](int_t i_block, int_t j_block, int_t i_size, int_t j_size) {
-                ptr_diff_t offset{};
-                sid::shift(offset, sid::get_stride<dim::thread>(strides), omp_get_thread_num());
-                sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::i>>(strides), i_block);
-                sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::j>>(strides), j_block);
-                auto ptr = origin() + offset;
-                auto i_loop = sid::make_loop<dim::i>(extent_t::extend(dim::i(), i_size));
-                auto j_loop = sid::make_loop<dim::j>(extent_t::extend(dim::j(), j_size));
-                i_loop(j_loop(k_loop))(ptr, strides);
-            };
+            auto origin = sid::get_origin(composite) + offset;
+            return stage_loop<Stage, ptr_diff_t, decltype(origin), decltype(strides), decltype(k_loop)>{
+                std::move(origin), std::move(strides), std::move(k_loop)};
         }
 
-        template <class... Params, class Spec, class Grid, class DataStores>
-        void gridtools_backend_entry_point(
-            backend<Params...>, Spec, Grid const &grid, DataStores external_data_stores) {
-            using i_block_size_t = typename backend<Params...>::i_block_size_t;
-            using j_block_size_t = typename backend<Params...>::j_block_size_t;
+        template <class... Params>
+        tmp_arena make_backend_state(backend<Params...>) {
+            return {};
+        }
+
+        template <class Backend, class Spec, class Grid>
+        auto make_tmp_sizes(Backend, Spec, Grid const &grid) {
             using stages_t = stage_matrix::make_split_view<Spec>;
+            return [&grid](auto info) {
+                auto extent = info.extent();
+                return tuple_util::make<hymap::keys<dim::c, dim::k, dim::j, dim::i>::values>(info.num_colors(),
+                    grid.k_size(stages_t::interval(), extent),
+                    extent.extend(dim::j(), typename Backend::j_block_size_t()),
+                    extent.extend(dim::i(), typename Backend::i_block_size_t()));
+            };
+        }
 
-            auto alloc = sid::make_cached_allocator(&std::make_unique<char[]>);
+        /**
+         * @brief Reserves the arena space for the temporaries of `Spec`, which are indexed by the thread and shared by
+         * all runs within a parallel region, and for the k-cache windows of `runs` runs.
+         */
+        template <class Backend, class Spec, class Grid>
+        void reserve_temporaries(Backend, Spec, Grid const &grid, tmp_arena &arena, std::size_t runs) {
+            using stages_t = stage_matrix::make_split_view<Spec>;
+            auto tmp_sizes = make_tmp_sizes(Backend(), Spec(), grid);
+            for_each<host_k_caches::tmp_plh_map<stages_t, typename stages_t::tmp_plh_map_t>>([&](auto info) {
+                arena.reserve<decltype(info.data())>(stride_util::total_size(tmp_sizes(info)));
+            });
+            for (std::size_t run = 0; run != runs; ++run)
+                for_each<host_k_caches::rolled_plh_map<stages_t, typename stages_t::plh_map_t>>(
+                    [&](auto info) { arena.reserve<decltype(info.data())>(host_k_caches::window_size(info)); });
+        }
 
-            using tmp_plh_map_t = stage_matrix::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
-            auto temporaries = stage_matrix::make_data_stores(tmp_plh_map_t(), [&](auto info) {
+        template <class Backend, class Spec, class Grid>
+        auto make_temporaries(Backend, Spec, Grid const &grid, tmp_arena &arena) {
+            using stages_t = stage_matrix::make_split_view<Spec>;
+            using tmp_plh_map_t = host_k_caches::tmp_plh_map<stages_t, typename stages_t::tmp_plh_map_t>;
+            auto tmp_sizes = make_tmp_sizes(Backend(), Spec(), grid);
+            return stage_matrix::make_data_stores(tmp_plh_map_t(), [&](auto info) {
                 auto extent = info.extent();
                 auto interval = stages_t::interval();
-                auto num_colors = info.num_colors();
                 auto offsets = tuple_util::make<hymap::keys<dim::i, dim::j, dim::k>::values>(
                     -extent.minus(dim::i()), -extent.minus(dim::j()), -grid.k_start(interval) - extent.minus(dim::k()));
-                auto sizes =
-                    tuple_util::make<hymap::keys<dim::c, dim::k, dim::j, dim::i, dim::thread>::values>(num_colors,
-                        grid.k_size(interval, extent),
-                        extent.extend(dim::j(), j_block_size_t()),
-                        extent.extend(dim::i(), i_block_size_t()),
-                        omp_get_max_threads());
-
-                using stride_kind = meta::list<decltype(extent), decltype(num_colors)>;
+                using stride_kind = meta::list<decltype(extent), decltype(info.num_colors())>;
                 return sid::shift_sid_origin(
-                    sid::make_contiguous<decltype(info.data()), int_t, stride_kind>(alloc, sizes), offsets);
+                    make_tmp_storage_x86<decltype(info.data()), stride_kind>(arena, tmp_sizes(info)), offsets);
             });
+        }
+
+        /**
+         * @brief Whether the stages of `Spec` are executed column by column within a block (see
+         * `stage_matrix::can_fuse_columns`), such that a column is still in the cache when the next stage processes it.
+         */
+        template <class Spec, class Stages = stage_matrix::make_split_view<Spec>>
+        using fuse_columns =
+            bool_constant<(meta::length<Stages>::value > 1) && stage_matrix::can_fuse_columns<Stages>::value>;
+
+        template <class Spec, class Loops>
+        auto fuse_stage_loops(std::false_type, Loops loops) {
+            return tuple_util::transform(
+                [](auto &&loop) {
+                    using loop_t = std::decay_t<decltype(loop)>;
+                    return meter_stage<Spec, typename loop_t::stage_t>(std::forward<decltype(loop)>(loop));
+                },
+                std::move(loops));
+        }
+
+        /**
+         * @brief A single loop over the blocks that applies all the stages to a column before it goes to the next.
+         */
+        template <class Spec, class Loops>
+        auto fuse_stage_loops(std::true_type, Loops loops) {
+            using extent_t = typename meta::first<stage_matrix::make_split_view<Spec>>::extent_t;
+            return tuple_util::make<tuple>(
+                [loops = std::move(loops)](int_t i_block, int_t j_block, int_t i_size, int_t j_size) {
+                    int_t i_count = extent_t::extend(dim::i(), i_size);
+                    int_t j_count = extent_t::extend(dim::j(), j_size);
+                    for (int_t i = 0; i < i_count; ++i)
+                        for (int_t j = 0; j < j_count; ++j)
+                            tuple_util::for_each(
+                                [=](auto const &loop) {
+                                    using loop_t = std::decay_t<decltype(loop)>;
+                                    stage_meter<Spec, typename loop_t::stage_t> meter;
+                                    loop.column(i_block, j_block, i, j);
+                                },
+                                loops);
+                });
+        }
+
+        template <class Backend, class Spec, class Grid, class DataStores, class Temporaries>
+        auto make_stage_loops(Backend,
+            Spec,
+            Grid const &grid,
+            DataStores external_data_stores,
+            Temporaries temporaries,
+            tmp_arena &arena) {
+            using stages_t = stage_matrix::make_split_view<Spec>;
 
             auto blocked_external_data_stores = tuple_util::transform(
                 [&](auto &&data_store) {
                     return sid::block(std::forward<decltype(data_store)>(data_store),
-                        hymap::keys<dim::i, dim::j>::values<i_block_size_t, j_block_size_t>());
+                        hymap::keys<dim::i, dim::j>::values<typename Backend::i_block_size_t,
+                            typename Backend::j_block_size_t>());
                 },
                 std::move(external_data_stores));
 
             auto data_stores = hymap::concat(std::move(blocked_external_data_stores), std::move(temporaries));
 
-            auto stage_loops = tuple_util::transform(
-                [&](auto stage) { return make_stage_loop(stage, grid, data_stores); }, meta::rename<tuple, stages_t>());
+            auto loops = tuple_util::transform(
+                [&](auto stage) { return make_stage_loop<stages_t>(stage, grid, data_stores, arena); },
+                meta::rename<tuple, stages_t>());
+            return fuse_stage_loops<Spec>(fuse_columns<Spec>(), std::move(loops));
+        }
+
+        /**
+         * @brief Calls `fun(chunk, bi, bj, i_size, j_size)` for the `chunks` chunks of all blocks, the blocks of a
+         * chunk are neighbouring work items.
+         */
+        template <class Backend, class Grid, class Fun>
+        void run_blocks(Backend, Grid const &grid, int_t chunks, Fun const &fun) {
+            using i_block_size_t = typename Backend::i_block_size_t;
+            using j_block_size_t = typename Backend::j_block_size_t;
 
             int_t total_i = grid.i_size();
             int_t total_j = grid.j_size();
@@ -163,14 +277,79 @@ namespace gridtools {
             int_t NBI = (total_i + i_block_size_t::value - 1) / i_block_size_t::value;
             int_t NBJ = (total_j + j_block_size_t::value - 1) / j_block_size_t::value;
 
-#pragma omp parallel for collapse(2)
-            for (int_t bi = 0; bi < NBI; ++bi) {
-                for (int_t bj = 0; bj < NBJ; ++bj) {
-                    int_t i_size = bi + 1 == NBI ? total_i - bi * i_block_size_t::value : i_block_size_t::value;
-                    int_t j_size = bj + 1 == NBJ ? total_j - bj * j_block_size_t::value : j_block_size_t::value;
-                    tuple_util::for_each([=](auto &&fun) { fun(bi, bj, i_size, j_size); }, stage_loops);
-                }
-            }
+            parallel_for_blocks(typename Backend::schedule_t(), NBI * NBJ * chunks, [&](int_t index) {
+                int_t chunk = index / (NBI * NBJ);
+                int_t block = index % (NBI * NBJ);
+                int_t bi = block / NBJ;
+                int_t bj = block % NBJ;
+                int_t i_size = bi + 1 == NBI ? total_i - bi * i_block_size_t::value : i_block_size_t::value;
+                int_t j_size = bj + 1 == NBJ ? total_j - bj * j_block_size_t::value : j_block_size_t::value;
+                fun(chunk, bi, bj, i_size, j_size);
+            });
+        }
+
+        template <class... Params, class Spec, class Grid, class DataStores>
+        void gridtools_backend_entry_point(
+            backend<Params...> be, Spec, Grid const &grid, DataStores external_data_stores, tmp_arena &arena) {
+            computation_meter<Spec> meter;
+            arena.reset();
+            reserve_temporaries(be, Spec(), grid, arena, 1);
+            arena.commit();
+
+            auto temporaries = make_temporaries(be, Spec(), grid, arena);
+            auto stage_loops =
+                make_stage_loops(be, Spec(), grid, std::move(external_data_stores), std::move(temporaries), arena);
+
+            run_blocks(be, grid, 1, [&](int_t, int_t bi, int_t bj, int_t i_size, int_t j_size) {
+                tuple_util::for_each([=](auto &&fun) { fun(bi, bj, i_size, j_size); }, stage_loops);
+            });
+        }
+
+        /**
+         * @brief Runs all chunks within a single parallel region, the work items are pairs of a block and a chunk.
+         */
+        template <class... Params, class Specs, class Grid, class Chunks>
+        void gridtools_backend_chunked_entry_point(
+            backend<Params...> be, Specs, Grid const &grid, Chunks chunks, tmp_arena &arena) {
+            using specs_t = meta::rename<tuple, Specs>;
+            computation_meter<meta::first<Specs>> meter;
+
+            arena.reset();
+            tuple_util::for_each(
+                [&](auto spec, auto const &data_stores) {
+                    reserve_temporaries(be, spec, grid, arena, data_stores.size());
+                },
+                specs_t(),
+                chunks);
+            arena.commit();
+
+            auto loops = tuple_util::transform(
+                [&](auto spec, auto &data_stores) {
+                    auto temporaries = make_temporaries(be, spec, grid, arena);
+                    std::vector<decltype(make_stage_loops(be, spec, grid, std::move(data_stores[0]), temporaries, arena))>
+                        res;
+                    res.reserve(data_stores.size());
+                    for (auto &chunk : data_stores)
+                        res.push_back(make_stage_loops(be, spec, grid, std::move(chunk), temporaries, arena));
+                    return res;
+                },
+                specs_t(),
+                chunks);
+
+            int_t total = 0;
+            tuple_util::for_each([&](auto const &stage_loops) { total += stage_loops.size(); }, loops);
+            if (total == 0)
+                return;
+            run_blocks(be, grid, total, [&](int_t chunk, int_t bi, int_t bj, int_t i_size, int_t j_size) {
+                tuple_util::for_each(
+                    [&](auto const &stage_loops) {
+                        if (chunk >= 0 && chunk < (int_t)stage_loops.size())
+                            tuple_util::for_each(
+                                [=](auto const &fun) { fun(bi, bj, i_size, j_size); }, stage_loops[chunk]);
+                        chunk -= stage_loops.size();
+                    },
+                    loops);
+            });
         }
     } // namespace x86
 } // namespace gridtools
@@ -0,0 +1,156 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#include "../../common/defs.hpp"
+#include "../../common/hymap.hpp"
+#include "../../common/stride_util.hpp"
+#include "../../common/tuple_util.hpp"
+#include "../../meta.hpp"
+#include "../dim.hpp"
+#include "../sid/concept.hpp"
+#include "../sid/simple_ptr_holder.hpp"
+#include "../sid/synthetic.hpp"
+
+namespace gridtools {
+    namespace x86 {
+        namespace _impl_tmp_x86 {
+            using byte_alignment = std::integral_constant<std::size_t, 64>;
+            using page_size = std::integral_constant<std::size_t, 4096>;
+
+            inline std::size_t round_up(std::size_t size, std::size_t alignment) {
+                return (size + alignment - 1) / alignment * alignment;
+            }
+
+            inline std::size_t lcm(std::size_t a, std::size_t b) {
+                std::size_t x = a, y = b;
+                while (y) {
+                    std::size_t tmp = x % y;
+                    x = y;
+                    y = tmp;
+                }
+                return a / x * b;
+            }
+
+            struct free_f {
+                void operator()(char *ptr) const { std::free(ptr); }
+            };
+        } // namespace _impl_tmp_x86
+
+        /**
+         * @brief Storage for the temporaries of a computation that is kept alive between its runs.
+         *
+         * The arena holds one page aligned slab per OpenMP thread. Each slab is first touched by the thread that
+         * owns it, so on NUMA systems the pages end up close to the core that works on them. The memory is
+         * reallocated only if a run needs more of it than the previous ones, in the steady state no allocation
+         * happens.
+         *
+         * Usage within a run: `reset`, `reserve` every temporary, `commit`, `allocate` every temporary.
+         * The pointer returned by `allocate` points into the slab of the thread zero, the slab of the thread `t` is
+         * located `t * slab_size()` bytes further.
+         *
+         * Copies of the arena don't share resources with the original: the copy starts empty.
+         */
+        class tmp_arena {
+            int m_threads = 0;
+            std::size_t m_slab_size = 0;
+            std::size_t m_requested = 0;
+            std::size_t m_granularity = _impl_tmp_x86::page_size::value;
+            std::size_t m_used = 0;
+            std::unique_ptr<char, _impl_tmp_x86::free_f> m_data;
+
+            template <class T>
+            static std::size_t aligned_size(std::size_t size) {
+                return _impl_tmp_x86::round_up(size * sizeof(T), _impl_tmp_x86::byte_alignment::value);
+            }
+
+          public:
+            tmp_arena() = default;
+            tmp_arena(tmp_arena &&) = default;
+            tmp_arena &operator=(tmp_arena &&) = default;
+            tmp_arena(tmp_arena const &) {}
+            tmp_arena &operator=(tmp_arena const &) { return *this; }
+
+            void reset() {
+                m_requested = 0;
+                m_granularity = _impl_tmp_x86::page_size::value;
+                m_used = 0;
+            }
+
+            /**
+             * @brief Accounts for `size` elements of type `T` that are going to be allocated after `commit`.
+             */
+            template <class T>
+            void reserve(std::size_t size) {
+                m_requested += aligned_size<T>(size);
+                // the slab size should be a multiple of the element size to express it as a stride
+                m_granularity = _impl_tmp_x86::lcm(m_granularity, sizeof(T));
+            }
+
+            /**
+             * @brief Makes sure that the slabs are large enough for the reserved temporaries.
+             */
+            void commit() {
+                int threads = omp_get_max_threads();
+                if (m_requested == 0 ||
+                    (threads <= m_threads && m_requested <= m_slab_size && m_slab_size % m_granularity == 0))
+                    return;
+                m_slab_size = _impl_tmp_x86::round_up(m_requested, m_granularity);
+                m_threads = threads;
+                m_data.reset();
+                void *ptr;
+                if (posix_memalign(&ptr, _impl_tmp_x86::page_size::value, m_slab_size * m_threads))
+                    throw std::bad_alloc();
+                m_data.reset(static_cast<char *>(ptr));
+                char *data = m_data.get();
+                std::size_t size = m_slab_size;
+#pragma omp parallel for schedule(static, 1)
+                for (int t = 0; t < threads; ++t)
+                    std::memset(data + t * size, 0, size);
+            }
+
+            template <class T>
+            T *allocate(std::size_t size) {
+                char *res = m_data.get() + m_used;
+                m_used += aligned_size<T>(size);
+                assert(m_used <= m_slab_size);
+                assert(m_slab_size % sizeof(T) == 0);
+                return reinterpret_cast<T *>(res);
+            }
+
+            std::size_t slab_size() const { return m_slab_size; }
+        };
+
+        /**
+         * @brief Makes a per thread temporary with the given sizes within the arena.
+         *
+         * Dimensions are laid out in the order of `sizes` (the first one is contiguous), `dim::thread` selects the slab.
+         */
+        template <class T, class StridesKind, class Sizes>
+        auto make_tmp_storage_x86(tmp_arena &arena, Sizes const &sizes) {
+            auto thread_stride = tuple_util::make<hymap::keys<dim::thread>::values>(
+                static_cast<int_t>(arena.slab_size() / sizeof(T)));
+            return sid::synthetic()
+                .set<sid::property::origin>(
+                    sid::make_simple_ptr_holder(arena.allocate<T>(stride_util::total_size(sizes))))
+                .template set<sid::property::strides>(
+                    hymap::concat(stride_util::make_strides_from_sizes(sizes), std::move(thread_stride)))
+                .template set<sid::property::strides_kind,
+                    meta::list<StridesKind, std::integral_constant<std::size_t, sizeof(T)>>>()
+                .template set<sid::property::ptr_diff, int_t>();
+        }
+    } // namespace x86
+} // namespace gridtools
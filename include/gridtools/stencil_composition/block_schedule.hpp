@@ -0,0 +1,142 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "../common/defs.hpp"
+
+namespace gridtools {
+    namespace block_schedule_impl_ {
+        constexpr std::size_t cache_line_size = 64;
+
+        /**
+         * @brief A range of block indices that is shared between its owner and the thieves.
+         *
+         * Both bounds are packed into a single atomic word, so the owner (taking blocks from the front) and the
+         * thieves (taking the back half) synchronize with a single compare and swap. Each range occupies a cache
+         * line of its own.
+         */
+        struct shared_range {
+            std::atomic<std::uint64_t> m_value;
+            char m_padding[cache_line_size - sizeof(std::atomic<std::uint64_t>)];
+
+            static std::uint64_t pack(std::uint32_t begin, std::uint32_t end) {
+                return std::uint64_t(begin) << 32 | end;
+            }
+            static std::uint32_t begin(std::uint64_t value) { return value >> 32; }
+            static std::uint32_t end(std::uint64_t value) { return value & 0xffffffff; }
+
+            /** @brief Takes the first block of the range, returns false if the range is empty. */
+            bool pop_front(std::uint32_t &block) {
+                std::uint64_t cur = m_value.load();
+                while (begin(cur) < end(cur)) {
+                    if (m_value.compare_exchange_weak(cur, pack(begin(cur) + 1, end(cur)))) {
+                        block = begin(cur);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /** @brief Takes the back half of the range, returns false if the range is empty. */
+            bool steal(std::uint64_t &stolen) {
+                std::uint64_t cur = m_value.load();
+                while (begin(cur) < end(cur)) {
+                    std::uint32_t mid = end(cur) - (end(cur) - begin(cur) + 1) / 2;
+                    if (m_value.compare_exchange_weak(cur, pack(begin(cur), mid))) {
+                        stolen = pack(mid, end(cur));
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+
+        GT_STATIC_ASSERT(sizeof(shared_range) == cache_line_size, GT_INTERNAL_ERROR);
+        GT_STATIC_ASSERT(std::is_trivially_destructible<shared_range>::value, GT_INTERNAL_ERROR);
+
+        /**
+         * @brief An array of shared ranges that starts at a cache line boundary, such that every range has a cache
+         * line of its own. The storage of a `std::vector` is not aligned beyond `alignof(std::max_align_t)` in C++14.
+         */
+        class shared_ranges {
+            std::unique_ptr<char[]> m_buffer;
+            shared_range *m_ranges;
+
+          public:
+            explicit shared_ranges(std::size_t size) : m_buffer(new char[(size + 1) * cache_line_size]) {
+                auto address = reinterpret_cast<std::uintptr_t>(m_buffer.get());
+                m_ranges = reinterpret_cast<shared_range *>(
+                    (address + cache_line_size - 1) / cache_line_size * cache_line_size);
+                for (std::size_t i = 0; i != size; ++i)
+                    new (m_ranges + i) shared_range();
+            }
+
+            shared_range &operator[](std::size_t i) { return m_ranges[i]; }
+        };
+
+        /**
+         * @brief Calls `fun(block)` for all blocks in [0, size), the blocks are distributed to the threads in the
+         * same way as by `#pragma omp for schedule(static)`.
+         */
+        template <class Fun>
+        void parallel_for_blocks(schedule::static_, int_t size, Fun const &fun) {
+#pragma omp parallel for schedule(static)
+            for (int_t block = 0; block < size; ++block)
+                fun(block);
+        }
+
+        template <class Fun>
+        void parallel_for_blocks(schedule::guided, int_t size, Fun const &fun) {
+#pragma omp parallel for schedule(guided)
+            for (int_t block = 0; block < size; ++block)
+                fun(block);
+        }
+
+        /**
+         * Every thread starts with the contiguous range of blocks it would get with the static schedule. A thread
+         * that has finished its range steals the back half of the range of another thread, starting with its
+         * neighbours.
+         */
+        template <class Fun>
+        void parallel_for_blocks(schedule::work_stealing, int_t size, Fun const &fun) {
+            shared_ranges ranges(omp_get_max_threads());
+#pragma omp parallel
+            {
+                int_t threads = omp_get_num_threads();
+                int_t thread = omp_get_thread_num();
+                auto &own = ranges[thread].m_value;
+                own.store(shared_range::pack(std::int64_t(size) * thread / threads,
+                    std::int64_t(size) * (thread + 1) / threads));
+#pragma omp barrier
+                std::uint32_t block;
+                bool has_work = true;
+                while (has_work) {
+                    while (ranges[thread].pop_front(block))
+                        fun(block);
+                    has_work = false;
+                    std::uint64_t stolen;
+                    for (int_t offset = 1; offset < threads && !has_work; ++offset)
+                        if (ranges[(thread + offset) % threads].steal(stolen)) {
+                            own.store(stolen);
+                            has_work = true;
+                        }
+                }
+            }
+        }
+    } // namespace block_schedule_impl_
+    using block_schedule_impl_::parallel_for_blocks;
+} // namespace gridtools
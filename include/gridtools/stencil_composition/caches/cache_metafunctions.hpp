@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "../../common/integral_constant.hpp"
 #include "../../meta.hpp"
 #include "./cache.hpp"
 #include "./cache_traits.hpp"
@@ -24,4 +25,30 @@ namespace gridtools {
 
     template <class Caches>
     using ij_cache_args = meta::transform<cache_parameter, ij_caches<Caches>>;
+
+    /**
+     *  Whether a `plh_info` of the stage matrix is ij-cached.
+     */
+    template <class PlhInfo>
+    using is_ij_cached = meta::st_contains<typename PlhInfo::caches_t, integral_constant<cache_type, cache_type::ij>>;
+
+    namespace cache_metafunctions_impl_ {
+        template <class PlhInfo>
+        using get_plh = typename PlhInfo::plh_t;
+
+        template <class Plhs>
+        struct is_not_contained_f {
+            template <class Plh>
+            using apply = bool_constant<!meta::st_contains<Plhs, Plh>::value>;
+        };
+    } // namespace cache_metafunctions_impl_
+
+    /**
+     *  The placeholders of the `plh_info` map `PlhMap` which are ij-cached wherever they are accessed.
+     */
+    template <class PlhMap,
+        class Uncached = meta::transform<cache_metafunctions_impl_::get_plh,
+            meta::filter<meta::not_<is_ij_cached>::apply, PlhMap>>>
+    using ij_cached_plhs = meta::filter<cache_metafunctions_impl_::is_not_contained_f<Uncached>::template apply,
+        meta::dedup<meta::transform<cache_metafunctions_impl_::get_plh, meta::filter<is_ij_cached, PlhMap>>>>;
 } // namespace gridtools
@@ -0,0 +1,207 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "../../common/defs.hpp"
+#include "../../common/generic_metafunctions/for_each.hpp"
+#include "../../common/hymap.hpp"
+#include "../../common/integral_constant.hpp"
+#include "../../common/tuple.hpp"
+#include "../../common/tuple_util.hpp"
+#include "../../meta.hpp"
+#include "../dim.hpp"
+#include "../execution_types.hpp"
+#include "../sid/as_const.hpp"
+#include "../sid/composite.hpp"
+#include "../sid/concept.hpp"
+#include "../stage_matrix.hpp"
+#include "cache_definitions.hpp"
+
+/**
+ *  @file
+ *  k-caches for the host backends.
+ *
+ *  A local k-cache of a placeholder that is accessed only along k and by a single k-serial item of the split view is
+ *  "rolled": within the item the placeholder lives in a small per thread window of k-levels instead of main memory, a
+ *  temporary which is only accessed this way is not allocated at all. The backend allocates the windows and chooses
+ *  their strides along the other dimensions, a window holds a single column on x86 and a k-plane of the block along
+ *  i on mc.
+ *
+ *  The window is a ring of `kplus - kminus + period` levels: the pointer to it moves along k as the pointers to the
+ *  fields do and every `period` levels the content of the window is copied back to its start.
+ *
+ *  Filled and flushed k-caches are accessed in main memory: on a CPU the accessed levels are in the hardware caches
+ *  anyway and copying them into and out of a window is more expensive than accessing them in place.
+ */
+
+namespace gridtools {
+    namespace host_k_caches {
+        namespace impl_ {
+            /**
+             *  The number of levels between two rotations of the windows.
+             */
+            using period_t = integral_constant<int_t, 8>;
+
+            template <class PlhInfo>
+            using is_local_k_cached = conjunction<
+                std::is_same<typename PlhInfo::caches_t, meta::list<integral_constant<cache_type, cache_type::k>>>,
+                bool_constant<meta::length<typename PlhInfo::cache_io_policies_t>::value == 0>>;
+
+            template <class Extent>
+            using is_vertical = bool_constant<Extent::iminus::value == 0 && Extent::iplus::value == 0 &&
+                                              Extent::jminus::value == 0 && Extent::jplus::value == 0>;
+
+            template <class Key>
+            struct uses_key_f {
+                template <class Item>
+                using apply = meta::st_contains<meta::transform<stage_matrix::get_key, typename Item::plh_map_t>, Key>;
+            };
+
+            template <class Users>
+            struct is_single_serial_user : std::false_type {};
+
+            template <class Item>
+            struct is_single_serial_user<meta::list<Item>>
+                : negation<execute::is_parallel<typename Item::execution_t>> {};
+
+            template <class Items>
+            struct is_rolled_f {
+                template <class PlhInfo>
+                using apply = conjunction<is_local_k_cached<PlhInfo>,
+                    is_vertical<typename PlhInfo::extent_t>,
+                    is_single_serial_user<meta::filter<uses_key_f<typename PlhInfo::key_t>::template apply,
+                        meta::rename<meta::list, Items>>>>;
+            };
+
+            template <class Items>
+            struct is_not_rolled_f {
+                template <class PlhInfo>
+                using apply = negation<typename is_rolled_f<Items>::template apply<PlhInfo>>;
+            };
+
+            template <class DataStores, class Windows>
+            struct make_sid_f {
+                DataStores &m_data_stores;
+                Windows &m_windows;
+
+                template <class PlhInfo,
+                    class Key = typename PlhInfo::key_t,
+                    std::enable_if_t<has_key<Windows, Key>::value, int> = 0>
+                auto operator()(PlhInfo) const {
+                    return at_key<Key>(m_windows);
+                }
+
+                template <class PlhInfo,
+                    class Key = typename PlhInfo::key_t,
+                    std::enable_if_t<!has_key<Windows, Key>::value, int> = 0>
+                auto operator()(PlhInfo info) const {
+                    return sid::add_const(info.is_const(), at_key<typename PlhInfo::plh_t>(m_data_stores));
+                }
+            };
+
+            template <class Key, class Ptr, class Strides>
+            GT_FORCE_INLINE auto shifted(Ptr const &ptr, Strides const &strides, int_t offset) {
+                auto res = at_key<Key>(ptr);
+                sid::shift(res, sid::get_stride_element<Key, dim::k>(strides), offset);
+                return res;
+            }
+
+            template <class PlhMap>
+            struct k_caches {
+                /**
+                 *  Has to be called after `inc_k`, `count` is the number of levels since the last rotation.
+                 */
+                template <class Ptr, class Strides, class Step, class ISize>
+                GT_FORCE_INLINE void slide(Ptr &ptr, Strides const &strides, Step, int_t &count, ISize i_size) const {
+                    using namespace literals;
+                    if (++count < period_t::value)
+                        return;
+                    count = 0;
+                    for_each<PlhMap>([&](auto info) {
+                        using key_t = typename decltype(info)::key_t;
+                        using extent_t = typename decltype(info)::extent_t;
+                        // all the levels but the one that enters the window may hold data
+                        constexpr int_t size = extent_t::kplus::value - extent_t::kminus::value;
+                        constexpr int_t shift = period_t::value * Step::value;
+                        auto const &i_stride = sid::get_stride_element<key_t, dim::i>(strides);
+                        sid::shift(at_key<key_t>(ptr), sid::get_stride_element<key_t, dim::k>(strides), -shift);
+                        for (int_t n = 0; n < size; ++n) {
+                            int_t offset = Step::value > 0 ? extent_t::kminus::value + n : extent_t::kplus::value - n;
+                            auto dst = shifted<key_t>(ptr, strides, offset);
+                            auto src = shifted<key_t>(ptr, strides, offset + shift);
+                            for (int_t i = 0; i < i_size; ++i) {
+                                *dst = *src;
+                                sid::shift(dst, i_stride, 1_c);
+                                sid::shift(src, i_stride, 1_c);
+                            }
+                        }
+                    });
+                }
+            };
+        } // namespace impl_
+
+        /**
+         *  The placeholders of `PlhMap` that are rolled if the k-serial items `Items` are executed column by column.
+         */
+        template <class Items, class PlhMap>
+        using rolled_plh_map = meta::filter<impl_::is_rolled_f<Items>::template apply, PlhMap>;
+
+        /**
+         *  The temporaries that have to be allocated in main memory, without caches.
+         */
+        template <class Items, class PlhMap>
+        using tmp_plh_map = stage_matrix::remove_caches_from_plh_map<
+            meta::filter<impl_::is_not_rolled_f<Items>::template apply, PlhMap>>;
+
+        /**
+         *  The number of k-levels of the window of a rolled placeholder.
+         */
+        template <class PlhInfo, class Extent = typename PlhInfo::extent_t>
+        constexpr int_t window_size(PlhInfo) {
+            return Extent::kplus::value - Extent::kminus::value + impl_::period_t::value;
+        }
+
+        /**
+         *  The level of the window of a rolled placeholder that holds the first level of a column.
+         */
+        template <class PlhInfo, class Step, class Extent = typename PlhInfo::extent_t>
+        constexpr int_t window_start(PlhInfo, Step) {
+            return Step::value > 0 ? -Extent::kminus::value : impl_::period_t::value - 1 - Extent::kminus::value;
+        }
+
+        /**
+         *  The windows of the rolled placeholders of `Item`, made by `fun` from their `plh_info`'s.
+         */
+        template <class Items, class Item, class Fun>
+        auto make_windows(Item, Fun &&fun) {
+            return stage_matrix::make_data_stores<stage_matrix::get_key>(
+                rolled_plh_map<Items, typename Item::plh_map_t>(), std::forward<Fun>(fun));
+        }
+
+        /**
+         *  A composite of the placeholders of `Item`, the windows are used for the rolled ones.
+         */
+        template <class Item, class DataStores, class Windows>
+        auto make_composite(Item, DataStores &data_stores, Windows &windows) {
+            using plh_map_t = typename Item::plh_map_t;
+            using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
+            return tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
+                impl_::make_sid_f<DataStores, Windows>{data_stores, windows}, meta::rename<tuple, plh_map_t>()));
+        }
+
+        template <class Items, class Item>
+        impl_::k_caches<rolled_plh_map<Items, typename Item::plh_map_t>> make_k_caches(Item) {
+            return {};
+        }
+    } // namespace host_k_caches
+} // namespace gridtools
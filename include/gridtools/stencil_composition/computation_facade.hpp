@@ -28,6 +28,7 @@
 #include "extract_placeholders.hpp"
 #include "mss.hpp"
 #include "positional.hpp"
+#include "roofline.hpp"
 #include "sid/composite.hpp"
 
 namespace gridtools {
@@ -89,6 +90,7 @@ namespace gridtools {
             using extent_map_t = get_extent_map_from_msses<MssDescriptors>;
 
             Meter m_meter;
+            EntryPoint m_entry_point;
 
             Grid m_grid;
             BoundArgStoragePairs m_bound_data_stores;
@@ -120,15 +122,29 @@ namespace gridtools {
                 GT_STATIC_ASSERT(
                     meta::is_set_fast<meta::list<Plhs...>>::value, "free placeholders should be all different");
                 m_meter.start();
-                EntryPoint()(m_grid, data_store_map(std::move(srcs)...));
+                m_entry_point(m_grid, data_store_map(std::move(srcs)...));
                 m_meter.pause();
             }
 
+            Grid const &grid() const { return m_grid; }
+            BoundArgStoragePairs const &bound_data_stores() const { return m_bound_data_stores; }
+
             std::string print_meter() const { return m_meter.to_string(); }
             double get_time() const { return m_meter.total_time(); }
             size_t get_count() const { return m_meter.count(); }
             void reset_meter() { m_meter.reset(); }
 
+            /**
+             *  The achieved bandwidth of the measured runs, see `roofline.hpp`.
+             */
+            roofline_report get_roofline() const { return {m_entry_point.traffic(), get_time(), get_count()}; }
+            std::string print_roofline(double peak = peak_bandwidth()) const { return get_roofline().to_string(peak); }
+
+            /**
+             *  The peak memory bandwidth [GB/s] of the backend, see `roofline.hpp`.
+             */
+            static double peak_bandwidth() { return EntryPoint::peak_bandwidth(); }
+
             template <class Plh,
                 class RwPlhs = all_rw_args<MssDescriptors>,
                 intent Intent = meta::st_contains<RwPlhs, Plh>::value ? intent::inout : intent::in>
@@ -0,0 +1,430 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../common/defs.hpp"
+#include "../common/tuple_util.hpp"
+#include "../meta.hpp"
+#include "accessor_intent.hpp"
+#include "arg.hpp"
+#include "backend.hpp"
+#include "caches/cache.hpp"
+#include "caches/cache_traits.hpp"
+#include "computation_facade.hpp"
+#include "compute_extents_metafunctions.hpp"
+#include "esf_metafunctions.hpp"
+#include "extent.hpp"
+#include "extract_placeholders.hpp"
+#include "mss.hpp"
+#include "roofline.hpp"
+
+/**
+ *  @file
+ *  Fusion of computations that run back to back on the same grid.
+ *
+ *  `make_computation_sequence` takes the results of several `make_computation` calls and returns an object that runs
+ *  them in the given order. Consecutive computations are fused into a single backend computation, as if all their
+ *  multi-stages were passed to one `make_computation`, unless this would change the values that end up in the fields:
+ *  a computation is not fused with the previous ones if it reads a field written by them at a larger extent than they
+ *  do, if it writes a field that they read with horizontal offsets or if a field written by one side is accessed with
+ *  vertical offsets by the other. Within a fused computation, consecutive multi-stages with the same execution policy
+ *  are merged into one, if no field written by one of them is accessed with vertical offsets by the other, so that
+ *  their stages end up in a single stage matrix.
+ *
+ *  The placeholders passed to `intermediates(...)` are fields that are produced and consumed inside the sequence
+ *  only. They are demoted to temporaries and no data store is assigned to them.
+ */
+
+namespace gridtools {
+    namespace computation_sequence_impl_ {
+        using computation_facade_impl_::all_rw_args;
+        using computation_facade_impl_::computation_facade;
+
+        template <class... Plhs>
+        struct intermediates_t {
+            GT_STATIC_ASSERT((conjunction<is_plh<Plhs>...>::value), "intermediates should be placeholders");
+            GT_STATIC_ASSERT((conjunction<negation<is_tmp_arg<Plhs>>...>::value),
+                "temporaries can not be intermediates, they are not visible outside of a computation anyway");
+        };
+
+        template <class>
+        struct is_intermediates : std::false_type {};
+
+        template <class... Plhs>
+        struct is_intermediates<intermediates_t<Plhs...>> : std::true_type {};
+
+        // the tags of the placeholders inside of a sequence: the temporaries of the `I`th computation and the
+        // demoted intermediates
+        template <class I, class Tag>
+        struct local_tag;
+
+        template <class Tag>
+        struct intermediate_tag;
+
+        template <class Plh>
+        using is_intermediate = meta::is_instantiation_of<intermediate_tag, typename Plh::tag_t>;
+
+        namespace lazy {
+            template <class I, class Intermediates, class Plh, bool = meta::st_contains<Intermediates, Plh>::value>
+            struct convert_plh {
+                using type = Plh;
+            };
+
+            template <class I, class Intermediates, class Tag, class Data, class Location>
+            struct convert_plh<I, Intermediates, tmp_plh<Tag, Data, Location>, false> {
+                using type = tmp_plh<local_tag<I, Tag>, Data, Location>;
+            };
+
+            template <class I, class Intermediates, class Tag, class DataStore, class Location>
+            struct convert_plh<I, Intermediates, plh<Tag, DataStore, Location>, true> {
+                using type =
+                    tmp_plh<intermediate_tag<Tag>, typename _impl::tmp_data_type<DataStore>::type, Location>;
+            };
+
+            template <class I, class Intermediates, class Cache>
+            struct convert_cache;
+
+            template <class I, class Intermediates, cache_type CacheType, class Plh, cache_io_policy CacheIOPolicy>
+            struct convert_cache<I, Intermediates, detail::cache_impl<CacheType, Plh, CacheIOPolicy>> {
+                using type = detail::cache_impl<CacheType, typename convert_plh<I, Intermediates, Plh>::type,
+                    CacheIOPolicy>;
+            };
+        } // namespace lazy
+        GT_META_DELEGATE_TO_LAZY(convert_plh, (class I, class Intermediates, class Plh), (I, Intermediates, Plh));
+        GT_META_DELEGATE_TO_LAZY(
+            convert_cache, (class I, class Intermediates, class Cache), (I, Intermediates, Cache));
+
+        template <class I, class Intermediates>
+        struct convert_f {
+            template <class Plh>
+            using placeholder = convert_plh<I, Intermediates, Plh>;
+
+            template <class Cache>
+            using cache = convert_cache<I, Intermediates, Cache>;
+
+            template <class Esf>
+            using esf = esf_replace_args<Esf, meta::transform<placeholder, typename Esf::args_t>>;
+
+            template <class Mss>
+            using mss = mss_descriptor<typename Mss::execution_engine_t,
+                meta::transform<esf, typename Mss::esf_sequence_t>,
+                meta::transform<cache, typename Mss::cache_sequence_t>>;
+        };
+
+        template <class Plhs>
+        struct is_contained_f {
+            template <class Plh>
+            using apply = meta::st_contains<Plhs, Plh>;
+        };
+
+        template <class Plhs>
+        struct is_not_contained_f {
+            template <class Plh>
+            using apply = negation<meta::st_contains<Plhs, Plh>>;
+        };
+
+        template <class ExtentMap>
+        struct has_k_extent_f {
+            template <class Plh, class Extent = lookup_extent_map<ExtentMap, Plh>>
+            using apply = bool_constant<Extent::kminus::value != 0 || Extent::kplus::value != 0>;
+        };
+
+        template <class ExtentMap>
+        struct has_horizontal_extent_f {
+            template <class Plh>
+            using apply = negation<std::is_same<to_horizontal_extent<lookup_extent_map<ExtentMap, Plh>>, extent<>>>;
+        };
+
+        template <class ExtentMap, class OtherExtentMap>
+        struct has_same_horizontal_extent_f {
+            template <class Plh>
+            using apply = std::is_same<to_horizontal_extent<lookup_extent_map<ExtentMap, Plh>>,
+                to_horizontal_extent<lookup_extent_map<OtherExtentMap, Plh>>>;
+        };
+
+        template <class Mss>
+        using get_cached_plhs = meta::transform<cache_parameter, typename Mss::cache_sequence_t>;
+
+        template <class Mss>
+        using get_written_plhs = compute_readwrite_args<typename Mss::esf_sequence_t>;
+
+        template <class... Msses>
+        using merge_msses = mss_descriptor<typename meta::first<meta::list<Msses...>>::execution_engine_t,
+            meta::concat<typename Msses::esf_sequence_t...>,
+            meta::concat<typename Msses::cache_sequence_t...>>;
+
+        /**
+         *  Two multi-stages can be merged if they have the same execution policy, none of them caches a placeholder
+         *  that is accessed by the other one and the fields written by one of them are not accessed with vertical
+         *  offsets by the other one.
+         */
+        template <class Mss,
+            class Next,
+            class MssPlhs = extract_placeholders_from_mss<Mss>,
+            class NextPlhs = extract_placeholders_from_mss<Next>,
+            class MssMap = get_extent_map_from_mss<Mss>,
+            class NextMap = get_extent_map_from_mss<Next>>
+        using can_merge_mss = bool_constant<
+            std::is_same<typename Mss::execution_engine_t, typename Next::execution_engine_t>::value &&
+            !meta::any_of<is_contained_f<NextPlhs>::template apply, get_cached_plhs<Mss>>::value &&
+            !meta::any_of<is_contained_f<MssPlhs>::template apply, get_cached_plhs<Next>>::value &&
+            !meta::any_of<has_k_extent_f<NextMap>::template apply, get_written_plhs<Mss>>::value &&
+            !meta::any_of<has_k_extent_f<MssMap>::template apply, get_written_plhs<Next>>::value>;
+
+        template <class Next, class... Msses>
+        struct can_merge_msses : can_merge_mss<merge_msses<Msses...>, Next> {};
+
+        template <class Msses>
+        using merge_adjacent_msses = meta::group<can_merge_msses, merge_msses, Msses>;
+
+        /**
+         *  A computation can be fused with the preceding ones if the fields they write are not needed at a larger
+         *  extent (otherwise more of their halos would be overwritten) and if the fields it writes are accessed at
+         *  the compute domain only (otherwise blocks could read values that another block has already overwritten).
+         *  The temporaries (including the intermediates) are not fields.
+         *  Furthermore, no placeholder written by one side may be accessed with vertical offsets by the other side:
+         *  the backends may run the multi-stages of a computation level by level (see `can_merge_mss`).
+         */
+        template <class Msses,
+            class NextMsses,
+            class FusedMsses = meta::concat<Msses, NextMsses>,
+            class Map = get_extent_map_from_msses<Msses>,
+            class NextMap = get_extent_map_from_msses<NextMsses>,
+            class FusedMap = get_extent_map_from_msses<FusedMsses>,
+            class Written = meta::filter<meta::not_<is_tmp_arg>::apply, all_rw_args<Msses>>,
+            class NextWritten = meta::filter<is_contained_f<extract_placeholders_from_msses<Msses>>::template apply,
+                meta::filter<meta::not_<is_tmp_arg>::apply, all_rw_args<NextMsses>>>,
+            class SharedWritten =
+                meta::filter<is_contained_f<extract_placeholders_from_msses<NextMsses>>::template apply,
+                    all_rw_args<Msses>>,
+            class SharedNextWritten =
+                meta::filter<is_contained_f<extract_placeholders_from_msses<Msses>>::template apply,
+                    all_rw_args<NextMsses>>>
+        using can_fuse_msses =
+            bool_constant<meta::all_of<has_same_horizontal_extent_f<Map, FusedMap>::template apply, Written>::value &&
+                          !meta::any_of<has_horizontal_extent_f<FusedMap>::template apply, NextWritten>::value &&
+                          !meta::any_of<has_k_extent_f<NextMap>::template apply, SharedWritten>::value &&
+                          !meta::any_of<has_k_extent_f<Map>::template apply, SharedNextWritten>::value>;
+
+        // the items are pairs of the index of a computation and its (converted) multi-stages
+        template <class Next, class... Items>
+        struct can_fuse_computations
+            : can_fuse_msses<meta::flatten<meta::list<meta::second<Items>...>>, meta::second<Next>> {};
+
+        template <class Items>
+        using group_computations = meta::group<can_fuse_computations, meta::list, Items>;
+
+        template <class Items>
+        using get_group_msses = merge_adjacent_msses<meta::flatten<meta::transform<meta::second, Items>>>;
+
+        template <class Items>
+        using get_group_intermediates =
+            meta::filter<is_intermediate, extract_placeholders_from_msses<get_group_msses<Items>>>;
+
+        template <class Computation>
+        struct computation_traits {
+            GT_STATIC_ASSERT(sizeof(Computation) < 0, "only the results of make_computation can be sequenced");
+        };
+
+        template <class Bound, class Msses, class Meter, class Backend, class NeedPositionals, class Grid>
+        struct computation_traits<
+            computation_facade<Bound, Msses, Meter, backend_entry_point_f<Backend, NeedPositionals, Msses>, Grid>> {
+            using bound_plhs_t = meta::transform<meta::first, Bound>;
+            using msses_t = Msses;
+            using meter_t = Meter;
+            using backend_t = Backend;
+            using need_positionals_t = NeedPositionals;
+            using grid_t = Grid;
+        };
+
+        template <class Intermediates, class Computations>
+        struct make_item_f {
+            template <class I>
+            using apply = meta::list<I,
+                meta::transform<convert_f<I, Intermediates>::template mss,
+                    typename computation_traits<meta::at<Computations, I>>::msses_t>>;
+        };
+
+        template <class Computation>
+        struct get_free_placeholders;
+
+        template <class Bound, class Msses, class Meter, class EntryPoint, class Grid>
+        struct get_free_placeholders<computation_facade<Bound, Msses, Meter, EntryPoint, Grid>> {
+            using type = meta::filter<is_not_contained_f<meta::transform<meta::first, Bound>>::template apply,
+                meta::filter<meta::not_<is_tmp_arg>::apply, extract_placeholders_from_msses<Msses>>>;
+        };
+
+        template <class Group, class... Plhs, class... DataStores, class... Used>
+        void run_group(
+            Group &group, std::tuple<arg_storage_pair<Plhs, DataStores>...> const &srcs, meta::list<Used...>) {
+            group.run(arg_storage_pair<Used, typename Used::data_store_t const &>{
+                std::get<meta::st_position<meta::list<Plhs...>, Used>::value>(srcs).m_value}...);
+        }
+
+        template <class... Groups>
+        class computation_sequence {
+            std::tuple<Groups...> m_groups;
+
+            using free_placeholders_t = meta::dedup<meta::concat<typename get_free_placeholders<Groups>::type...>>;
+
+            template <class... Srcs, size_t... Is>
+            void run_groups(std::tuple<Srcs...> const &srcs, std::index_sequence<Is...>) {
+                (void)(int[]){
+                    (run_group(std::get<Is>(m_groups), srcs, typename get_free_placeholders<Groups>::type()), 0)...};
+            }
+
+          public:
+            computation_sequence(Groups... groups) : m_groups(std::move(groups)...) {}
+
+            template <class... Plhs, class... DataStores>
+            std::enable_if_t<sizeof...(Plhs) == meta::length<free_placeholders_t>::value> run(
+                arg_storage_pair<Plhs, DataStores>... srcs) {
+                GT_STATIC_ASSERT((conjunction<meta::st_contains<free_placeholders_t, Plhs>...>::value),
+                    "some placeholders are not used in the sequence or are intermediates");
+                GT_STATIC_ASSERT(
+                    meta::is_set_fast<meta::list<Plhs...>>::value, "free placeholders should be all different");
+                run_groups(std::make_tuple(std::move(srcs)...), std::index_sequence_for<Groups...>());
+            }
+
+            /**
+             *  The number of computations that are passed to the backend by each run.
+             */
+            static constexpr size_t fused_size() { return sizeof...(Groups); }
+
+            double get_time() const {
+                double res = 0;
+                tuple_util::for_each([&](auto const &group) { res += group.get_time(); }, m_groups);
+                return res;
+            }
+
+            size_t get_count() const { return std::get<0>(m_groups).get_count(); }
+
+            void reset_meter() {
+                tuple_util::for_each([](auto &group) { group.reset_meter(); }, m_groups);
+            }
+
+            roofline_report get_roofline() const {
+                traffic_estimate traffic;
+                tuple_util::for_each([&](auto const &group) { traffic += group.get_roofline().traffic; }, m_groups);
+                return {traffic, get_time(), get_count()};
+            }
+
+            std::string print_roofline(double peak = meta::first<meta::list<Groups...>>::peak_bandwidth()) const {
+                return get_roofline().to_string(peak);
+            }
+
+            template <class Plh,
+                bool IsWritten = disjunction<bool_constant<decltype(Groups::get_arg_intent(Plh()))::value ==
+                                                           intent::inout>...>::value,
+                intent Intent = IsWritten ? intent::inout : intent::in>
+            static constexpr std::integral_constant<intent, Intent> get_arg_intent(Plh) {
+                GT_STATIC_ASSERT(is_plh<Plh>::value, "get_arg_intent argument should be a placeholder.");
+                return {};
+            }
+        };
+
+        template <class Backend, class NeedPositionals, class Meter, class Computations, class... Items>
+        auto make_group(Computations const &computations, meta::list<Items...>) {
+            using msses_t = get_group_msses<meta::list<Items...>>;
+            auto const &grid = std::get<0>(computations).grid();
+            using grid_t = std::decay_t<decltype(grid)>;
+            auto bound = std::tuple_cat(std::get<meta::first<Items>::value>(computations).bound_data_stores()...);
+            return computation_facade<decltype(bound),
+                msses_t,
+                Meter,
+                backend_entry_point_f<Backend, NeedPositionals, msses_t>,
+                grid_t>(grid, std::move(bound));
+        }
+
+        template <class Backend, class NeedPositionals, class Meter, class Computations, class... Groups>
+        computation_sequence<decltype(
+            make_group<Backend, NeedPositionals, Meter>(std::declval<Computations const &>(), Groups()))...>
+        make_sequence(Computations const &computations, meta::list<Groups...>) {
+            return {make_group<Backend, NeedPositionals, Meter>(computations, Groups())...};
+        }
+
+        template <class Grid>
+        struct check_grid_f {
+            Grid const &m_grid;
+            template <class Computation>
+            void operator()(Computation const &computation) const {
+                if (computation.grid() != m_grid)
+                    throw std::runtime_error("the computations of a sequence should run on the same grid");
+            }
+        };
+    } // namespace computation_sequence_impl_
+
+    /**
+     *  Marks the placeholders that are produced and consumed inside of a computation sequence only.
+     */
+    template <class... Plhs>
+    computation_sequence_impl_::intermediates_t<Plhs...> intermediates(Plhs...) {
+        return {};
+    }
+
+    /**
+     *  Creates an object with a `run` method that runs the given computations in order, fusing them where possible.
+     *  The computations have to be created by `make_computation` with the same backend and the same grid (the same
+     *  compute domain and the same vertical splitters, std::runtime_error is thrown otherwise).
+     *  The placeholders that are neither intermediates nor assigned inside of one of the `make_computation` calls are
+     *  assigned when calling `run`.
+     */
+    template <class... Intermediates, class... Computations>
+    auto make_computation_sequence(
+        computation_sequence_impl_::intermediates_t<Intermediates...>, Computations... computations) {
+        using namespace computation_sequence_impl_;
+        GT_STATIC_ASSERT(sizeof...(Computations) > 0, "a computation sequence needs at least one computation");
+        using traits_t = computation_traits<meta::first<meta::list<Computations...>>>;
+        GT_STATIC_ASSERT((conjunction<std::is_same<typename computation_traits<Computations>::backend_t,
+                             typename traits_t::backend_t>...>::value),
+            "the computations of a sequence should have the same backend");
+        GT_STATIC_ASSERT((conjunction<std::is_same<typename computation_traits<Computations>::grid_t,
+                             typename traits_t::grid_t>...>::value),
+            "the computations of a sequence should have the same grid type");
+
+        using intermediates_t = meta::list<Intermediates...>;
+        GT_STATIC_ASSERT((!disjunction<meta::any_of<is_contained_f<intermediates_t>::template apply,
+                             typename computation_traits<Computations>::bound_plhs_t>...>::value),
+            "intermediates can not be assigned inside of make_computation");
+        GT_STATIC_ASSERT(
+            (meta::all_of<is_contained_f<extract_placeholders_from_msses<
+                              meta::concat<typename computation_traits<Computations>::msses_t...>>>::template apply,
+                intermediates_t>::value),
+            "some intermediates are not used by the computations");
+
+        using computations_t = meta::list<Computations...>;
+        using items_t = meta::transform<make_item_f<intermediates_t, computations_t>::template apply,
+            meta::make_indices_c<sizeof...(Computations)>>;
+        using groups_t = group_computations<items_t>;
+        GT_STATIC_ASSERT(
+            (meta::is_set_fast<meta::flatten<meta::transform<get_group_intermediates, groups_t>>>::value),
+            "some intermediates are used by computations that can not be fused");
+
+        using need_positionals_t = disjunction<typename computation_traits<Computations>::need_positionals_t...>;
+
+        auto all = std::make_tuple(std::move(computations)...);
+        tuple_util::for_each(check_grid_f<typename traits_t::grid_t>{std::get<0>(all).grid()}, all);
+        return make_sequence<typename traits_t::backend_t,
+            bool_constant<need_positionals_t::value>,
+            typename traits_t::meter_t>(all, groups_t());
+    }
+
+    template <class... Computations>
+    auto make_computation_sequence(Computations... computations) {
+        return make_computation_sequence(intermediates(), std::move(computations)...);
+    }
+} // namespace gridtools
@@ -0,0 +1,241 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../common/defs.hpp"
+#include "../storage/data_store.hpp"
+#include "accessor_intent.hpp"
+#include "arg.hpp"
+
+/**
+ *  @file
+ *  Asynchronous execution of computations.
+ *
+ *  An `execution_queue` owns a number of worker threads, each of them runs the computations on its own partition of
+ *  the OpenMP threads. A computation that is enqueued together with its data stores starts as soon as a worker is
+ *  free and the computations it depends on have finished. A computation depends on the previously enqueued ones that
+ *  write a data store it accesses and, if it writes a data store (according to `get_arg_intent`), on the previously
+ *  enqueued ones that read it. The runs of the same computation object are executed in order.
+ *
+ *  Only the data stores (and vectors of data stores) passed to `enqueue` are tracked, the ones bound at the creation
+ *  of the computation are not.
+ */
+
+namespace gridtools {
+    namespace execution_queue_impl_ {
+        using resource_t = void const *;
+
+        template <class T>
+        void add_resources(T const &, std::vector<resource_t> &) {}
+
+        template <class Storage, class StorageInfo>
+        void add_resources(data_store<Storage, StorageInfo> const &src, std::vector<resource_t> &dst) {
+            dst.push_back(src.get_storage_ptr().get());
+        }
+
+        template <class T>
+        void add_resources(std::vector<T> const &src, std::vector<resource_t> &dst) {
+            for (auto const &item : src)
+                add_resources(item, dst);
+        }
+
+        inline bool is_ready(std::shared_future<void> const &future) {
+            return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        // a finished run can be forgotten unless its exception still has to be passed to the runs depending on it
+        inline bool is_done(std::shared_future<void> const &future) {
+            if (!is_ready(future))
+                return false;
+            try {
+                future.get();
+            } catch (...) {
+                return false;
+            }
+            return true;
+        }
+
+        template <class Pred>
+        void drop_futures(std::vector<std::shared_future<void>> &futures, Pred pred) {
+            futures.erase(std::remove_if(futures.begin(), futures.end(), pred), futures.end());
+        }
+
+        struct resource_state {
+            std::shared_future<void> m_writer;
+            std::vector<std::shared_future<void>> m_readers;
+        };
+    } // namespace execution_queue_impl_
+
+    class execution_queue {
+        using resource_t = execution_queue_impl_::resource_t;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<std::function<void()>> m_tasks;
+        std::vector<std::shared_future<void>> m_pending;
+        std::map<resource_t, execution_queue_impl_::resource_state> m_resources;
+        bool m_stop = false;
+        std::vector<std::thread> m_workers;
+
+        void work(int threads) {
+            omp_set_num_threads(threads);
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                    if (m_tasks.empty())
+                        return;
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+        // has to be called with the lock held
+        void add_access(resource_t resource,
+            bool is_write,
+            std::shared_future<void> const &done,
+            std::vector<std::shared_future<void>> &deps) {
+            auto &state = m_resources[resource];
+            if (state.m_writer.valid() && execution_queue_impl_::is_done(state.m_writer))
+                state.m_writer = {};
+            if (state.m_writer.valid())
+                deps.push_back(state.m_writer);
+            if (is_write) {
+                deps.insert(deps.end(), state.m_readers.begin(), state.m_readers.end());
+                state.m_readers.clear();
+                state.m_writer = done;
+            } else {
+                // the readers are only collected by the next write, the finished ones are dropped on the way
+                execution_queue_impl_::drop_futures(state.m_readers, execution_queue_impl_::is_done);
+                state.m_readers.push_back(done);
+            }
+        }
+
+      public:
+        /**
+         *  @param partitions the number of computations that may run concurrently
+         *  @param threads the number of OpenMP threads that are shared among the partitions
+         */
+        explicit execution_queue(int partitions = 2, int threads = omp_get_max_threads()) {
+            partitions = std::max(partitions, 1);
+            int per_partition = std::max(threads / partitions, 1);
+            for (int i = 0; i != partitions; ++i)
+                m_workers.emplace_back([this, per_partition] { work(per_partition); });
+        }
+
+        execution_queue(execution_queue const &) = delete;
+        execution_queue &operator=(execution_queue const &) = delete;
+
+        /**
+         *  Finishes all the enqueued computations.
+         */
+        ~execution_queue() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_condition.notify_all();
+            for (auto &worker : m_workers)
+                worker.join();
+        }
+
+        int partitions() const { return m_workers.size(); }
+
+        /**
+         *  Enqueues `comp.run(args...)`. The computation and the data stores have to stay alive until the returned
+         *  future is ready, an exception thrown by the run (or by a run it depends on) is stored in the future.
+         */
+        template <class Computation, class... Plhs, class... DataStores>
+        std::shared_future<void> enqueue(Computation &comp, arg_storage_pair<Plhs, DataStores>... args) {
+            auto promise = std::make_shared<std::promise<void>>();
+            std::shared_future<void> done = promise->get_future().share();
+            std::vector<resource_t> writes = {&comp};
+            std::vector<resource_t> reads;
+            (void)(int[]){0,
+                (execution_queue_impl_::add_resources(
+                     args.m_value, intent(comp.get_arg_intent(Plhs())) == intent::inout ? writes : reads),
+                    0)...};
+            std::sort(writes.begin(), writes.end());
+            writes.erase(std::unique(writes.begin(), writes.end()), writes.end());
+            std::sort(reads.begin(), reads.end());
+            reads.erase(std::unique(reads.begin(), reads.end()), reads.end());
+            reads.erase(std::remove_if(reads.begin(),
+                            reads.end(),
+                            [&](resource_t resource) {
+                                return std::binary_search(writes.begin(), writes.end(), resource);
+                            }),
+                reads.end());
+            std::vector<std::shared_future<void>> deps;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (resource_t resource : writes)
+                    add_access(resource, true, done, deps);
+                for (resource_t resource : reads)
+                    add_access(resource, false, done, deps);
+                execution_queue_impl_::drop_futures(m_pending, execution_queue_impl_::is_ready);
+                m_pending.push_back(done);
+                m_tasks.emplace_back([promise, deps = std::move(deps), &comp, args...]() mutable {
+                    try {
+                        for (auto &dep : deps)
+                            dep.get();
+                        comp.run(args...);
+                        promise->set_value();
+                    } catch (...) {
+                        promise->set_exception(std::current_exception());
+                    }
+                });
+            }
+            m_condition.notify_one();
+            return done;
+        }
+
+        /**
+         *  Waits until all the enqueued computations are finished. Their exceptions are not rethrown, they are only
+         *  available through the futures returned by `enqueue`.
+         */
+        void wait() {
+            std::vector<std::shared_future<void>> pending;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                pending.swap(m_pending);
+            }
+            for (auto &item : pending)
+                item.wait();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_pending.empty())
+                m_resources.clear();
+        }
+    };
+
+    /**
+     *  Runs `comp` with the given arguments asynchronously on `queue`, see `execution_queue::enqueue`.
+     */
+    template <class Computation, class... Args>
+    std::shared_future<void> run_async(execution_queue &queue, Computation &comp, Args... args) {
+        return queue.enqueue(comp, std::move(args)...);
+    }
+} // namespace gridtools
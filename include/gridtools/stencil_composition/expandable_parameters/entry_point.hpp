@@ -196,19 +196,64 @@ namespace gridtools {
             template <class Factor>
             using converted_entry_point = backend_entry_point_f<Backend, IsStateful, convert_msses<Factor, Msses>>;
 
+            converted_entry_point<ExpandFactor> m_entry_point;
+            converted_entry_point<expand_factor<1>> m_remainder_entry_point;
+            traffic_estimate m_traffic;
+
             template <class Grid, class DataStores>
-            void operator()(Grid const &grid, DataStores data_stores) const {
+            void operator()(Grid const &grid, DataStores data_stores) {
                 size_t size = get_expandable_size(data_stores);
                 size_t offset = 0;
+                m_traffic = {};
+                for (; size - offset >= ExpandFactor::value; offset += ExpandFactor::value) {
+                    m_entry_point(grid, convert_data_store_map<ExpandFactor>(offset, data_stores));
+                    m_traffic += m_entry_point.traffic();
+                }
+                for (; offset < size; ++offset) {
+                    m_remainder_entry_point(grid, convert_data_store_map<expand_factor<1>>(offset, data_stores));
+                    m_traffic += m_remainder_entry_point.traffic();
+                }
+            }
+
+            traffic_estimate const &traffic() const { return m_traffic; }
+
+            static double peak_bandwidth() { return gridtools::peak_bandwidth(Backend()); }
+        };
+
+        /**
+         *  Passes all the chunks to the backend at once, the ones with `ExpandFactor` parameters and the remainder
+         *  ones with a single parameter are two computations of a chunked backend entry point.
+         */
+        template <class ExpandFactor, class Backend, class IsStateful, class Msses>
+        struct parallel_expandable_entry_point_f {
+            backend_chunked_entry_point_f<Backend,
+                IsStateful,
+                meta::list<convert_msses<ExpandFactor, Msses>, convert_msses<expand_factor<1>, Msses>>>
+                m_entry_point;
+
+            template <class Grid, class DataStores>
+            void operator()(Grid const &grid, DataStores data_stores) {
+                using chunk_t = decltype(convert_data_store_map<ExpandFactor>(0, data_stores));
+                using remainder_t = decltype(convert_data_store_map<expand_factor<1>>(0, data_stores));
+                size_t size = get_expandable_size(data_stores);
+                std::vector<chunk_t> chunks;
+                std::vector<remainder_t> remainders;
+                chunks.reserve(size / ExpandFactor::value);
+                remainders.reserve(size % ExpandFactor::value);
+                size_t offset = 0;
                 for (; size - offset >= ExpandFactor::value; offset += ExpandFactor::value)
-                    converted_entry_point<ExpandFactor>()(
-                        grid, convert_data_store_map<ExpandFactor>(offset, data_stores));
+                    chunks.push_back(convert_data_store_map<ExpandFactor>(offset, data_stores));
                 for (; offset < size; ++offset)
-                    converted_entry_point<expand_factor<1>>()(
-                        grid, convert_data_store_map<expand_factor<1>>(offset, data_stores));
+                    remainders.push_back(convert_data_store_map<expand_factor<1>>(offset, data_stores));
+                m_entry_point(grid, std::move(chunks), std::move(remainders));
             }
+
+            traffic_estimate const &traffic() const { return m_entry_point.traffic(); }
+
+            static double peak_bandwidth() { return gridtools::peak_bandwidth(Backend()); }
         };
     } // namespace intermediate_expand_impl_
 
     using intermediate_expand_impl_::expandable_entry_point_f;
+    using intermediate_expand_impl_::parallel_expandable_entry_point_f;
 } // namespace gridtools
@@ -20,4 +20,12 @@
 namespace gridtools {
     template <size_t Value>
     using expand_factor = std::integral_constant<size_t, Value>;
+
+    /**
+       Expand factor for which all the chunks of the expandable parameters, including the remainder ones with a
+       single parameter, are executed at once: the backend schedules the (block, chunk) pairs as the work items of a
+       single parallel region if it supports it.
+    */
+    template <size_t Value>
+    struct parallel_expand_factor : std::integral_constant<size_t, Value> {};
 } // namespace gridtools
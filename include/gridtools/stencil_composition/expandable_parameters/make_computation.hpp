@@ -34,6 +34,14 @@ namespace gridtools {
         return make_computation_facade<Backend, expandable_entry_point>(std::move(args)...);
     }
 
+    template <class Backend, bool IsStateful = GT_POSITIONAL_WHEN_DEBUGGING, size_t N, class... Args>
+    auto make_expandable_computation(parallel_expand_factor<N>, Args... args) {
+        using msses_t = meta::filter<is_mss_descriptor, meta::list<Args...>>;
+        using expandable_entry_point =
+            parallel_expandable_entry_point_f<expand_factor<N>, Backend, bool_constant<IsStateful>, msses_t>;
+        return make_computation_facade<Backend, expandable_entry_point>(std::move(args)...);
+    }
+
 #undef GT_POSITIONAL_WHEN_DEBUGGING
 
     // user protection only, catch the case where no backend is specified
@@ -46,4 +54,9 @@ namespace gridtools {
     auto make_expandable_positional_computation(expand_factor<N> factor, Grid const &grid, Args... args) {
         return make_expandable_computation<Backend, true, Grid>(factor, grid, std::move(args)...);
     }
+
+    template <class Backend, class Grid, size_t N, class... Args>
+    auto make_expandable_positional_computation(parallel_expand_factor<N> factor, Grid const &grid, Args... args) {
+        return make_expandable_computation<Backend, true>(factor, grid, std::move(args)...);
+    }
 } // namespace gridtools
@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <initializer_list>
 #include <iterator>
@@ -92,6 +93,32 @@ namespace gridtools {
             }
         }
 
+        /**
+         * @brief The grid restricted to the horizontal subdomain [i_offset, i_offset + i_size) x [j_offset, j_offset +
+         * j_size), given relative to the compute domain of this grid. The vertical layout is kept.
+         */
+        grid sub_grid(int_t i_offset, int_t i_size, int_t j_offset, int_t j_size) const {
+            assert(i_offset >= 0 && i_size >= 0 && i_offset + i_size <= m_i_size);
+            assert(j_offset >= 0 && j_size >= 0 && j_offset + j_size <= m_j_size);
+            grid res = *this;
+            res.m_i_start += i_offset;
+            res.m_i_size = i_size;
+            res.m_j_start += j_offset;
+            res.m_j_size = j_size;
+            return res;
+        }
+
+        /**
+         * @brief Grids are equal if they have the same compute domain and the same vertical splitters.
+         */
+        friend bool operator==(grid const &lhs, grid const &rhs) {
+            return lhs.m_i_start == rhs.m_i_start && lhs.m_i_size == rhs.m_i_size && lhs.m_j_start == rhs.m_j_start &&
+                   lhs.m_j_size == rhs.m_j_size &&
+                   std::equal(std::begin(lhs.m_k_values), std::end(lhs.m_k_values), std::begin(rhs.m_k_values));
+        }
+
+        friend bool operator!=(grid const &lhs, grid const &rhs) { return !(lhs == rhs); }
+
         auto origin() const {
             return tuple_util::make<hymap::keys<dim::i, dim::j, dim::k>::values>(m_i_start, m_j_start, offset());
         }
@@ -0,0 +1,220 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "../common/defs.hpp"
+#include "../common/generic_metafunctions/for_each.hpp"
+#include "../common/tuple_util.hpp"
+#include "../meta.hpp"
+#include "../storage/data_store.hpp"
+#include "stage_matrix.hpp"
+
+/**
+ *  @file
+ *  Roofline analysis of computations.
+ *
+ *  The minimal memory traffic of a run is derived from the stage matrix: every field that is held by a data store is
+ *  read once over the region in which it is accessed and, if it is written, stored once more, temporaries stay in the
+ *  caches. The floating point operations are counted if the elementary functors declare them per grid point:
+ *
+ *      struct lap_function {
+ *          static constexpr int flops = 5;
+ *          ...
+ *      };
+ *
+ *  The functors that don't declare `flops` count as zero.
+ */
+
+namespace gridtools {
+    /**
+     *  Estimated bytes moved and floating point operations of a single run.
+     */
+    struct traffic_estimate {
+        double bytes = 0;
+        double flops = 0;
+
+        traffic_estimate &operator+=(traffic_estimate const &other) {
+            bytes += other.bytes;
+            flops += other.flops;
+            return *this;
+        }
+
+        friend traffic_estimate operator*(traffic_estimate const &obj, double factor) {
+            return {obj.bytes * factor, obj.flops * factor};
+        }
+    };
+
+    namespace roofline_impl_ {
+        template <class Plh, class = void>
+        struct is_field : std::false_type {};
+
+        template <class Plh>
+        struct is_field<Plh, void_t<typename Plh::data_store_t>> : is_data_store<typename Plh::data_store_t> {};
+
+        template <class Info>
+        using is_field_info = bool_constant<!Info::is_tmp_t::value && is_field<typename Info::plh_t>::value>;
+
+        template <class Functor, class = void>
+        struct functor_flops : integral_constant<int_t, 0> {};
+
+        template <class Functor>
+        struct functor_flops<Functor, void_t<decltype(Functor::flops)>> : integral_constant<int_t, Functor::flops> {
+        };
+
+        // on icosahedral grids the functor is applied to every color
+        template <class Functor, class = void>
+        struct functor_colors : integral_constant<int_t, 1> {};
+
+        template <class Functor>
+        struct functor_colors<Functor, void_t<typename Functor::location::n_colors>>
+            : integral_constant<int_t, Functor::location::n_colors::value> {};
+
+        template <class>
+        struct stage_flops;
+
+        template <template <class...> class Stage, class Functor, class... Ts>
+        struct stage_flops<Stage<Functor, Ts...>>
+            : integral_constant<int_t, functor_flops<Functor>::value * functor_colors<Functor>::value> {};
+
+        template <class... Stages>
+        int_t cell_flops(meta::list<Stages...>) {
+            int_t res = 0;
+            for (int_t flops : std::initializer_list<int_t>{stage_flops<Stages>::value...})
+                res += flops;
+            return res;
+        }
+    } // namespace roofline_impl_
+
+    /**
+     *  The traffic of a run of the computation given by the stage matrices `Spec` on `grid`.
+     */
+    template <class Spec, class Grid>
+    traffic_estimate estimate_traffic(Spec, Grid const &grid) {
+        using stages_t = stage_matrix::make_split_view<Spec>;
+        traffic_estimate res;
+        for_each<meta::filter<roofline_impl_::is_field_info, typename stages_t::plh_map_t>>([&](auto info) {
+            auto extent = info.extent();
+            int_t transfers = info.is_const() ? 1 : 2;
+            res.bytes += (double)sizeof(decltype(info.data())) * info.num_colors() * transfers * grid.i_size(extent) *
+                         grid.j_size(extent) * grid.k_size(stages_t::interval(), extent);
+        });
+        for_each<stages_t>([&](auto stage) {
+            tuple_util::for_each(
+                [&](auto cell) {
+                    auto extent = cell.extent();
+                    res.flops += (double)roofline_impl_::cell_flops(meta::rename<meta::list, decltype(cell.funs())>()) *
+                                 grid.i_size(extent) * grid.j_size(extent) * grid.k_size(cell.interval());
+                },
+                stage.cells());
+        });
+        return res;
+    }
+
+    /**
+     *  Measures the memory bandwidth [GB/s] with the STREAM triad on arrays of `size` doubles, the best of
+     *  `repetitions` runs is returned. The arrays should be much larger than the last level cache.
+     */
+    inline double measure_stream_bandwidth(std::size_t size = std::size_t(1) << 24, int repetitions = 5) {
+        std::unique_ptr<double[]> a(new double[size]);
+        std::unique_ptr<double[]> b(new double[size]);
+        std::unique_ptr<double[]> c(new double[size]);
+        std::ptrdiff_t n = size;
+#pragma omp parallel for
+        for (std::ptrdiff_t i = 0; i < n; ++i) {
+            a[i] = 0;
+            b[i] = 1;
+            c[i] = 2;
+        }
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            auto start = std::chrono::steady_clock::now();
+#pragma omp parallel for
+            for (std::ptrdiff_t i = 0; i < n; ++i)
+                a[i] = b[i] + 3 * c[i];
+            double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (time > 0)
+                best = std::max(best, 3 * sizeof(double) * size / time * 1e-9);
+        }
+        return best;
+    }
+
+    /**
+     *  The peak memory bandwidth [GB/s] given by the environment variable `GT_STREAM_BANDWIDTH`, 0 if it is not set.
+     */
+    inline double given_stream_bandwidth() {
+        char const *env = std::getenv("GT_STREAM_BANDWIDTH");
+        return env ? std::atof(env) : 0;
+    }
+
+    /**
+     *  The peak memory bandwidth [GB/s] of the host for the roofline reports: the value of the environment variable
+     *  `GT_STREAM_BANDWIDTH` if it is set, otherwise the STREAM triad is measured once.
+     */
+    inline double stream_bandwidth() {
+        static double const res = [] {
+            double given = given_stream_bandwidth();
+            return given > 0 ? given : measure_stream_bandwidth();
+        }();
+        return res;
+    }
+
+    /**
+     *  The peak memory bandwidth [GB/s] of the memory the backend computes on. The host backends use
+     *  `stream_bandwidth`. The STREAM triad can not measure the device memory, so for cuda the peak is only known if
+     *  `GT_STREAM_BANDWIDTH` is set, otherwise it is 0 and the reports show no percentage of the peak.
+     */
+    template <class Backend>
+    double peak_bandwidth(Backend) {
+        return stream_bandwidth();
+    }
+
+    template <class... Params>
+    double peak_bandwidth(cuda::backend<Params...>) {
+        return given_stream_bandwidth();
+    }
+
+    /**
+     *  The achieved bandwidth and flop rate of `count` runs that took `time` seconds in total.
+     */
+    struct roofline_report {
+        traffic_estimate traffic;
+        double time;
+        std::size_t count;
+
+        double bandwidth() const { return time > 0 ? traffic.bytes * count / time * 1e-9 : 0; }
+        double flop_rate() const { return time > 0 ? traffic.flops * count / time * 1e-9 : 0; }
+        double arithmetic_intensity() const { return traffic.bytes > 0 ? traffic.flops / traffic.bytes : 0; }
+
+        /**
+         *  Reports GB/s and, if given, the percentage of `peak_bandwidth` [GB/s]; GFlop/s and flop/B are reported
+         *  only if the functors declare their flops.
+         */
+        std::string to_string(double peak_bandwidth = 0) const {
+            std::ostringstream out;
+            out << "roofline\t[GB/s]\t" << bandwidth();
+            if (peak_bandwidth > 0)
+                out << "\t[% of peak]\t" << 100 * bandwidth() / peak_bandwidth;
+            if (traffic.flops > 0)
+                out << "\t[GFlop/s]\t" << flop_rate() << "\t[flop/B]\t" << arithmetic_intensity();
+            out << "\t[MB/run]\t" << traffic.bytes * 1e-6;
+            return out.str();
+        }
+    };
+} // namespace gridtools
@@ -17,7 +17,9 @@
 #include "../common/tuple.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta.hpp"
+#include "dim.hpp"
 #include "execution_types.hpp"
+#include "extent.hpp"
 #include "interval.hpp"
 #include "sid/concept.hpp"
 
@@ -377,6 +379,114 @@ namespace gridtools {
             static GT_FUNCTION interval_t interval() { return {}; }
         };
 
+        namespace pipeline_levels_impl_ {
+            template <class Backward, class PlhInfo>
+            using accesses_next_levels = bool_constant<Backward::value ? (PlhInfo::extent_t::kminus::value < 0)
+                                                                       : (PlhInfo::extent_t::kplus::value > 0)>;
+
+            template <class Backward, class PlhInfo>
+            using accesses_previous_levels = bool_constant<Backward::value ? (PlhInfo::extent_t::kplus::value > 0)
+                                                                           : (PlhInfo::extent_t::kminus::value < 0)>;
+
+            template <class Backward, class ConsumerInfo>
+            struct is_legal_producer_info_f {
+                template <class ProducerInfo>
+                using apply = bool_constant<!std::is_same<get_plh<ProducerInfo>, get_plh<ConsumerInfo>>::value ||
+                                            ((ProducerInfo::is_const_t::value ||
+                                                 !accesses_next_levels<Backward, ConsumerInfo>::value) &&
+                                                (ConsumerInfo::is_const_t::value ||
+                                                    !accesses_previous_levels<Backward, ProducerInfo>::value))>;
+            };
+
+            template <class Backward, class Producer>
+            struct is_legal_consumer_info_f {
+                template <class ConsumerInfo>
+                using apply = meta::all_of<is_legal_producer_info_f<Backward, ConsumerInfo>::template apply,
+                    typename Producer::plh_map_t>;
+            };
+
+            template <class Backward, class Producer, class Consumer>
+            using are_levels_independent =
+                meta::all_of<is_legal_consumer_info_f<Backward, Producer>::template apply, typename Consumer::plh_map_t>;
+
+            template <class Backward, class... Items>
+            struct are_items_pipelinable : std::true_type {};
+
+            template <class Backward, class Item, class... Items>
+            struct are_items_pipelinable<Backward, Item, Items...>
+                : conjunction<are_levels_independent<Backward, Item, Items>...,
+                      are_items_pipelinable<Backward, Items...>> {};
+        } // namespace pipeline_levels_impl_
+
+        /**
+         *  Tells if the items of the view can be executed level by level: at every k-level all items are executed
+         *  in their order before the next level is processed.
+         *
+         *  This is the case if all k-serial items go in the same direction and no item accesses the levels of a field
+         *  that an earlier item has not produced yet (reads ahead in the direction of the execution) or that a later
+         *  item has already overwritten (reads behind). Parallel items follow the direction of the serial ones.
+         */
+        template <class View>
+        struct can_pipeline_levels;
+
+        template <class... Items>
+        struct can_pipeline_levels<aggregated_view<Items...>>
+            : conjunction<negation<conjunction<disjunction<execute::is_forward<typename Items::execution_t>...>,
+                              disjunction<execute::is_backward<typename Items::execution_t>...>>>,
+                  pipeline_levels_impl_::are_items_pipelinable<
+                      disjunction<execute::is_backward<typename Items::execution_t>...>,
+                      Items...>> {};
+
+        namespace fuse_columns_impl_ {
+            template <class Item, class PlhInfo>
+            using is_column_access = std::is_same<to_horizontal_extent<typename PlhInfo::extent_t>,
+                to_horizontal_extent<typename Item::extent_t>>;
+
+            template <class Producer, class ProducerInfo, class Consumer>
+            struct is_column_consumer_info_f {
+                template <class ConsumerInfo>
+                using apply = bool_constant<!std::is_same<get_plh<ProducerInfo>, get_plh<ConsumerInfo>>::value ||
+                                            (ProducerInfo::is_const_t::value && ConsumerInfo::is_const_t::value) ||
+                                            (is_column_access<Producer, ProducerInfo>::value &&
+                                                is_column_access<Consumer, ConsumerInfo>::value)>;
+            };
+
+            template <class Producer, class Consumer>
+            struct is_column_producer_info_f {
+                template <class ProducerInfo>
+                using apply = meta::all_of<is_column_consumer_info_f<Producer, ProducerInfo, Consumer>::template apply,
+                    typename Consumer::plh_map_t>;
+            };
+
+            template <class Producer, class Consumer>
+            using are_columns_independent = meta::all_of<is_column_producer_info_f<Producer, Consumer>::template apply,
+                typename Producer::plh_map_t>;
+
+            template <class... Items>
+            struct are_items_fusable : std::true_type {};
+
+            template <class Item, class... Items>
+            struct are_items_fusable<Item, Items...>
+                : conjunction<are_columns_independent<Item, Items>..., are_items_fusable<Items...>> {};
+        } // namespace fuse_columns_impl_
+
+        /**
+         *  Tells if the items of the view can be executed column by column: all items are applied to a column of the
+         *  block (in their order and each with its own execution direction) before the next column is processed.
+         *
+         *  This is the case if the items cover the same horizontal region and the fields that are written by one item
+         *  and accessed by another one are accessed without horizontal offsets by both, that is the dependencies
+         *  between the items are purely vertical. Unlike `can_pipeline_levels` the directions may differ, e.g. a
+         *  forward sweep may be followed by a backward sweep.
+         */
+        template <class View>
+        struct can_fuse_columns;
+
+        template <class... Items>
+        struct can_fuse_columns<aggregated_view<Items...>>
+            : conjunction<meta::are_same<to_horizontal_extent<typename Items::extent_t>...>,
+                  fuse_columns_impl_::are_items_fusable<Items...>> {};
+
         template <class Matrix>
         using make_fused_view_item = meta::rename<fused_view_item,
             meta::transform<meta::rename<interval_info>::apply,
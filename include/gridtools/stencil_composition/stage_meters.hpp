@@ -0,0 +1,191 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+#include "../common/timer/region_profiler.hpp"
+#include "../meta.hpp"
+#include "bind_functor_with_interval.hpp"
+#include "stage_matrix.hpp"
+
+/**
+ *  @file
+ *  Per-stage instrumentation of the host backends.
+ *
+ *  If `GT_ENABLE_STAGE_METERS` is defined, the entry points of the naive, x86 and mc backends record every run of a
+ *  computation and every execution of a stage by a thread in the `region_profiler`. The stages are named after their
+ *  elementary functors and grouped by the multistage they stem from. Otherwise the meters are empty.
+ */
+
+namespace gridtools {
+    namespace stage_meters_impl_ {
+        inline std::string demangle(char const *name) {
+#if defined(__GNUC__) || defined(__clang__)
+            int status = 0;
+            char *res = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+            if (status == 0 && res) {
+                std::string str = res;
+                std::free(res);
+                return str;
+            }
+#endif
+            return name;
+        }
+
+        template <class Functor>
+        struct get_esf_function {
+            using type = Functor;
+        };
+
+        template <class Functor, class Interval>
+        struct get_esf_function<_impl::bound_functor<Functor, Interval>> {
+            using type = Functor;
+        };
+
+        template <class>
+        struct get_stage_functor;
+
+        template <template <class...> class Stage, class Functor, class... Ts>
+        struct get_stage_functor<Stage<Functor, Ts...>> : get_esf_function<Functor> {};
+
+        template <class Cell>
+        using get_cell_functors = meta::transform<meta::force<get_stage_functor>::apply, typename Cell::funs_t>;
+
+        template <class Stage>
+        using stage_functors = meta::dedup<
+            meta::flatten<meta::transform<get_cell_functors, meta::rename<meta::list, typename Stage::cells_t>>>>;
+
+        template <class... Functors>
+        std::string join_names(meta::list<Functors...>, char const *separator) {
+            std::string res;
+            for (char const *name : std::initializer_list<char const *>{typeid(Functors).name()...}) {
+                if (!res.empty())
+                    res += separator;
+                res += demangle(name);
+            }
+            return res;
+        }
+
+        template <class Stage>
+        std::string stage_name() {
+            return join_names(stage_functors<Stage>(), "+");
+        }
+
+        template <class Spec>
+        std::string computation_name() {
+            using stages_t = meta::rename<meta::list, stage_matrix::make_split_view<Spec>>;
+            return join_names(meta::dedup<meta::flatten<meta::transform<stage_functors, stages_t>>>(), ", ");
+        }
+
+        template <class... Matrices>
+        struct multistage_sizes {
+            static std::vector<std::size_t> get() {
+                return {meta::length<stage_matrix::fuse_stage_rows<Matrices>>::value...};
+            }
+        };
+
+        /**
+         *  The multistage (the matrix of `Spec`) that the `Stage` of the split view of `Spec` belongs to.
+         */
+        template <class Spec, class Stage>
+        std::size_t multistage_index() {
+            using stages_t = meta::rename<meta::list, stage_matrix::make_split_view<Spec>>;
+            std::size_t pos = meta::find<stages_t, Stage>::value;
+            std::size_t res = 0;
+            for (std::size_t size : meta::rename<multistage_sizes, Spec>::get()) {
+                if (pos < size)
+                    break;
+                pos -= size;
+                ++res;
+            }
+            return res;
+        }
+
+        template <class Spec>
+        int computation_region() {
+            static int const res = region_profiler::instance().region(
+                computation_name<Spec>(), -1, region_profiler::region_kind::computation);
+            return res;
+        }
+
+        template <class Spec, class Stage>
+        int stage_region() {
+            static int const res = [] {
+                auto &profiler = region_profiler::instance();
+                int multistage = profiler.region("multistage " + std::to_string(multistage_index<Spec, Stage>()),
+                    computation_region<Spec>(),
+                    region_profiler::region_kind::multistage);
+                return profiler.region(stage_name<Stage>(), multistage, region_profiler::region_kind::stage);
+            }();
+            return res;
+        }
+    } // namespace stage_meters_impl_
+
+#ifdef GT_ENABLE_STAGE_METERS
+    /**
+     *  Measures a run of the computation given by `Spec` (wall time of the calling thread).
+     */
+    template <class Spec>
+    class computation_meter {
+        region_profiler::scope m_scope;
+
+      public:
+        computation_meter() : m_scope(stage_meters_impl_::computation_region<Spec>(), false) {}
+    };
+
+    /**
+     *  Measures the execution of `Stage` of the computation given by `Spec` by the calling thread.
+     */
+    template <class Spec, class Stage>
+    class stage_meter {
+        region_profiler::scope m_scope;
+
+      public:
+        stage_meter() : m_scope(stage_meters_impl_::stage_region<Spec, Stage>()) {}
+    };
+
+    /**
+     *  Wraps the loop over `Stage` such that every call is measured by a `stage_meter`.
+     */
+    template <class Spec, class Stage, class Fun>
+    auto meter_stage(Fun fun) {
+        return [fun = std::move(fun)](auto &&... args) {
+            stage_meter<Spec, Stage> meter;
+            fun(std::forward<decltype(args)>(args)...);
+        };
+    }
+#else
+    template <class Spec>
+    struct computation_meter {
+        computation_meter() {}
+    };
+
+    template <class Spec, class Stage>
+    struct stage_meter {
+        stage_meter() {}
+    };
+
+    template <class Spec, class Stage, class Fun>
+    Fun meter_stage(Fun fun) {
+        return fun;
+    }
+#endif
+} // namespace gridtools
@@ -0,0 +1,441 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../common/defs.hpp"
+#include "../common/host_device.hpp"
+#include "../common/hymap.hpp"
+#include "../common/timer/timer_traits.hpp"
+#include "accessor.hpp"
+#include "accessor_intent.hpp"
+#include "arg.hpp"
+#include "caches/define_caches.hpp"
+#include "computation.hpp"
+#include "dim.hpp"
+#include "execution_types.hpp"
+#include "extent.hpp"
+#include "global_parameter.hpp"
+#include "grid.hpp"
+#include "make_computation.hpp"
+#include "make_param_list.hpp"
+#include "make_stage.hpp"
+#include "make_stencils.hpp"
+
+/**
+ *  @file
+ *  Batched solution of tridiagonal systems along k.
+ *
+ *  Every column of the grid holds a system with the lower diagonal `inf`, the main diagonal `diag`, the upper diagonal
+ *  `sup` and the right hand side `rhs`. Every row of the matrix has the same vector index: `inf` at the first level and
+ *  `sup` at the last level of the grid are not used. The inputs are not modified, the solution is written to `out`.
+ *
+ *  Two methods are available:
+ *  - `tridiagonal_method::thomas`: a forward sweep that normalizes the rows, followed by a backward substitution. The
+ *    normalized coefficients are kept in k-cached temporaries, the inputs are read once. The columns are solved in
+ *    parallel, every column by a single thread.
+ *  - `tridiagonal_method::cyclic_reduction`: parallel cyclic reduction. Every step eliminates the couplings to the rows
+ *    at a distance `s` and doubles `s`, after `ceil(log2(k_size))` steps all the rows are decoupled. The steps are
+ *    parallel along k too, at the price of `log2(k_size)` times the work of the Thomas algorithm.
+ *
+ *  `tridiagonal_method::automatic` selects the method from the shape of the grid: cyclic reduction if there are too few
+ *  columns to keep the threads busy with the Thomas algorithm, see `select_tridiagonal_method`.
+ *
+ *  The solver models the computation concept, it can be run and measured like a computation and it can be stored in a
+ *  `computation<Inf, Diag, Sup, Rhs, Out>`:
+ *
+ *      auto solver = make_tridiagonal_solver<backend_t>(grid, p_inf, p_diag, p_sup, p_rhs, p_out);
+ *      solver.run(p_inf = inf, p_diag = diag, p_sup = sup, p_rhs = rhs, p_out = out);
+ */
+
+namespace gridtools {
+    enum class tridiagonal_method { automatic, thomas, cyclic_reduction };
+
+    namespace tridiagonal_solver_impl_ {
+        template <class Interval>
+        struct thomas_forward {
+            using inf = in_accessor<0>;
+            using diag = in_accessor<1>;
+            using sup = in_accessor<2>;
+            using rhs = in_accessor<3>;
+            using c = inout_accessor<4, extent<0, 0, 0, 0, -1, 0>>;
+            using d = inout_accessor<5, extent<0, 0, 0, 0, -1, 0>>;
+            using param_list = make_param_list<inf, diag, sup, rhs, c, d>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, typename Interval::first_level) {
+                auto divided = 1 / eval(diag());
+                eval(c()) = eval(sup()) * divided;
+                eval(d()) = eval(rhs()) * divided;
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, typename Interval::template modify<1, 0>) {
+                auto divided = 1 / (eval(diag()) - eval(c(0, 0, -1)) * eval(inf()));
+                eval(c()) = eval(sup()) * divided;
+                eval(d()) = (eval(rhs()) - eval(d(0, 0, -1)) * eval(inf())) * divided;
+            }
+        };
+
+        template <class Interval>
+        struct thomas_backward {
+            using c = in_accessor<0>;
+            using d = in_accessor<1>;
+            using out = inout_accessor<2, extent<0, 0, 0, 0, 0, 1>>;
+            using param_list = make_param_list<c, d, out>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, typename Interval::last_level) {
+                eval(out()) = eval(d());
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, typename Interval::template modify<0, -1>) {
+                eval(out()) = eval(d()) - eval(c()) * eval(out(0, 0, 1));
+            }
+        };
+
+        struct pcr_step_params {
+            int_t stride;
+            int_t k_first;
+            int_t k_last;
+        };
+
+        /*
+         * A step of the cyclic reduction: the couplings of every row to the rows at the distance `stride` are
+         * eliminated, the rows outside of the grid are the rows of the identity matrix. The distance is known at run
+         * time only, the declared extents cover the first step.
+         */
+        struct pcr_step {
+            using inf = in_accessor<0, extent<0, 0, 0, 0, -1, 1>>;
+            using diag = in_accessor<1, extent<0, 0, 0, 0, -1, 1>>;
+            using sup = in_accessor<2, extent<0, 0, 0, 0, -1, 1>>;
+            using rhs = in_accessor<3, extent<0, 0, 0, 0, -1, 1>>;
+            using inf_out = inout_accessor<4>;
+            using diag_out = inout_accessor<5>;
+            using sup_out = inout_accessor<6>;
+            using rhs_out = inout_accessor<7>;
+            using params = in_accessor<8>;
+            using param_list = make_param_list<inf, diag, sup, rhs, inf_out, diag_out, sup_out, rhs_out, params>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                pcr_step_params const &p = eval(params());
+                int_t s = p.stride;
+                auto a = eval(inf());
+                auto b = eval(diag());
+                auto c = eval(sup());
+                auto d = eval(rhs());
+                decltype(a) a_res = 0;
+                decltype(c) c_res = 0;
+                if (eval.k() - s >= p.k_first) {
+                    auto alpha = -a / eval(diag(0, 0, -s));
+                    a_res = alpha * eval(inf(0, 0, -s));
+                    b += alpha * eval(sup(0, 0, -s));
+                    d += alpha * eval(rhs(0, 0, -s));
+                }
+                if (eval.k() + s <= p.k_last) {
+                    auto gamma = -c / eval(diag(0, 0, s));
+                    c_res = gamma * eval(sup(0, 0, s));
+                    b += gamma * eval(inf(0, 0, s));
+                    d += gamma * eval(rhs(0, 0, s));
+                }
+                eval(inf_out()) = a_res;
+                eval(diag_out()) = b;
+                eval(sup_out()) = c_res;
+                eval(rhs_out()) = d;
+            }
+        };
+
+        struct pcr_solve {
+            using diag = in_accessor<0>;
+            using rhs = in_accessor<1>;
+            using out = inout_accessor<2>;
+            using param_list = make_param_list<diag, rhs, out>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                eval(out()) = eval(rhs()) / eval(diag());
+            }
+        };
+
+        template <uint_t>
+        struct scratch_tag;
+        struct step_tag;
+        struct c_tag;
+        struct d_tag;
+
+        // the number of cyclic reduction steps that decouple all the rows of a system of size n
+        inline int_t num_pcr_steps(int_t n) {
+            int_t res = 0;
+            for (int_t s = 1; s < n; s *= 2)
+                ++res;
+            return res;
+        }
+
+        inline int_t default_concurrency() {
+#ifdef _OPENMP
+            return omp_get_max_threads();
+#else
+            return 1;
+#endif
+        }
+
+        template <class Plh, class Arg, class DataStore, class... Args>
+        std::enable_if_t<std::is_same<Plh, Arg>::value, DataStore const &> get_data_store(
+            arg_storage_pair<Arg, DataStore> const &arg, Args const &...) {
+            return arg.m_value;
+        }
+
+        template <class Plh, class Arg, class DataStore, class... Args>
+        std::enable_if_t<!std::is_same<Plh, Arg>::value, typename Plh::data_store_t const &> get_data_store(
+            arg_storage_pair<Arg, DataStore> const &, Args const &... args) {
+            return get_data_store<Plh>(args...);
+        }
+    } // namespace tridiagonal_solver_impl_
+
+    /**
+     *  The method that `tridiagonal_method::automatic` selects for a grid, if `concurrency` threads are available.
+     *
+     *  The run time of the Thomas algorithm is estimated by the length of the columns times the number of columns per
+     *  thread, the run time of the cyclic reduction by the number of steps times the number of points per thread. A
+     *  level of a cyclic reduction step reads three rows and does two divisions, it is counted as twice a level of
+     *  the Thomas algorithm. The cyclic reduction is selected if it is estimated to be faster, that is if there are
+     *  much less columns than threads and the columns are long.
+     */
+    template <class Grid>
+    tridiagonal_method select_tridiagonal_method(Grid const &grid, int_t concurrency) {
+        // the costs of large grids do not fit into int_t
+        constexpr std::int64_t pcr_step_cost = 2;
+        std::int64_t columns = std::int64_t(grid.i_size()) * grid.j_size();
+        std::int64_t n = grid.k_size();
+        std::int64_t threads = std::max(concurrency, 1);
+        std::int64_t thomas_cost = (columns + threads - 1) / threads * n;
+        std::int64_t pcr_cost =
+            (columns * n + threads - 1) / threads * tridiagonal_solver_impl_::num_pcr_steps(n) * pcr_step_cost;
+        return pcr_cost < thomas_cost ? tridiagonal_method::cyclic_reduction : tridiagonal_method::thomas;
+    }
+
+    /**
+     *  A batched tridiagonal solver, see the description at the top of the file. Use `make_tridiagonal_solver` to
+     *  create it.
+     */
+    template <class Backend, class Grid, class Inf, class Diag, class Sup, class Rhs, class Out>
+    class tridiagonal_solver {
+        GT_STATIC_ASSERT((conjunction<is_plh<Inf>, is_plh<Diag>, is_plh<Sup>, is_plh<Rhs>, is_plh<Out>>::value),
+            "the arguments of a tridiagonal solver should be placeholders");
+
+        using data_store_t = typename Rhs::data_store_t;
+        using location_t = typename Rhs::location_t;
+        using interval_t = typename Grid::interval_t;
+
+        template <uint_t I>
+        using scratch_arg = plh<tridiagonal_solver_impl_::scratch_tag<I>, data_store_t, location_t>;
+        using step_arg = plh<tridiagonal_solver_impl_::step_tag,
+            global_parameter<tridiagonal_solver_impl_::pcr_step_params>,
+            location_t>;
+
+        // the reduced systems are stored alternately in the first and in the second half of the scratch fields. Every
+        // step is a computation on its own: the steps read the rows at a distance along k, hence a step has to be
+        // completed before the next one starts, which is not guaranteed for the multistages of a single computation.
+        using pcr_first_t = computation<Inf,
+            Diag,
+            Sup,
+            Rhs,
+            scratch_arg<4>,
+            scratch_arg<5>,
+            scratch_arg<6>,
+            scratch_arg<7>,
+            step_arg>;
+        using pcr_next_t = computation<scratch_arg<0>,
+            scratch_arg<1>,
+            scratch_arg<2>,
+            scratch_arg<3>,
+            scratch_arg<4>,
+            scratch_arg<5>,
+            scratch_arg<6>,
+            scratch_arg<7>,
+            step_arg>;
+        using pcr_solve_t = computation<scratch_arg<1>, scratch_arg<3>, Out>;
+
+        Grid m_grid;
+        tridiagonal_method m_method;
+        computation<Inf, Diag, Sup, Rhs, Out> m_thomas;
+        pcr_first_t m_pcr_first;
+        pcr_next_t m_pcr_next;
+        pcr_solve_t m_pcr_solve;
+        std::array<data_store_t, 8> m_scratch;
+        typename timer_traits<Backend>::timer_type m_meter{"tridiagonal_solver"};
+
+        // `pcr_step` reads its inputs at the run time distance `stride` along k, beyond the declared extents. Hence the
+        // inputs have to be fields that are entirely computed before the step runs: no temporaries (they are only
+        // allocated and filled within the declared extents) and no k caches (they only hold the declared levels).
+        template <class Inputs>
+        static auto make_pcr_step(Grid const &grid, Inputs) {
+            using namespace tridiagonal_solver_impl_;
+            GT_STATIC_ASSERT((meta::all_of<meta::not_<is_tmp_arg>::apply, Inputs>::value),
+                "the inputs of a cyclic reduction step may not be temporaries");
+            return make_positional_computation<Backend>(grid,
+                make_multistage(execute::parallel(),
+                    make_stage<pcr_step>(meta::at_c<Inputs, 0>(),
+                        meta::at_c<Inputs, 1>(),
+                        meta::at_c<Inputs, 2>(),
+                        meta::at_c<Inputs, 3>(),
+                        scratch_arg<4>(),
+                        scratch_arg<5>(),
+                        scratch_arg<6>(),
+                        scratch_arg<7>(),
+                        step_arg())));
+        }
+
+        void init_thomas() {
+            using namespace tridiagonal_solver_impl_;
+            using c_arg = tmp_plh<c_tag, typename data_store_t::data_t, location_t>;
+            using d_arg = tmp_plh<d_tag, typename data_store_t::data_t, location_t>;
+            m_thomas = make_computation<Backend>(m_grid,
+                make_multistage(execute::forward(),
+                    define_caches(cache<cache_type::k, cache_io_policy::flush>(c_arg(), d_arg())),
+                    make_stage<thomas_forward<interval_t>>(Inf(), Diag(), Sup(), Rhs(), c_arg(), d_arg())),
+                make_multistage(execute::backward(),
+                    define_caches(cache<cache_type::k, cache_io_policy::fill>(c_arg(), d_arg())),
+                    make_stage<thomas_backward<interval_t>>(c_arg(), d_arg(), Out())));
+        }
+
+        void init_cyclic_reduction() {
+            using namespace tridiagonal_solver_impl_;
+            m_pcr_first = make_pcr_step(m_grid, meta::list<Inf, Diag, Sup, Rhs>());
+            m_pcr_next =
+                make_pcr_step(m_grid, meta::list<scratch_arg<0>, scratch_arg<1>, scratch_arg<2>, scratch_arg<3>>());
+            m_pcr_solve = make_computation<Backend>(m_grid,
+                make_multistage(execute::parallel(), make_stage<pcr_solve>(scratch_arg<1>(), scratch_arg<3>(), Out())));
+        }
+
+        global_parameter<tridiagonal_solver_impl_::pcr_step_params> step_params(int_t stride) const {
+            int_t k_first = at_key<dim::k>(m_grid.origin());
+            return make_global_parameter(
+                tridiagonal_solver_impl_::pcr_step_params{stride, k_first, k_first + (int_t)m_grid.k_size() - 1});
+        }
+
+        template <class... Args>
+        void run_cyclic_reduction(Args const &... args) {
+            data_store_t const &rhs = tridiagonal_solver_impl_::get_data_store<Rhs>(args...);
+            if (!m_scratch[0].valid() || m_scratch[0].info() != rhs.info())
+                for (auto &scratch : m_scratch)
+                    scratch = data_store_t(rhs.info());
+
+            // `in` and `out` are the offsets of the input and of the output system in the scratch fields
+            int_t in = 0;
+            int_t out = 4;
+            m_pcr_first.run(get_arg<Inf>(args...),
+                get_arg<Diag>(args...),
+                get_arg<Sup>(args...),
+                get_arg<Rhs>(args...),
+                scratch_arg<4>() = m_scratch[out],
+                scratch_arg<5>() = m_scratch[out + 1],
+                scratch_arg<6>() = m_scratch[out + 2],
+                scratch_arg<7>() = m_scratch[out + 3],
+                step_arg() = step_params(1));
+            int_t n = m_grid.k_size();
+            for (int_t s = 2; s < n; s *= 2) {
+                std::swap(in, out);
+                m_pcr_next.run(scratch_arg<0>() = m_scratch[in],
+                    scratch_arg<1>() = m_scratch[in + 1],
+                    scratch_arg<2>() = m_scratch[in + 2],
+                    scratch_arg<3>() = m_scratch[in + 3],
+                    scratch_arg<4>() = m_scratch[out],
+                    scratch_arg<5>() = m_scratch[out + 1],
+                    scratch_arg<6>() = m_scratch[out + 2],
+                    scratch_arg<7>() = m_scratch[out + 3],
+                    step_arg() = step_params(s));
+            }
+            m_pcr_solve.run(scratch_arg<1>() = m_scratch[out + 1],
+                scratch_arg<3>() = m_scratch[out + 3],
+                get_arg<Out>(args...));
+        }
+
+        template <class Plh, class... Args>
+        static auto get_arg(Args const &... args) {
+            return arg_storage_pair<Plh, typename Plh::data_store_t const &>{
+                tridiagonal_solver_impl_::get_data_store<Plh>(args...)};
+        }
+
+      public:
+        tridiagonal_solver(Grid grid, tridiagonal_method method)
+            : m_grid(std::move(grid)),
+              m_method(method == tridiagonal_method::automatic
+                           ? select_tridiagonal_method(m_grid, tridiagonal_solver_impl_::default_concurrency())
+                           : method) {
+            if (m_method == tridiagonal_method::thomas)
+                init_thomas();
+            else
+                init_cyclic_reduction();
+        }
+
+        tridiagonal_solver(tridiagonal_solver &&) = default;
+        tridiagonal_solver &operator=(tridiagonal_solver &&) = default;
+
+        /**
+         *  The method that is used, `tridiagonal_method::automatic` is resolved at construction.
+         */
+        tridiagonal_method method() const { return m_method; }
+
+        template <class... Args, class... DataStores>
+        std::enable_if_t<sizeof...(Args) == 5> run(arg_storage_pair<Args, DataStores> const &... args) {
+            m_meter.start();
+            if (m_method == tridiagonal_method::thomas)
+                m_thomas.run(args...);
+            else
+                run_cyclic_reduction(args...);
+            m_meter.pause();
+        }
+
+        std::string print_meter() const { return m_meter.to_string(); }
+        double get_time() const { return m_meter.total_time(); }
+        size_t get_count() const { return m_meter.count(); }
+        void reset_meter() { m_meter.reset(); }
+
+        template <class Arg>
+        rt_extent get_arg_extent(Arg) const {
+            return {};
+        }
+
+        template <class Arg>
+        intent get_arg_intent(Arg) const {
+            return std::is_same<Arg, Out>::value ? intent::inout : intent::in;
+        }
+    };
+
+    /**
+     *  Creates a solver for the tridiagonal systems along the columns of `grid`, see the description at the top of the
+     *  file.
+     */
+    template <class Backend, class Grid, class Inf, class Diag, class Sup, class Rhs, class Out>
+    tridiagonal_solver<Backend, Grid, Inf, Diag, Sup, Rhs, Out> make_tridiagonal_solver(Grid grid,
+        Inf,
+        Diag,
+        Sup,
+        Rhs,
+        Out,
+        tridiagonal_method method = tridiagonal_method::automatic) {
+        GT_STATIC_ASSERT(is_grid<Grid>::value, "the first argument of make_tridiagonal_solver should be a grid");
+        return {std::move(grid), method};
+    }
+} // namespace gridtools
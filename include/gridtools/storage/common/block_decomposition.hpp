@@ -0,0 +1,66 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cassert>
+
+#include "../../common/defs.hpp"
+#include "../../common/host_device.hpp"
+
+namespace gridtools {
+
+    /** \ingroup storage
+     * @{
+     */
+
+    /**
+     * @brief A decomposition of the horizontal domain into (i, j)-blocks.
+     *
+     * The default decomposition is used by the mc backend to distribute the computations and by the mc storage to
+     * place the pages of the fields on the NUMA nodes of the threads that will work on them.
+     */
+    struct block_decomposition {
+        int_t i_block_size;
+        int_t j_block_size;
+        int_t i_blocks;
+        int_t j_blocks;
+
+        /**
+         * @brief The decomposition with the given block sizes.
+         */
+        GT_FORCE_INLINE static block_decomposition with_block_sizes(
+            int_t i_size, int_t j_size, int_t i_block_size, int_t j_block_size) {
+            assert(i_block_size > 0 && j_block_size > 0);
+            return {i_block_size,
+                j_block_size,
+                (i_size + i_block_size - 1) / i_block_size,
+                (j_size + j_block_size - 1) / j_block_size};
+        }
+
+        /**
+         * @brief The default decomposition for `threads` threads.
+         *
+         * If the domain is large enough (relative to the number of threads), it is split only along the j-axis (for
+         * prefetching reasons), smaller domains are also split along the i-axis.
+         */
+        GT_FORCE_INLINE static block_decomposition make_default(int_t i_size, int_t j_size, int_t threads) {
+            int_t j_block_size = (j_size + threads - 1) / threads;
+            int_t j_blocks = (j_size + j_block_size - 1) / j_block_size;
+            int_t max_i_blocks = threads / j_blocks;
+            int_t i_block_size = (i_size + max_i_blocks - 1) / max_i_blocks;
+            return with_block_sizes(i_size, j_size, i_block_size, j_block_size);
+        }
+    };
+
+    /**
+     * @}
+     */
+} // namespace gridtools
@@ -0,0 +1,117 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <type_traits>
+
+#include "../../common/defs.hpp"
+#include "../../common/generic_metafunctions/accumulate.hpp"
+#include "../../common/generic_metafunctions/is_all_integrals.hpp"
+#include "../../common/gt_assert.hpp"
+#include "../../common/host_device.hpp"
+#include "../../common/integral_constant.hpp"
+#include "../../common/layout_map.hpp"
+#include "../../common/tuple.hpp"
+#include "../../meta/type_traits.hpp"
+#include "storage_info.hpp"
+
+namespace gridtools {
+
+    /** \ingroup storage
+     * @{
+     */
+
+    namespace fixed_storage_info_impl_ {
+        /*
+         * The stride of a dimension is the product of the padded lengths of all the dimensions that come after it in
+         * the layout. Only the dimension with the largest layout value is padded.
+         */
+        template <typename Align, typename Layout, uint_t... Sizes>
+        struct stride_f;
+
+        template <typename Align, int... LayoutArgs, uint_t... Sizes>
+        struct stride_f<Align, layout_map<LayoutArgs...>, Sizes...> {
+            static constexpr int_t padded_length(int layout_arg, uint_t size) {
+                return Align::value > 1 && layout_arg == layout_map<LayoutArgs...>::max()
+                           ? (size + Align::value - 1) / Align::value * Align::value
+                           : size;
+            }
+
+            static constexpr int_t apply(int layout_arg) {
+                return layout_arg < 0 ? 0
+                                      : accumulate(multiplies(),
+                                            int_t(1),
+                                            (LayoutArgs > layout_arg ? padded_length(LayoutArgs, Sizes) : int_t(1))...);
+            }
+        };
+    } // namespace fixed_storage_info_impl_
+
+    /**
+     * @brief A storage info for fixed-size domains. The total lengths (including the halo) are given at compile time,
+     * hence also the strides are known at compile time. The strides of data stores with a fixed_storage_info are
+     * exposed as `integral_constant`s to the SID interface, such that all the address computations of the stencils
+     * can be folded by the compiler.
+     *
+     * Apart from the constructors, a fixed_storage_info behaves exactly like the storage info it is based on.
+     *
+     * @tparam StorageInfo the storage info that defines the layout, the halo, and the alignment
+     * @tparam Sizes the total lengths of the dimensions
+     */
+    template <typename StorageInfo, uint_t... Sizes>
+    struct fixed_storage_info;
+
+    template <uint_t Id, int... LayoutArgs, typename Halo, typename Align, uint_t... Sizes>
+    struct fixed_storage_info<storage_info<Id, layout_map<LayoutArgs...>, Halo, Align>, Sizes...>
+        : storage_info<Id, layout_map<LayoutArgs...>, Halo, Align> {
+        using base_t = storage_info<Id, layout_map<LayoutArgs...>, Halo, Align>;
+
+        GT_STATIC_ASSERT(sizeof...(Sizes) == base_t::ndims, "The number of sizes does not match the layout.");
+        GT_STATIC_ASSERT(conjunction<bool_constant<(Sizes > 0)>...>::value, "Sizes have to be positive.");
+
+        /**
+         * @brief the strides of the dimensions as a tuple of `integral_constant`s
+         */
+        using fixed_strides_t = tuple<integral_constant<int_t,
+            fixed_storage_info_impl_::stride_f<Align, layout_map<LayoutArgs...>, Sizes...>::apply(LayoutArgs)>...>;
+
+        GT_FUNCTION constexpr fixed_storage_info() : base_t(Sizes...) {}
+
+        /**
+         * @brief constructor taking the sizes at run time, as the other storage infos do. The given sizes have to
+         * match the sizes of the type.
+         */
+        template <typename... Dims,
+            std::enable_if_t<sizeof...(Dims) == base_t::ndims && is_all_integral_or_enum<Dims...>::value, int> = 0>
+        fixed_storage_info(Dims... dims) : base_t(Sizes...) {
+            uint_t const given[] = {static_cast<uint_t>(dims)...};
+            uint_t const expected[] = {Sizes...};
+            for (uint_t i = 0; i < base_t::ndims; ++i)
+                GT_ASSERT_OR_THROW(given[i] == expected[i],
+                    "The sizes of a fixed_storage_info do not match the sizes of its type.");
+        }
+
+        /**
+         * @brief the stride of a dimension as a compile time constant
+         */
+        template <uint_t Dim>
+        static constexpr int_t fixed_stride() {
+            GT_STATIC_ASSERT(Dim < base_t::ndims, GT_INTERNAL_ERROR_MSG("Out of bounds access in fixed stride call."));
+            return fixed_storage_info_impl_::stride_f<Align, layout_map<LayoutArgs...>, Sizes...>::apply(
+                layout_map<LayoutArgs...>::template at<Dim>());
+        }
+    };
+
+    template <typename StorageInfo, uint_t... Sizes>
+    struct is_storage_info<fixed_storage_info<StorageInfo, Sizes...>> : std::true_type {};
+
+    /**
+     * @}
+     */
+} // namespace gridtools
@@ -82,6 +82,19 @@ namespace gridtools {
          */
         void swap(storage_interface &other) { static_cast<Derived *>(this)->swap_impl(static_cast<Derived &>(other)); }
 
+        /*
+         * @brief This method is called once after the allocation of the storage. Storages may use it to place the
+         * memory pages (e.g., on NUMA systems by the first touch), the default implementation does nothing.
+         * @param info the storage info the storage was allocated for
+         */
+        template <typename StorageInfo>
+        void first_touch(StorageInfo const &info) {
+            static_cast<Derived *>(this)->first_touch_impl(info);
+        }
+
+        template <typename StorageInfo>
+        void first_touch_impl(StorageInfo const &) {}
+
         /*
          * @brief This method returns information about validity of the storage (e.g., no nullptrs, etc.).
          * @return true if the storage is valid, false otherwise
@@ -100,7 +100,9 @@ namespace gridtools {
         data_store(StorageInfo const &info, std::string const &name = "")
             : m_shared_storage(new storage_t(
                   info.padded_total_length(), info.first_index_of_inner_region(), typename StorageInfo::alignment_t{})),
-              m_shared_storage_info(new storage_info_t(info)), m_name(name) {}
+              m_shared_storage_info(new storage_info_t(info)), m_name(name) {
+            m_shared_storage->first_touch(info);
+        }
 
         /**
          * @brief data_store constructor. This constructor triggers an allocation of the required space.
@@ -160,6 +162,7 @@ namespace gridtools {
             m_shared_storage = std::make_shared<storage_t>(m_shared_storage_info->padded_total_length(),
                 m_shared_storage_info->first_index_of_inner_region(),
                 typename StorageInfo::alignment_t{});
+            m_shared_storage->first_touch(info);
         }
 
         /**
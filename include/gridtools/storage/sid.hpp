@@ -23,6 +23,7 @@
 #include "../meta/macros.hpp"
 #include "../meta/make_indices.hpp"
 #include "../meta/transform.hpp"
+#include "common/fixed_storage_info.hpp"
 #include "data_store.hpp"
 
 namespace gridtools {
@@ -196,6 +197,15 @@ namespace gridtools {
         return storage_sid_impl_::convert_strides_f<typename StorageInfo::layout_t>{}(obj.strides());
     }
 
+    /**
+     *   The strides of a data store with a fixed size are compile time constants
+     */
+    template <class Storage, class StorageInfo, uint_t... Sizes>
+    typename fixed_storage_info<StorageInfo, Sizes...>::fixed_strides_t sid_get_strides(
+        data_store<Storage, fixed_storage_info<StorageInfo, Sizes...>> const &) {
+        return {};
+    }
+
     template <class Storage, class StorageInfo>
     StorageInfo sid_get_strides_kind(data_store<Storage, StorageInfo> const &);
 
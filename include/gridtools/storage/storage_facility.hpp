@@ -12,6 +12,7 @@
 
 #include "../common/layout_map.hpp"
 #include "common/definitions.hpp"
+#include "common/fixed_storage_info.hpp"
 #include "common/halo.hpp"
 #include "data_store.hpp"
 
@@ -62,6 +63,12 @@ namespace gridtools {
         using special_storage_info_t = typename gridtools::storage_traits_from_id<
             Backend>::template select_special_storage_info<Id, Selector, Halo>::type;
 
+        /**
+         * storage info with the total lengths `Sizes` fixed at compile time, see fixed_storage_info
+         */
+        template <uint_t Id, typename Halo, uint_t... Sizes>
+        using fixed_storage_info_t = fixed_storage_info<storage_info_t<Id, sizeof...(Sizes), Halo>, Sizes...>;
+
         template <typename ValueType, typename StorageInfo>
         using data_store_t = data_store<storage_t<ValueType>, StorageInfo>;
 
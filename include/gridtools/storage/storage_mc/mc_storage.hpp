@@ -10,21 +10,111 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <type_traits>
 #include <utility>
 
+#include "../../common/defs.hpp"
 #include "../../common/gt_assert.hpp"
 #include "../../common/hugepage_alloc.hpp"
+#include "../common/block_decomposition.hpp"
 #include "../common/state_machine.hpp"
 #include "../common/storage_interface.hpp"
 
 namespace gridtools {
 
+    /**
+     * @brief NUMA placement policies for mc_storage.
+     *
+     * Memory pages are placed on the NUMA node of the thread that touches them first.
+     * - `blocked`: the pages are first touched with the same (i, j)-block decomposition the mc backend uses for
+     *   the computations, so the threads mostly work on local memory. This is the default.
+     * - `interleave`: the pages are first touched round robin by all threads. Use it for fields that are accessed by
+     *   all threads, e.g. fields that are read with large horizontal extents or without the stencil machinery.
+     */
+    enum class numa_placement { blocked, interleave };
+
+    namespace mc_storage_impl_ {
+        // the granularity of the interleaving: hugepage_alloc encourages the system to use 2MB pages
+        constexpr std::size_t interleave_page_size = 2 * 1024 * 1024;
+
+        template <typename DataType>
+        void interleaved_first_touch(DataType *ptr, std::size_t size) {
+            std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(ptr);
+            std::uintptr_t end = reinterpret_cast<std::uintptr_t>(ptr + size);
+            std::uintptr_t first_page = begin / interleave_page_size;
+            std::uintptr_t pages = (end + interleave_page_size - 1) / interleave_page_size - first_page;
+#pragma omp parallel for schedule(static, 1)
+            for (std::uintptr_t page = 0; page < pages; ++page) {
+                std::uintptr_t page_begin = std::max(begin, (first_page + page) * interleave_page_size);
+                std::uintptr_t page_end = std::min(end, (first_page + page + 1) * interleave_page_size);
+                for (auto *p = reinterpret_cast<DataType *>(page_begin); p < reinterpret_cast<DataType *>(page_end);
+                     ++p)
+                    *p = DataType();
+            }
+        }
+
+        /**
+         * @brief Touches the elements with the default block decomposition of the mc backend, in the same order as
+         * its k-serial loops do. The halo points go to the blocks at the domain boundaries.
+         */
+        template <typename DataType, typename StorageInfo, std::enable_if_t<(StorageInfo::ndims >= 2), int> = 0>
+        void blocked_first_touch(DataType *ptr, StorageInfo const &info) {
+            auto const &strides = info.strides();
+            auto const &padded_lengths = info.padded_lengths();
+            if (strides[0] == 0 || strides[1] == 0) {
+                interleaved_first_touch(ptr, info.padded_total_length());
+                return;
+            }
+            std::size_t rest_size = 1;
+            for (uint_t d = 2; d < StorageInfo::ndims; ++d)
+                if (strides[d])
+                    rest_size *= padded_lengths[d];
+
+            int_t i_halo = info.template begin<0>();
+            int_t j_halo = info.template begin<1>();
+            auto blocks = block_decomposition::make_default(
+                info.template length<0>(), info.template length<1>(), omp_get_max_threads());
+            int_t i_blocks = blocks.i_blocks;
+            int_t j_blocks = blocks.j_blocks;
+#pragma omp parallel for collapse(2)
+            for (int_t bj = 0; bj < j_blocks; ++bj) {
+                for (int_t bi = 0; bi < i_blocks; ++bi) {
+                    int_t i_begin = bi == 0 ? 0 : i_halo + bi * blocks.i_block_size;
+                    int_t i_end = bi + 1 == i_blocks ? padded_lengths[0] : i_halo + (bi + 1) * blocks.i_block_size;
+                    int_t j_begin = bj == 0 ? 0 : j_halo + bj * blocks.j_block_size;
+                    int_t j_end = bj + 1 == j_blocks ? padded_lengths[1] : j_halo + (bj + 1) * blocks.j_block_size;
+                    for (std::size_t r = 0; r < rest_size; ++r) {
+                        std::size_t offset = 0;
+                        std::size_t rest = r;
+                        for (uint_t d = 2; d < StorageInfo::ndims; ++d) {
+                            if (strides[d]) {
+                                offset += rest % padded_lengths[d] * strides[d];
+                                rest /= padded_lengths[d];
+                            }
+                        }
+                        for (int_t j = j_begin; j < j_end; ++j)
+                            for (int_t i = i_begin; i < i_end; ++i)
+                                ptr[offset + i * strides[0] + j * strides[1]] = DataType();
+                    }
+                }
+            }
+        }
+
+        template <typename DataType, typename StorageInfo, std::enable_if_t<(StorageInfo::ndims < 2), int> = 0>
+        void blocked_first_touch(DataType *ptr, StorageInfo const &info) {
+            interleaved_first_touch(ptr, info.padded_total_length());
+        }
+    } // namespace mc_storage_impl_
+
     /*
      * @brief The Mic storage implementation. This class owns the pointer
      * to the data. Additionally there is a field that contains information about
      * the ownership. Instances of this class are noncopyable.
      * @tparam DataType the type of the data and the pointer respectively (e.g., float or double)
+     * @tparam Placement NUMA placement policy of the allocated memory
      *
      * Here we are using the CRTP. Actually the same
      * functionality could be implemented using standard inheritance
@@ -32,8 +122,8 @@ namespace gridtools {
      * gridtools pattern and we clearly want to avoid virtual
      * methods, etc.
      */
-    template <typename DataType>
-    struct mc_storage : storage_interface<mc_storage<DataType>> {
+    template <typename DataType, numa_placement Placement = numa_placement::blocked>
+    struct mc_storage : storage_interface<mc_storage<DataType, Placement>> {
         typedef DataType data_t;
         typedef state_machine state_machine_t;
 
@@ -69,6 +159,19 @@ namespace gridtools {
             assert(own == ownership::external_cpu);
         }
 
+        /*
+         * @brief first_touch implementation for mc_storage. Places the pages according to the placement policy.
+         */
+        template <typename StorageInfo>
+        void first_touch_impl(StorageInfo const &info) {
+            if (!m_holder)
+                return;
+            if (Placement == numa_placement::blocked)
+                mc_storage_impl_::blocked_first_touch(m_ptr, info);
+            else
+                mc_storage_impl_::interleaved_first_touch(m_ptr, info.padded_total_length());
+        }
+
         /*
          * @brief swap implementation for mc_storage
          */
@@ -135,6 +238,6 @@ namespace gridtools {
     template <typename T>
     struct is_mc_storage : std::false_type {};
 
-    template <typename T>
-    struct is_mc_storage<mc_storage<T>> : std::true_type {};
+    template <typename T, numa_placement Placement>
+    struct is_mc_storage<mc_storage<T, Placement>> : std::true_type {};
 } // namespace gridtools
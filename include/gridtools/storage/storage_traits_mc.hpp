@@ -15,6 +15,7 @@
 #include "../common/selector.hpp"
 #include "./common/halo.hpp"
 #include "./common/storage_traits_metafunctions.hpp"
+#include "./data_store.hpp"
 #include "./storage_mc/mc_storage.hpp"
 #include "./storage_mc/mc_storage_info.hpp"
 
@@ -35,14 +36,21 @@ namespace gridtools {
     } // namespace impl
 
     /** @brief storage traits for the Mic backend*/
-    template <>
-    struct storage_traits_from_id<backend::mc> {
+    template <class... Params>
+    struct storage_traits_from_id<mc::backend<Params...>> {
 
-        template <typename ValueType>
+        template <typename ValueType, numa_placement Placement = numa_placement::blocked>
         struct select_storage {
-            using type = mc_storage<ValueType>;
+            using type = mc_storage<ValueType, Placement>;
         };
 
+        /**
+         * @brief data store type with an explicitly selected NUMA placement policy, e.g.
+         * `storage_traits<backend::mc>::numa_data_store_t<double, storage_info_t, numa_placement::interleave>`
+         */
+        template <typename ValueType, typename StorageInfo, numa_placement Placement>
+        using numa_data_store_t = data_store<typename select_storage<ValueType, Placement>::type, StorageInfo>;
+
         template <uint_t Id, uint_t Dims, typename Halo>
         struct select_storage_info {
             GT_STATIC_ASSERT(is_halo<Halo>::value, "Given type is not a halo type.");
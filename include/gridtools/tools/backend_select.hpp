@@ -19,12 +19,19 @@ using float_type = double;
 #error float precision not properly set (4 or 8 bytes supported)
 #endif
 
+// block schedule of the cpu backends, used to benchmark the regression stencils with the different schedules
+#ifndef GT_BLOCK_SCHEDULE
+#define GT_BLOCK_SCHEDULE static_
+#endif
+
 #ifdef GT_BACKEND_X86
-using backend_t = gridtools::backend::x86;
+using backend_t = gridtools::x86::backend<gridtools::backend::x86::i_block_size_t,
+    gridtools::backend::x86::j_block_size_t,
+    gridtools::schedule::GT_BLOCK_SCHEDULE>;
 #elif defined(GT_BACKEND_NAIVE)
 using backend_t = gridtools::backend::naive;
 #elif defined(GT_BACKEND_MC)
-using backend_t = gridtools::backend::mc;
+using backend_t = gridtools::mc::backend<gridtools::schedule::GT_BLOCK_SCHEDULE>;
 #elif defined(GT_BACKEND_CUDA)
 using backend_t = gridtools::backend::cuda;
 #endif
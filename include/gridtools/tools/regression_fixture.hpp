@@ -23,6 +23,9 @@ namespace gridtools {
       public:
         regression_fixture() : computation_fixture<HaloSize, Axis>(s_d1, s_d2, s_d3) {}
 
+        /// for regressions with a fixed domain size, the sizes from the command line are ignored
+        regression_fixture(uint_t d1, uint_t d2, uint_t d3) : computation_fixture<HaloSize, Axis>(d1, d2, d3) {}
+
         template <class... Args>
         void verify(Args &&... args) const {
             if (s_needs_verification)
@@ -44,6 +47,8 @@ namespace gridtools {
                 comp.run();
             }
             std::cout << comp.print_meter() << std::endl;
+            if (comp.get_time() > 0)
+                std::cout << comp.print_roofline() << std::endl;
         }
     };
 } // namespace gridtools
@@ -60,3 +60,31 @@ TEST_F(advection_pdbott_prepare_tracers, test) {
 
     benchmark(comp);
 }
+
+TEST_F(advection_pdbott_prepare_tracers, parallel) {
+    using storages_t = std::vector<storage_type>;
+
+    arg<0, storages_t> p_out;
+    arg<1, storages_t> p_in;
+    arg<2, storage_type> p_rho;
+
+    storages_t in, out;
+
+    for (size_t i = 0; i < 11; ++i) {
+        out.push_back(make_storage());
+        in.push_back(make_storage(1. * i));
+    }
+
+    auto comp = gridtools::make_expandable_computation<backend_t>(parallel_expand_factor<2>(),
+        make_grid(),
+        p_out = out,
+        p_in = in,
+        p_rho = make_storage(1.1),
+        make_multistage(execute::parallel(), make_stage<prepare_tracers>(p_out, p_in, p_rho)));
+
+    comp.run();
+    for (size_t i = 0; i != out.size(); ++i)
+        verify(make_storage([i](int_t, int_t, int_t) { return 1.1 * i; }), out[i]);
+
+    benchmark(comp);
+}
@@ -0,0 +1,152 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <iostream>
+#include <mpi.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <gridtools/common/array.hpp>
+#include <gridtools/common/boollist.hpp>
+#include <gridtools/communication/all_to_all_halo.hpp>
+#include <gridtools/communication/low_level/proc_grids_3D.hpp>
+
+/*
+  Gathers the tiles of all the processes into a global field on the first process, as done to write the output of a
+  time step, `iterations` times with the same all_to_all_halo pattern. The tiles are changed between the iterations
+  and every block is checked on the first process as soon as it arrives. The setup time and the time of a single
+  redistribution are printed by the first process. Thousands of processes can be simulated by oversubscription, e.g.,
+
+      mpirun --oversubscribe -np 2048 benchmark_all_to_all_halo_3D 4 2 10
+*/
+
+namespace benchmark_all_to_all_halo_3D {
+    typedef gridtools::array<gridtools::halo_descriptor, 3> halo_block;
+    typedef gridtools::MPI_3D_process_grid_t<3> grid_type;
+
+    bool test(int N, int H, int iterations) {
+        gridtools::array<int, 3> dims{0, 0, 0};
+        grid_type pgrid(gridtools::boollist<3>(true, true, true), gridtools::GCL_WORLD, dims);
+
+        int pi, pj, pk;
+        int PI, PJ, PK;
+        pgrid.coords(pi, pj, pk);
+        pgrid.dims(PI, PJ, PK);
+
+        int M = N + 2 * H;
+        int stride0 = PJ * N * PK * N;
+        int stride1 = PK * N;
+        auto global_index = [&](int ci, int cj, int ck, int i, int j, int k) {
+            return (ci * N + i) * stride0 + (cj * N + j) * stride1 + ck * N + k;
+        };
+
+        std::vector<int> tile(M * M * M, -1);
+        std::vector<int> global(gridtools::PID == 0 ? PI * N * PJ * N * PK * N : 0);
+
+        MPI_Barrier(gridtools::GCL_WORLD);
+        double start = MPI_Wtime();
+
+        gridtools::all_to_all_halo<int, grid_type> a2a(pgrid, gridtools::GCL_WORLD);
+        gridtools::array<int, 3> crds{0, 0, 0};
+
+        halo_block send_block;
+        for (int d = 0; d < 3; ++d)
+            send_block[d] = gridtools::halo_descriptor(H, H, H, N + H - 1, M);
+        a2a.register_block_to(&tile[0], send_block, crds);
+
+        if (gridtools::PID == 0) {
+            halo_block recv_block;
+            for (int i = 0; i < PI; ++i)
+                for (int j = 0; j < PJ; ++j)
+                    for (int k = 0; k < PK; ++k) {
+                        crds[0] = i;
+                        crds[1] = j;
+                        crds[2] = k;
+                        recv_block[0] = gridtools::halo_descriptor(0, 0, i * N, (i + 1) * N - 1, PI * N);
+                        recv_block[1] = gridtools::halo_descriptor(0, 0, j * N, (j + 1) * N - 1, PJ * N);
+                        recv_block[2] = gridtools::halo_descriptor(0, 0, k * N, (k + 1) * N - 1, PK * N);
+                        a2a.register_block_from(&global[0], recv_block, crds);
+                    }
+        }
+        a2a.setup();
+        double setup_time = MPI_Wtime() - start;
+
+        int correct = 1;
+        int arrived = 0;
+        double time = 0;
+        for (int it = 0; it < iterations; ++it) {
+            for (int i = 0; i < N; ++i)
+                for (int j = 0; j < N; ++j)
+                    for (int k = 0; k < N; ++k)
+                        tile[((i + H) * M + j + H) * M + k + H] = global_index(pi, pj, pk, i, j, k) + it;
+
+            MPI_Barrier(gridtools::GCL_WORLD);
+            start = MPI_Wtime();
+            a2a.start_exchange();
+            a2a.wait([&](int proc) {
+                int c[3];
+                MPI_Cart_coords(pgrid.communicator(), proc, 3, c);
+                for (int i = 0; i < N; ++i)
+                    for (int j = 0; j < N; ++j)
+                        for (int k = 0; k < N; ++k) {
+                            int index = global_index(c[0], c[1], c[2], i, j, k);
+                            correct = correct && global[index] == index + it;
+                        }
+                ++arrived;
+            });
+            time += MPI_Wtime() - start;
+        }
+        if (gridtools::PID == 0)
+            correct = correct && arrived == PI * PJ * PK * iterations;
+
+        double max_times[2];
+        double times[2] = {setup_time, time / iterations};
+        MPI_Reduce(times, max_times, 2, MPI_DOUBLE, MPI_MAX, 0, gridtools::GCL_WORLD);
+        int all_correct;
+        MPI_Allreduce(&correct, &all_correct, 1, MPI_INT, MPI_LAND, gridtools::GCL_WORLD);
+
+        if (gridtools::PID == 0)
+            std::cout << "processes " << PI * PJ * PK << " (" << PI << "x" << PJ << "x" << PK << ")  tile " << N
+                      << "  halo " << H << "  setup [ms] " << max_times[0] * 1e3 << "  redistribution [ms] "
+                      << max_times[1] * 1e3 << (all_correct ? "" : "  MISMATCH") << std::endl;
+
+        return all_correct;
+    }
+} // namespace benchmark_all_to_all_halo_3D
+
+#ifdef STANDALONE
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+    gridtools::GCL_Init(argc, argv);
+
+    if (argc != 4) {
+        std::cout << "Usage: benchmark_all_to_all_halo_3D tile halo iterations\n where tile is the edge of the tile of "
+                     "each process without halos"
+                  << std::endl;
+        return 1;
+    }
+    int N = atoi(argv[1]);
+    int H = atoi(argv[2]);
+    int iterations = atoi(argv[3]);
+
+    bool passed = benchmark_all_to_all_halo_3D::test(N, H, iterations);
+
+    MPI_Barrier(gridtools::GCL_WORLD);
+    gridtools::GCL_Finalize();
+
+    return !passed;
+}
+#else
+TEST(Communication, benchmark_all_to_all_halo_3D) {
+    bool passed = benchmark_all_to_all_halo_3D::test(6, 2, 5);
+    EXPECT_TRUE(passed);
+}
+#endif
@@ -0,0 +1,163 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <iomanip>
+#include <iostream>
+#include <mpi.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <gridtools/communication/halo_exchange.hpp>
+
+/*
+  Compares the halo exchange with packing into buffers (version_manual) against the one sending directly from the
+  fields with MPI derived datatypes (version_datatype), each with and without persistent requests, for several numbers
+  of fields and halo widths. The results of all the variants are checked to be the same, the timings are printed by
+  the first process.
+*/
+
+namespace benchmark_halo_exchange_3D {
+    template <int Version>
+    using pattern_t = gridtools::halo_exchange_dynamic_ut<gridtools::layout_map<0, 1, 2>,
+        gridtools::layout_map<0, 1, 2>,
+        double,
+        gridtools::gcl_cpu,
+        Version>;
+
+    typedef std::vector<std::vector<double>> fields_t;
+
+    fields_t make_fields(int num_fields, int DIM1, int DIM2, int DIM3, int H, int const *coords) {
+        fields_t fields(num_fields, std::vector<double>((DIM1 + 2 * H) * (DIM2 + 2 * H) * (DIM3 + 2 * H), -1));
+        for (int f = 0; f < num_fields; ++f)
+            for (int ii = H; ii < DIM1 + H; ++ii)
+                for (int jj = H; jj < DIM2 + H; ++jj)
+                    for (int kk = H; kk < DIM3 + H; ++kk)
+                        fields[f][(ii * (DIM2 + 2 * H) + jj) * (DIM3 + 2 * H) + kk] =
+                            f + 10 * (ii - H + DIM1 * coords[0]) + 1000 * (jj - H + DIM2 * coords[1]) +
+                            100000 * (kk - H + DIM3 * coords[2]);
+        return fields;
+    }
+
+    /**
+       Exchanges the halos of the fields `iterations` times, returns the time of a single exchange (pack, exchange,
+       unpack) of the slowest process.
+    */
+    template <int Version>
+    double run(
+        MPI_Comm CartComm, fields_t &fields, int DIM1, int DIM2, int DIM3, int H, int iterations, bool persistent) {
+        typedef pattern_t<Version> pattern_type;
+        pattern_type he(typename pattern_type::grid_type::period_type(true, true, true), CartComm);
+
+        he.template add_halo<0>(H, H, H, DIM1 + H - 1, DIM1 + 2 * H);
+        he.template add_halo<1>(H, H, H, DIM2 + H - 1, DIM2 + 2 * H);
+        he.template add_halo<2>(H, H, H, DIM3 + H - 1, DIM3 + 2 * H);
+
+        he.setup(fields.size());
+        he.use_persistent_requests(persistent);
+
+        std::vector<double *> ptrs;
+        for (auto &field : fields)
+            ptrs.push_back(field.data());
+
+        MPI_Barrier(CartComm);
+        double start = MPI_Wtime();
+        for (int i = 0; i < iterations; ++i) {
+            he.pack(ptrs);
+            he.exchange();
+            he.unpack(ptrs);
+        }
+        double time = (MPI_Wtime() - start) / iterations;
+
+        double max_time;
+        MPI_Allreduce(&time, &max_time, 1, MPI_DOUBLE, MPI_MAX, CartComm);
+        return max_time;
+    }
+
+    bool test(int DIM1, int DIM2, int DIM3, int iterations) {
+        int nprocs;
+        MPI_Comm_size(gridtools::GCL_WORLD, &nprocs);
+        int dims[3] = {0, 0, 0};
+        MPI_Dims_create(nprocs, 3, dims);
+        int period[3] = {1, 1, 1};
+        MPI_Comm CartComm;
+        MPI_Cart_create(gridtools::GCL_WORLD, 3, dims, period, false, &CartComm);
+        int coords[3];
+        MPI_Cart_get(CartComm, 3, dims, period, coords);
+
+        if (gridtools::PID == 0)
+            std::cout << "fields halo  times [ms]: manual  manual persistent  datatype  datatype persistent"
+                      << std::endl;
+
+        bool passed = true;
+        for (int num_fields : {1, 3, 8}) {
+            for (int H : {1, 2, 3}) {
+                fields_t initial = make_fields(num_fields, DIM1, DIM2, DIM3, H, coords);
+                fields_t reference = initial;
+                double times[4];
+                int same = 1;
+                for (int variant = 0; variant < 4; ++variant) {
+                    fields_t fields = initial;
+                    bool persistent = variant % 2;
+                    times[variant] = variant < 2 ? run<gridtools::version_manual>(
+                                                       CartComm, fields, DIM1, DIM2, DIM3, H, iterations, persistent)
+                                                 : run<gridtools::version_datatype>(
+                                                       CartComm, fields, DIM1, DIM2, DIM3, H, iterations, persistent);
+                    if (variant == 0)
+                        reference = fields;
+                    else
+                        same = same && fields == reference;
+                }
+
+                int all_same;
+                MPI_Allreduce(&same, &all_same, 1, MPI_INT, MPI_LAND, CartComm);
+                passed = passed && all_same;
+
+                if (gridtools::PID == 0) {
+                    std::cout << std::setw(6) << num_fields << std::setw(5) << H << std::setw(20) << times[0] * 1e3
+                              << std::setw(19) << times[1] * 1e3 << std::setw(10) << times[2] * 1e3 << std::setw(21)
+                              << times[3] * 1e3 << (all_same ? "" : "  MISMATCH") << std::endl;
+                }
+            }
+        }
+
+        MPI_Comm_free(&CartComm);
+        return passed;
+    }
+} // namespace benchmark_halo_exchange_3D
+
+#ifdef STANDALONE
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+    gridtools::GCL_Init(argc, argv);
+
+    if (argc != 5) {
+        std::cout << "Usage: benchmark_halo_exchange_3D dimx dimy dimz iterations\n where the first three arguments "
+                     "are the sizes of the data fields without halos"
+                  << std::endl;
+        return 1;
+    }
+    int DIM1 = atoi(argv[1]);
+    int DIM2 = atoi(argv[2]);
+    int DIM3 = atoi(argv[3]);
+    int iterations = atoi(argv[4]);
+
+    bool passed = benchmark_halo_exchange_3D::test(DIM1, DIM2, DIM3, iterations);
+
+    MPI_Finalize();
+
+    return !passed;
+}
+#else
+TEST(Communication, benchmark_halo_exchange_3D) {
+    bool passed = benchmark_halo_exchange_3D::test(12, 11, 10, 2);
+    EXPECT_TRUE(passed);
+}
+#endif
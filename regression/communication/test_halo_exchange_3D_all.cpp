@@ -53,6 +53,12 @@ namespace halo_exchange_3D_all {
     typedef gridtools::gcl_cpu arch_type;
 #endif
 
+#ifdef DATATYPE_VERSION
+    static constexpr int version = gridtools::version_datatype;
+#else
+    static constexpr int version = gridtools::version_manual;
+#endif
+
     template <typename ST, int I1, int I2, int I3, bool per0, bool per1, bool per2>
     bool run(ST &file,
         int DIM1,
@@ -99,7 +105,8 @@ namespace halo_exchange_3D_all {
         typedef gridtools::halo_exchange_dynamic_ut<layoutmap,
             gridtools::layout_map<0, 1, 2>,
             triple_t<USE_DOUBLE>::data_type,
-            arch_type>
+            arch_type,
+            version>
             pattern_type;
 
         /* The pattern is now instantiated with the periodicities and the
@@ -54,6 +54,12 @@ namespace halo_exchange_3D_all_2 {
     typedef gridtools::gcl_cpu arch_type;
 #endif
 
+#ifdef DATATYPE_VERSION
+    static constexpr int version = gridtools::version_datatype;
+#else
+    static constexpr int version = gridtools::version_manual;
+#endif
+
     template <typename ST, int I1, int I2, int I3, bool per0, bool per1, bool per2>
     bool run(ST &file,
         int DIM1,
@@ -103,7 +109,8 @@ namespace halo_exchange_3D_all_2 {
         typedef gridtools::halo_exchange_dynamic_ut<layoutmap,
             gridtools::layout_map<0, 1, 2>,
             triple_t<USE_DOUBLE>::data_type,
-            arch_type>
+            arch_type,
+            version>
             pattern_type;
 
         /* The pattern is now instantiated with the periodicities and the
@@ -200,11 +207,17 @@ namespace halo_exchange_3D_all_2 {
 
         gettimeofday(&start_tv, nullptr);
 
+#ifndef DATATYPE_VERSION
         he.post_receives();
+#endif
 #ifdef VECTOR_INTERFACE
         he.pack(vect);
 #else
         he.pack(vect[0], vect[1], vect[2]);
+#endif
+#ifdef DATATYPE_VERSION
+        // the data is received directly into the fields, which are known only after pack
+        he.post_receives();
 #endif
         //  MPI_Barrier(MPI_COMM_WORLD);
         gettimeofday(&stop1_tv, nullptr);
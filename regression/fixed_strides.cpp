@@ -0,0 +1,92 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/regression_fixture.hpp>
+
+/*
+  The same fourth order smoothing is computed on data stores with run time strides and on data stores with a
+  fixed_storage_info, whose strides are compile time constants. The domain size is fixed at compile time, the sizes
+  given on the command line are ignored. With a number of steps given on the command line, both variants are
+  benchmarked.
+*/
+
+using namespace gridtools;
+
+struct lap_function {
+    using out = inout_accessor<0>;
+    using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+    using param_list = make_param_list<out, in>;
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation eval) {
+        eval(out()) = 4 * eval(in()) - (eval(in(1, 0)) + eval(in(0, 1)) + eval(in(-1, 0)) + eval(in(0, -1)));
+    }
+};
+
+struct smooth_function {
+    using out = inout_accessor<0>;
+    using in = in_accessor<1>;
+    using lap = in_accessor<2, extent<-1, 1, -1, 1>>;
+    using param_list = make_param_list<out, in, lap>;
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation eval) {
+        eval(out()) = eval(in()) - float_type(.01) * (4 * eval(lap()) - (eval(lap(1, 0)) + eval(lap(0, 1)) +
+                                                                           eval(lap(-1, 0)) + eval(lap(0, -1))));
+    }
+};
+
+constexpr uint_t size_i = 132;
+constexpr uint_t size_j = 132;
+constexpr uint_t size_k = 80;
+
+struct fixed_strides : regression_fixture<2> {
+    fixed_strides() : regression_fixture<2>(size_i, size_j, size_k) {}
+
+    using fixed_storage_info_t = storage_tr::fixed_storage_info_t<0, halo_t, size_i, size_j, size_k>;
+    using fixed_storage_type = storage_tr::data_store_t<float_type, fixed_storage_info_t>;
+
+    template <class Storage>
+    void run(Storage &out) {
+        auto in = [](int_t i, int_t j, int_t k) { return i * i % 7 + j % 5 + k * .1; };
+        arg<0, Storage> p_out;
+        arg<1, Storage> p_in;
+        auto comp = make_computation(p_out = out,
+            p_in = make_storage<Storage>(in),
+            make_multistage(execute::parallel(),
+                make_stage<lap_function>(p_tmp_0, p_in),
+                make_stage<smooth_function>(p_out, p_in, p_tmp_0)));
+
+        comp.run();
+        auto lap = [in](int_t i, int_t j, int_t k) {
+            return 4 * in(i, j, k) - (in(i + 1, j, k) + in(i, j + 1, k) + in(i - 1, j, k) + in(i, j - 1, k));
+        };
+        auto ref = [in, lap](int_t i, int_t j, int_t k) {
+            return in(i, j, k) - .01 * (4 * lap(i, j, k) - (lap(i + 1, j, k) + lap(i, j + 1, k) + lap(i - 1, j, k) +
+                                                                 lap(i, j - 1, k)));
+        };
+        verify(make_storage<Storage>(ref), out);
+        benchmark(comp);
+    }
+};
+
+TEST_F(fixed_strides, test) {
+    std::cout << "run time strides" << std::endl;
+    auto out = make_storage();
+    run(out);
+
+    std::cout << "compile time strides" << std::endl;
+    auto fixed_out = make_storage<fixed_storage_type>();
+    run(fixed_out);
+}
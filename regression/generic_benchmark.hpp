@@ -11,16 +11,23 @@
 #pragma once
 
 #include <gridtools/common/timer/timer_traits.hpp>
+#include <gridtools/stencil_composition/roofline.hpp>
 
+#include <cstddef>
 #include <functional>
+#include <sstream>
 #include <string>
 
 namespace {
     template <typename Backend>
     class generic_benchmark {
       public:
+        /**
+         * If `bytes_per_run` (the memory traffic of a single call of `f`) is given, the achieved bandwidth is printed
+         * with the time.
+         */
         template <typename F>
-        generic_benchmark(F &&f) : m_f(f), m_meter("") {}
+        generic_benchmark(F &&f, std::size_t bytes_per_run = 0) : m_f(f), m_meter(""), m_bytes_per_run(bytes_per_run) {}
 
         void run() {
             m_meter.start();
@@ -28,12 +35,25 @@ namespace {
             m_meter.pause();
         }
         void reset_meter() { m_meter.reset(); }
-        std::string print_meter() { return m_meter.to_string(); }
+        double get_time() const { return m_meter.total_time(); }
+        std::string print_meter() {
+            std::ostringstream out;
+            out << m_meter.to_string();
+            if (m_bytes_per_run != 0 && m_meter.total_time() > 0)
+                out << "\t[GB/s]\t" << m_bytes_per_run * m_meter.count() / m_meter.total_time() * 1e-9;
+            return out.str();
+        }
+        std::string print_roofline(double peak = gridtools::peak_bandwidth(Backend())) const {
+            gridtools::traffic_estimate traffic;
+            traffic.bytes = m_bytes_per_run;
+            return gridtools::roofline_report{traffic, m_meter.total_time(), m_meter.count()}.to_string(peak);
+        }
 
       private:
         std::function<void()> m_f;
 
         using performance_meter_t = typename gridtools::timer_traits<Backend>::timer_type;
         performance_meter_t m_meter;
+        std::size_t m_bytes_per_run;
     };
 } // namespace
@@ -30,6 +30,12 @@ namespace {
         gridtools::interface::transform(
             dst_v.data(), src_v.data(), si_src.total_lengths(), si_dst.strides(), si_src.strides());
     }
+    // bytes read and written by a transformation
+    template <typename Src>
+    std::size_t transform_bytes(Src &src) {
+        return 2 * src.get_storage_info_ptr()->total_length() * sizeof(typename Src::data_t);
+    }
+
     template <typename Src, typename Dst>
     void verify_result(Src &src, Dst &dst) {
         src.sync();
@@ -67,5 +73,19 @@ TEST_F(layout_transformation, ijk_to_kji) {
     transform(src, dst);
     verify_result(src, dst);
 
-    benchmark(generic_benchmark<backend_t>{[&]() { transform(src, dst); }});
+    benchmark(generic_benchmark<backend_t>{[&]() { transform(src, dst); }, transform_bytes(src)});
+}
+
+TEST_F(layout_transformation, ijk_to_ijk) {
+
+    using src_storage_t = storage_t<0, layout_map<0, 1, 2>, alignment<1>>;
+    using dst_storage_t = storage_t<1, layout_map<0, 1, 2>, alignment<1>>;
+
+    src_storage_t src = make_storage<src_storage_t>([](int i, int j, int k) { return i + j + k; });
+    dst_storage_t dst = make_storage<dst_storage_t>(-1.);
+
+    transform(src, dst);
+    verify_result(src, dst);
+
+    benchmark(generic_benchmark<backend_t>{[&]() { transform(src, dst); }, transform_bytes(src)});
 }
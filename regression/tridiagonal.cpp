@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 
 #include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/stencil_composition/tridiagonal_solver.hpp>
 #include <gridtools/tools/regression_fixture.hpp>
 
 /*
@@ -100,3 +101,22 @@ TEST_F(tridiagonal, test) {
 
     verify(make_storage(1.), out);
 }
+
+TEST_F(tridiagonal, solver) {
+    arg<0> p_inf;
+    arg<1> p_diag;
+    arg<2> p_sup;
+    arg<3> p_rhs;
+    arg<4> p_out;
+
+    int_t n = d3();
+    auto rhs = make_storage([n](int_t, int_t, int_t k) { return k == 0 || k == n - 1 ? 2. : 1.; });
+
+    for (auto method : {tridiagonal_method::thomas, tridiagonal_method::cyclic_reduction}) {
+        auto out = make_storage();
+        auto solver = make_tridiagonal_solver<backend_t>(make_grid(), p_inf, p_diag, p_sup, p_rhs, p_out, method);
+        solver.run(
+            p_inf = make_storage(-1.), p_diag = make_storage(3.), p_sup = make_storage(-1.), p_rhs = rhs, p_out = out);
+        verify(make_storage(1.), out);
+    }
+}
@@ -1002,6 +1002,124 @@ bool usingcopy_3() {
     return result;
 }
 
+struct bc_direction {
+    // adds a code of the direction, so that a point visited twice is detected
+    template <sign I, sign J, sign K, typename DataField0, typename DataField1>
+    GT_FUNCTION void operator()(
+        direction<I, J, K>, DataField0 &data_field0, DataField1 &data_field1, uint_t i, uint_t j, uint_t k) const {
+        data_field0(i, j, k) += 9 * (I + 1) + 3 * (J + 1) + (K + 1) + 1;
+        data_field1(i, j, k) -= 9 * (I + 1) + 3 * (J + 1) + (K + 1) + 1;
+    }
+};
+
+// sign of the direction of the point along one dimension
+int_t halo_sign(int_t i, gridtools::halo_descriptor const &hd) {
+    return i < (int_t)hd.begin() ? minus_ : i <= (int_t)hd.end() ? zero_ : plus_;
+}
+
+bool all_directions_uneven_halos() {
+
+    uint_t d1 = 37;
+    uint_t d2 = 13;
+    uint_t d3 = 9;
+
+    typedef storage_traits<backend_t>::storage_info_t<0, 3> meta_data_t;
+    typedef storage_traits<backend_t>::data_store_t<int_t, meta_data_t> storage_t;
+
+    meta_data_t meta_(d1, d2, d3);
+    storage_t one(meta_, 0);
+    storage_t two(meta_, 0);
+    auto onev = make_host_view(one);
+    auto twov = make_host_view(two);
+
+    gridtools::array<gridtools::halo_descriptor, 3> halos;
+    halos[0] = gridtools::halo_descriptor(3, 1, 3, d1 - 2, d1);
+    halos[1] = gridtools::halo_descriptor(2, 0, 2, d2 - 1, d2);
+    halos[2] = gridtools::halo_descriptor(1, 2, 1, d3 - 3, d3);
+
+    one.sync();
+    two.sync();
+#ifdef __CUDACC__
+    auto onedv = make_device_view(one);
+    auto twodv = make_device_view(two);
+    gridtools::boundary_apply_gpu<bc_direction, minus_predicate>(halos, bc_direction(), minus_predicate())
+        .apply(onedv, twodv);
+#else
+    gridtools::boundary_apply<bc_direction, minus_predicate>(halos, bc_direction(), minus_predicate())
+        .apply(onev, twov);
+#endif
+    one.sync();
+    two.sync();
+
+    bool result = true;
+
+    for (uint_t i = 0; i < d1; ++i) {
+        for (uint_t j = 0; j < d2; ++j) {
+            for (uint_t k = 0; k < d3; ++k) {
+                int_t I = halo_sign(i, halos[0]);
+                int_t J = halo_sign(j, halos[1]);
+                int_t K = halo_sign(k, halos[2]);
+                bool applied = (I != zero_ || J != zero_ || K != zero_) && I != minus_ && J != minus_ && K != minus_;
+                int_t expected = applied ? 9 * (I + 1) + 3 * (J + 1) + (K + 1) + 1 : 0;
+                if (onev(i, j, k) != expected || twov(i, j, k) != -expected) {
+                    result = false;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+#ifndef __CUDACC__
+struct bc_extend {
+    // steps inwards along the first dimension in which the point is outside: faces read the interior, edges the
+    // faces and corners the edges
+    template <sign I, sign J, sign K, typename DataField0>
+    void operator()(direction<I, J, K>, DataField0 &data_field0, uint_t i, uint_t j, uint_t k) const {
+        if (I != zero_)
+            data_field0(i, j, k) = data_field0(i - I, j, k) + 1;
+        else if (J != zero_)
+            data_field0(i, j, k) = data_field0(i, j - J, k) + 1;
+        else
+            data_field0(i, j, k) = data_field0(i, j, k - K) + 1;
+    }
+};
+
+bool halo_regions_in_phases() {
+    uint_t d1 = 37;
+    uint_t d2 = 13;
+    uint_t d3 = 9;
+
+    typedef storage_traits<backend_t>::storage_info_t<0, 3> meta_data_t;
+    typedef storage_traits<backend_t>::data_store_t<int_t, meta_data_t> storage_t;
+
+    meta_data_t meta_(d1, d2, d3);
+    storage_t in(meta_, 0);
+    auto inv = make_host_view(in);
+
+    gridtools::array<gridtools::halo_descriptor, 3> halos;
+    halos[0] = gridtools::halo_descriptor(1, 1, 1, d1 - 2, d1);
+    halos[1] = gridtools::halo_descriptor(1, 1, 1, d2 - 2, d2);
+    halos[2] = gridtools::halo_descriptor(1, 1, 1, d3 - 2, d3);
+
+    gridtools::boundary_apply<bc_extend>(halos).apply(inv);
+
+    bool result = true;
+    for (uint_t i = 0; i < d1; ++i)
+        for (uint_t j = 0; j < d2; ++j)
+            for (uint_t k = 0; k < d3; ++k) {
+                int_t expected = (halo_sign(i, halos[0]) != zero_) + (halo_sign(j, halos[1]) != zero_) +
+                                 (halo_sign(k, halos[2]) != zero_);
+                if (inv(i, j, k) != expected)
+                    result = false;
+            }
+    return result;
+}
+
+TEST(boundaryconditions, halo_regions_in_phases) { EXPECT_EQ(halo_regions_in_phases(), true); }
+#endif
+
 TEST(boundaryconditions, predicate) { EXPECT_EQ(predicate(), true); }
 
 TEST(boundaryconditions, twosurfaces) { EXPECT_EQ(twosurfaces(), true); }
@@ -1017,3 +1135,5 @@ TEST(boundaryconditions, basic) { EXPECT_EQ(basic(), true); }
 TEST(boundaryconditions, usingvalue2) { EXPECT_EQ(usingvalue_2(), true); }
 
 TEST(boundaryconditions, usingcopy3) { EXPECT_EQ(usingcopy_3(), true); }
+
+TEST(boundaryconditions, all_directions_uneven_halos) { EXPECT_EQ(all_directions_uneven_halos(), true); }
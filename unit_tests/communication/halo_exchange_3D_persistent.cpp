@@ -0,0 +1,120 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+
+#include <gridtools/communication/halo_exchange.hpp>
+
+namespace {
+    const int DIM1 = 6;
+    const int DIM2 = 5;
+    const int DIM3 = 4;
+    const int H = 2;
+
+    template <class Version>
+    struct halo_exchange_persistent : testing::Test {
+        typedef gridtools::halo_exchange_dynamic_ut<gridtools::layout_map<0, 1, 2>,
+            gridtools::layout_map<0, 1, 2>,
+            double,
+            gridtools::gcl_cpu,
+            Version::value>
+            pattern_type;
+
+        MPI_Comm m_comm;
+        int m_dims[3] = {0, 0, 0};
+        int m_coords[3];
+
+        halo_exchange_persistent() {
+            int nprocs;
+            MPI_Comm_size(gridtools::GCL_WORLD, &nprocs);
+            MPI_Dims_create(nprocs, 3, m_dims);
+            int period[3] = {1, 1, 1};
+            MPI_Cart_create(gridtools::GCL_WORLD, 3, m_dims, period, false, &m_comm);
+            MPI_Cart_get(m_comm, 3, m_dims, period, m_coords);
+        }
+
+        ~halo_exchange_persistent() { MPI_Comm_free(&m_comm); }
+
+        static int index(int i, int j, int k) { return (i * (DIM2 + 2 * H) + j) * (DIM3 + 2 * H) + k; }
+
+        static int global(int i, int dim, int coord, int procs) {
+            return (i - H + dim * coord + dim * procs) % (dim * procs);
+        }
+
+        double value(int i, int j, int k, int field, int step) const {
+            return global(i, DIM1, m_coords[0], m_dims[0]) + 100. * global(j, DIM2, m_coords[1], m_dims[1]) +
+                   1e4 * global(k, DIM3, m_coords[2], m_dims[2]) + 1e6 * field + 1e7 * step;
+        }
+
+        static bool is_interior(int i, int j, int k) {
+            return i >= H && i < DIM1 + H && j >= H && j < DIM2 + H && k >= H && k < DIM3 + H;
+        }
+
+        std::vector<double> make_field(int field, int step) const {
+            std::vector<double> res(index(DIM1 + 2 * H, 0, 0), -1);
+            for (int i = 0; i < DIM1 + 2 * H; ++i)
+                for (int j = 0; j < DIM2 + 2 * H; ++j)
+                    for (int k = 0; k < DIM3 + 2 * H; ++k)
+                        if (is_interior(i, j, k))
+                            res[index(i, j, k)] = value(i, j, k, field, step);
+            return res;
+        }
+
+        int count_errors(std::vector<double> const &data, int field, int step) const {
+            int errors = 0;
+            for (int i = 0; i < DIM1 + 2 * H; ++i)
+                for (int j = 0; j < DIM2 + 2 * H; ++j)
+                    for (int k = 0; k < DIM3 + 2 * H; ++k)
+                        errors += data[index(i, j, k)] != value(i, j, k, field, step);
+            return errors;
+        }
+    };
+
+    using versions_t = testing::Types<std::integral_constant<int, gridtools::version_manual>,
+        std::integral_constant<int, gridtools::version_datatype>>;
+    TYPED_TEST_CASE(halo_exchange_persistent, versions_t);
+
+    TYPED_TEST(halo_exchange_persistent, repeated_exchanges) {
+        typedef typename TestFixture::pattern_type pattern_type;
+        pattern_type he(typename pattern_type::grid_type::period_type(true, true, true), this->m_comm);
+        he.template add_halo<0>(H, H, H, DIM1 + H - 1, DIM1 + 2 * H);
+        he.template add_halo<1>(H, H, H, DIM2 + H - 1, DIM2 + 2 * H);
+        he.template add_halo<2>(H, H, H, DIM3 + H - 1, DIM3 + 2 * H);
+        he.setup(2);
+        he.use_persistent_requests();
+
+        // the number of fields changes from step to step, so that the requests have to be recreated
+        for (int step = 0; step < 6; ++step) {
+            int num_fields = step / 2 % 2 + 1;
+            std::vector<std::vector<double>> fields;
+            std::vector<double *> ptrs;
+            for (int field = 0; field < num_fields; ++field)
+                fields.push_back(this->make_field(field, step));
+            for (auto &field : fields)
+                ptrs.push_back(field.data());
+
+            he.pack(ptrs);
+            if (step % 3 == 0) {
+                he.exchange();
+            } else {
+                he.start_exchange();
+                he.wait();
+            }
+            he.unpack(ptrs);
+
+            for (int field = 0; field < num_fields; ++field)
+                EXPECT_EQ(this->count_errors(fields[field], field, step), 0) << "step " << step << " field " << field;
+        }
+    }
+} // namespace
@@ -0,0 +1,80 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/communication/high_level/halo_pack.hpp>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace gridtools;
+
+namespace {
+    const array<int, 3> total_length = {9, 7, 5};
+
+    std::vector<double> make_field() {
+        std::vector<double> res(total_length[0] * total_length[1] * total_length[2]);
+        for (std::size_t i = 0; i < res.size(); ++i)
+            res[i] = i;
+        return res;
+    }
+
+    std::vector<double> naive_pack(halo_region const &region, std::vector<double> const &field) {
+        std::vector<double> res;
+        for (int k = region.low[2]; k <= region.high[2]; ++k)
+            for (int j = region.low[1]; j <= region.high[1]; ++j)
+                for (int i = region.low[0]; i <= region.high[0]; ++i)
+                    res.push_back(field[i + total_length[0] * (j + total_length[1] * k)]);
+        return res;
+    }
+
+    std::vector<halo_region> regions() {
+        return {
+            {{0, 0, 0}, {8, 6, 4}, total_length}, // everything
+            {{0, 2, 1}, {1, 4, 3}, total_length}, // face in the first dimension
+            {{2, 5, 1}, {6, 6, 3}, total_length}, // face in the second dimension
+            {{2, 2, 4}, {6, 4, 4}, total_length}, // face in the third dimension
+            {{7, 5, 0}, {8, 6, 4}, total_length}, // edge
+            {{3, 3, 3}, {2, 3, 3}, total_length}, // empty
+        };
+    }
+
+    TEST(halo_pack, pack) {
+        auto field = make_field();
+        for (auto const &region : regions()) {
+            auto expected = naive_pack(region, field);
+            for (int num_parts : {1, 2, 3, 7, 100}) {
+                std::vector<double> buffer(expected.size(), -1);
+                for (int part = 0; part < num_parts; ++part)
+                    EXPECT_EQ(expected.size(), pack_region(region, field.data(), buffer.data(), part, num_parts));
+                EXPECT_EQ(expected, buffer);
+            }
+        }
+    }
+
+    TEST(halo_pack, unpack) {
+        auto field = make_field();
+        for (auto const &region : regions()) {
+            auto buffer = naive_pack(region, field);
+            for (auto &value : buffer)
+                value = -value;
+            for (int num_parts : {1, 4}) {
+                auto testee = field;
+                for (int part = 0; part < num_parts; ++part)
+                    EXPECT_EQ(buffer.size(), unpack_region(region, testee.data(), buffer.data(), part, num_parts));
+                EXPECT_EQ(buffer, naive_pack(region, testee));
+
+                // the rest of the field is untouched
+                unpack_region(region, testee.data(), naive_pack(region, field).data());
+                EXPECT_EQ(field, testee);
+            }
+        }
+    }
+} // namespace
@@ -9,6 +9,8 @@
  */
 
 #include <iomanip>
+#include <type_traits>
+#include <vector>
 
 #ifdef GCL_MPI
 #include <mpi.h>
@@ -20,6 +22,7 @@
 #include <gridtools/boundary_conditions/value.hpp>
 #include <gridtools/distributed_boundaries/comm_traits.hpp>
 #include <gridtools/distributed_boundaries/distributed_boundaries.hpp>
+#include <gridtools/stencil_composition/grid.hpp>
 #include <gridtools/storage/storage_facility.hpp>
 #include <gridtools/tools/backend_select.hpp>
 #include <gridtools/tools/mpi_unit_test_driver/device_binding.hpp>
@@ -520,3 +523,153 @@ TEST(DistributedBoundaries, Test) {
 
     EXPECT_THROW(cabc.exchange(a, b, c, d), std::runtime_error);
 }
+
+namespace {
+    using namespace gridtools;
+
+    template <typename Storage>
+    bool equal_storages(Storage const &lhs, Storage const &rhs) {
+        auto lhs_view = make_host_view(lhs);
+        auto rhs_view = make_host_view(rhs);
+        for (int i = lhs_view.template total_begin<0>(); i <= lhs_view.template total_end<0>(); ++i)
+            for (int j = lhs_view.template total_begin<1>(); j <= lhs_view.template total_end<1>(); ++j)
+                for (int k = lhs_view.template total_begin<2>(); k <= lhs_view.template total_end<2>(); ++k)
+                    if (lhs_view(i, j, k) != rhs_view(i, j, k))
+                        return false;
+        return true;
+    }
+
+    struct distributed_boundaries_split_phase : ::testing::Test {
+#ifdef __CUDACC__
+        using comm_arch = gcl_gpu;
+#else
+        using comm_arch = gcl_cpu;
+#endif
+        using storage_tr = storage_traits<backend_t>;
+        using storage_info_t = storage_tr::storage_info_t<0, 3, halo<2, 2, 0>>;
+        using storage_type = storage_tr::data_store_t<triplet, storage_info_t>;
+        using cabc_t = distributed_boundaries<comm_traits<storage_type, comm_arch>>;
+
+        static constexpr int halo_size = 2;
+        static constexpr int d1 = 10;
+        static constexpr int d2 = 11;
+        static constexpr int d3 = 3;
+
+        storage_info_t storage_info = {d1, d2, d3};
+
+        halo_descriptor di = {halo_size, halo_size, halo_size, d1 - halo_size - 1, d1};
+        halo_descriptor dj = {halo_size, halo_size, halo_size, d2 - halo_size - 1, d2};
+        halo_descriptor dk = {0, 0, 0, d3 - 1, d3};
+
+#ifdef GCL_MPI
+        MPI_Comm make_comm() {
+            int dims[3] = {0, 0, 0};
+            MPI_Dims_create(PROCS, 3, dims);
+            int period[3] = {1, 1, 1};
+            MPI_Comm CartComm;
+            MPI_Cart_create(GCL_WORLD, 3, dims, period, false, &CartComm);
+            return CartComm;
+        }
+#else
+        MPI_Comm make_comm() { return GCL_WORLD; }
+#endif
+
+        cabc_t cabc = {{di, dj, dk}, {false, false, false}, 3, make_comm()};
+
+        storage_type make_storage(int offset) {
+            int pi, pj, pk;
+            cabc.proc_grid().coords(pi, pj, pk);
+            return {storage_info,
+                [=](int i, int j, int k) {
+                    bool inner = i >= halo_size and j >= halo_size and i < d1 - halo_size and j < d2 - halo_size;
+                    return inner ? triplet{i + pi * (d1 - 2 * halo_size) + offset,
+                                       j + pj * (d2 - 2 * halo_size) + offset,
+                                       k + pk * d3 + offset}
+                                 : triplet{0, 0, 0};
+                }};
+        }
+    };
+
+    TEST_F(distributed_boundaries_split_phase, same_as_exchange) {
+        using namespace std::placeholders;
+        auto a = make_storage(100);
+        auto b = make_storage(1000);
+        auto c = make_storage(10000);
+        cabc.exchange(bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, a),
+            bind_bc(copy_boundary{}, b, _1).associate(c));
+
+        auto split_a = make_storage(100);
+        auto split_b = make_storage(1000);
+        auto split_c = make_storage(10000);
+        cabc.start_exchange(bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, split_a),
+            bind_bc(copy_boundary{}, split_b, _1).associate(split_c));
+        EXPECT_THROW(cabc.start_exchange(split_a), std::runtime_error);
+        cabc.finish_exchange();
+        EXPECT_THROW(cabc.finish_exchange(), std::runtime_error);
+
+        for (auto *storage : {&a, &b, &c, &split_a, &split_b, &split_c})
+            storage->sync();
+        EXPECT_TRUE(equal_storages(a, split_a));
+        EXPECT_TRUE(equal_storages(b, split_b));
+        EXPECT_TRUE(equal_storages(c, split_c));
+    }
+
+    static_assert(!std::is_move_constructible<distributed_boundaries_split_phase::cabc_t>::value, "");
+
+    TEST_F(distributed_boundaries_split_phase, destroyed_while_pending) {
+        auto pending = make_storage(100);
+        {
+            cabc_t other = {{di, dj, dk}, {false, false, false}, 3, make_comm()};
+            other.start_exchange(bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, pending));
+        }
+
+        auto a = make_storage(100);
+        auto expected = make_storage(100);
+        cabc.exchange(bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, a));
+        cabc.start_exchange(bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, expected));
+        cabc.finish_exchange();
+        a.sync();
+        expected.sync();
+        EXPECT_TRUE(equal_storages(a, expected));
+    }
+
+    TEST_F(distributed_boundaries_split_phase, overlapped) {
+        auto a = make_storage(100);
+        cabc.exchange(bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, a));
+
+        auto overlapped_a = make_storage(100);
+        auto grid = make_grid(di, dj, d3);
+        std::vector<array<int, 4>> sub_grids;
+        cabc.exchange_overlapped(
+            grid,
+            [&](auto const &sub_grid) {
+                auto origin = sub_grid.origin();
+                sub_grids.push_back({(int)tuple_util::get<0>(origin),
+                    sub_grid.i_size(),
+                    (int)tuple_util::get<1>(origin),
+                    sub_grid.j_size()});
+                EXPECT_EQ(sub_grid.k_size(), grid.k_size());
+            },
+            bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, overlapped_a));
+
+        // the interior comes first, the rim afterwards
+        ASSERT_EQ(sub_grids.size(), 5);
+        EXPECT_EQ(sub_grids[0], (array<int, 4>{2 * halo_size, d1 - 4 * halo_size, 2 * halo_size, d2 - 4 * halo_size}));
+
+        // the sub grids cover the compute domain exactly once
+        std::vector<int> covered(d1 * d2, 0);
+        for (auto const &sub_grid : sub_grids)
+            for (int i = sub_grid[0]; i < sub_grid[0] + sub_grid[1]; ++i)
+                for (int j = sub_grid[2]; j < sub_grid[2] + sub_grid[3]; ++j)
+                    ++covered[i * d2 + j];
+        for (int i = 0; i < d1; ++i)
+            for (int j = 0; j < d2; ++j) {
+                bool inside = i >= halo_size && i < d1 - halo_size && j >= halo_size && j < d2 - halo_size;
+                EXPECT_EQ(covered[i * d2 + j], inside ? 1 : 0) << i << ", " << j;
+            }
+
+        a.sync();
+        overlapped_a.sync();
+        EXPECT_TRUE(equal_storages(a, overlapped_a));
+    }
+} // namespace
@@ -8,7 +8,11 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <algorithm>
+#include <vector>
+
 #include <gridtools/common/array.hpp>
+#include <gridtools/common/hypercube_iterator.hpp>
 #include <gridtools/interface/layout_transformation/layout_transformation.hpp>
 #include <gtest/gtest.h>
 
@@ -181,6 +185,49 @@ TEST(layout_transformation, 1D_layout_with_stride2) {
     delete[] dst;
 }
 
+TEST(layout_transformation, 4D_all_permutations_with_padding) {
+    std::vector<uint_t> dims{37, 3, 70, 5};
+    std::vector<uint_t> src_strides{1, 40, 3 * 40, 70 * 3 * 40};
+
+    Index src_index(dims, src_strides);
+    std::vector<double> src(src_index.size());
+    init<4>(src.data(), src_index, [](const array<size_t, 4> &a) {
+        return a[0] * 1000000 + a[1] * 10000 + a[2] * 10 + a[3];
+    });
+
+    std::vector<int> order{0, 1, 2, 3};
+    do {
+        // the dimensions are laid out in the destination in the given order, the first one is padded
+        std::vector<uint_t> dst_strides(4);
+        uint_t stride = 1;
+        for (int d : order) {
+            dst_strides[d] = stride;
+            stride *= d == order[0] ? dims[d] + 3 : dims[d];
+        }
+
+        Index dst_index(dims, dst_strides);
+        std::vector<double> dst(dst_index.size(), -1);
+
+        gridtools::interface::transform(dst.data(), src.data(), dims, dst_strides, src_strides);
+
+        verify<4>(src.data(), src_index, dst.data(), dst_index);
+    } while (std::next_permutation(order.begin(), order.end()));
+}
+
+TEST(layout_transformation, 3D_same_layout_with_size_1_dimension) {
+    std::vector<uint_t> dims{100, 1, 1000};
+    std::vector<uint_t> strides{1, 100, 100};
+
+    Index index(dims, strides);
+    std::vector<double> src(index.size());
+    init<3>(src.data(), index, [](const array<size_t, 3> &a) { return a[0] + a[2] * 1000; });
+    std::vector<double> dst(index.size(), -1);
+
+    gridtools::interface::transform(dst.data(), src.data(), dims, strides, strides);
+
+    EXPECT_EQ(src, dst);
+}
+
 TEST(layout_transformation, one_dimension_too_many) {
     std::vector<uint_t> dims(GT_TRANSFORM_MAX_DIM + 1);
     std::vector<uint_t> src_strides(GT_TRANSFORM_MAX_DIM + 1);
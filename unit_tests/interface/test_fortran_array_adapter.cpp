@@ -88,3 +88,104 @@ TEST(FortranArrayAdapter, TransformDataStoreIntoAdapter) {
             for (size_t x = 0; x < x_size; ++x, ++i)
                 EXPECT_EQ(fortran_array[z][y][x], i);
 }
+
+using KJIStorageInfo = typename gridtools::storage_traits<gridtools::backend::x86>::
+    select_custom_layout_storage_info<0, gridtools::layout_map<2, 1, 0>, gridtools::zero_halo<3>>::type;
+using KJIDataStore =
+    typename gridtools::storage_traits<gridtools::backend::x86>::data_store_t<float_type, KJIStorageInfo>;
+
+TEST(FortranArrayAdapter, WrapFortranArray) {
+    constexpr size_t x_size = 6;
+    constexpr size_t y_size = 5;
+    constexpr size_t z_size = 4;
+    float_type fortran_array[z_size][y_size][x_size];
+
+    bindgen_fortran_array_descriptor descriptor;
+    descriptor.rank = 3;
+    descriptor.dims[0] = x_size;
+    descriptor.dims[1] = y_size;
+    descriptor.dims[2] = z_size;
+    descriptor.type = std::is_same<float_type, float>::value ? bindgen_fk_Float : bindgen_fk_Double;
+    descriptor.data = fortran_array;
+    descriptor.is_acc_present = false;
+
+    int i = 0;
+    for (size_t z = 0; z < z_size; ++z)
+        for (size_t y = 0; y < y_size; ++y)
+            for (size_t x = 0; x < x_size; ++x, ++i)
+                fortran_array[z][y][x] = i;
+
+    gridtools::fortran_array_adapter<KJIDataStore> fortran_array_adapter{descriptor};
+    ASSERT_TRUE(fortran_array_adapter.is_wrappable());
+
+    // the data_store uses the memory of the fortran array
+    KJIDataStore data_store = fortran_array_adapter.make_data_store();
+    auto data_store_view = make_host_view(data_store);
+    EXPECT_EQ(&data_store_view(0, 0, 0), &fortran_array[0][0][0]);
+    EXPECT_EQ(data_store.total_length<0>(), x_size);
+    EXPECT_EQ(data_store.total_length<1>(), y_size);
+    EXPECT_EQ(data_store.total_length<2>(), z_size);
+
+    i = 0;
+    for (size_t z = 0; z < z_size; ++z)
+        for (size_t y = 0; y < y_size; ++y)
+            for (size_t x = 0; x < x_size; ++x, ++i) {
+                EXPECT_EQ(data_store_view(x, y, z), i);
+                data_store_view(x, y, z) = -i;
+            }
+
+    // copying back is a no-op
+    transform(fortran_array_adapter, data_store);
+
+    i = 0;
+    for (size_t z = 0; z < z_size; ++z)
+        for (size_t y = 0; y < y_size; ++y)
+            for (size_t x = 0; x < x_size; ++x, ++i)
+                EXPECT_EQ(fortran_array[z][y][x], -i);
+}
+
+TEST(FortranArrayAdapter, CopyIncompatibleFortranArray) {
+    constexpr size_t x_size = 6;
+    constexpr size_t y_size = 5;
+    constexpr size_t z_size = 4;
+    float_type fortran_array[z_size][y_size][x_size];
+
+    bindgen_fortran_array_descriptor descriptor;
+    descriptor.rank = 3;
+    descriptor.dims[0] = x_size;
+    descriptor.dims[1] = y_size;
+    descriptor.dims[2] = z_size;
+    descriptor.type = std::is_same<float_type, float>::value ? bindgen_fk_Float : bindgen_fk_Double;
+    descriptor.data = fortran_array;
+    descriptor.is_acc_present = false;
+
+    int i = 0;
+    for (size_t z = 0; z < z_size; ++z)
+        for (size_t y = 0; y < y_size; ++y)
+            for (size_t x = 0; x < x_size; ++x, ++i)
+                fortran_array[z][y][x] = i;
+
+    gridtools::fortran_array_adapter<IJKDataStore> fortran_array_adapter{descriptor};
+    ASSERT_FALSE(fortran_array_adapter.is_wrappable());
+
+    // the data_store holds a copy of the fortran array
+    IJKDataStore data_store = fortran_array_adapter.make_data_store();
+    auto data_store_view = make_host_view(data_store);
+    EXPECT_NE(&data_store_view(0, 0, 0), &fortran_array[0][0][0]);
+
+    i = 0;
+    for (size_t z = 0; z < z_size; ++z)
+        for (size_t y = 0; y < y_size; ++y)
+            for (size_t x = 0; x < x_size; ++x, ++i) {
+                EXPECT_EQ(data_store_view(x, y, z), i);
+                data_store_view(x, y, z) = -i;
+            }
+
+    transform(fortran_array_adapter, data_store);
+
+    i = 0;
+    for (size_t z = 0; z < z_size; ++z)
+        for (size_t y = 0; y < y_size; ++y)
+            for (size_t x = 0; x < x_size; ++x, ++i)
+                EXPECT_EQ(fortran_array[z][y][x], -i);
+}
@@ -0,0 +1,179 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/computation_fixture.hpp>
+
+namespace gridtools {
+    namespace {
+        namespace fuse_columns {
+            struct a;
+            struct b;
+
+            template <class Plh, class Extent = extent<>>
+            using in = stage_matrix::plh_info<meta::list<Plh>,
+                std::false_type,
+                double,
+                integral_constant<int_t, 1>,
+                std::true_type,
+                Extent,
+                meta::list<>>;
+
+            template <class Plh, class Extent = extent<>>
+            using inout = stage_matrix::plh_info<meta::list<Plh>,
+                std::false_type,
+                double,
+                integral_constant<int_t, 1>,
+                std::false_type,
+                Extent,
+                meta::list<>>;
+
+            template <class Extent, class... PlhInfos>
+            struct item {
+                using extent_t = Extent;
+                using plh_map_t = meta::list<PlhInfos...>;
+            };
+
+            template <class... Items>
+            using can_fuse = stage_matrix::can_fuse_columns<stage_matrix::aggregated_view<Items...>>;
+
+            // vertical dependencies in any direction are fine
+            static_assert(can_fuse<item<extent<>, inout<a>>,
+                              item<extent<>, in<a, extent<0, 0, 0, 0, -2, 3>>, inout<b>>,
+                              item<extent<>, inout<a, extent<0, 0, 0, 0, 0, 1>>, in<b>>>::value,
+                "");
+
+            // horizontal offsets are fine for fields that are only read
+            using halo_t = extent<-1, 1, 0, 0>;
+            static_assert(can_fuse<item<halo_t, in<a, extent<-2, 2, 0, 0>>, inout<b, halo_t>>,
+                              item<halo_t, in<a, extent<-1, 1, -1, 1>>, in<b, halo_t>>>::value,
+                "");
+
+            // reading a produced field with horizontal offsets
+            static_assert(!can_fuse<item<extent<>, inout<a>>, item<extent<>, in<a, extent<-1, 0, 0, 0>>>>::value, "");
+
+            // overwriting a field that is read with horizontal offsets
+            static_assert(!can_fuse<item<extent<>, in<a, extent<0, 0, 0, 1>>>, item<extent<>, inout<a>>>::value, "");
+
+            // different horizontal regions
+            static_assert(!can_fuse<item<extent<-1, 1, -1, 1>, inout<a, extent<-1, 1, -1, 1>>>,
+                              item<extent<>, in<a>>>::value,
+                "");
+        } // namespace fuse_columns
+
+        using axis_t = axis<1>;
+        using full_t = axis_t::full_interval;
+
+        struct prefix_sum {
+            using out = inout_accessor<0, extent<0, 0, 0, 0, -1, 0>>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::modify<1, 0>) {
+                eval(out()) = eval(out(0, 0, -1)) + eval(in());
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::first_level) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        struct suffix_sum {
+            using out = inout_accessor<0, extent<0, 0, 0, 0, 0, 1>>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::modify<0, -1>) {
+                eval(out()) = eval(out(0, 0, 1)) + eval(in());
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::last_level) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        struct shifted_suffix_sum {
+            using out = inout_accessor<0, extent<0, 0, 0, 0, 0, 1>>;
+            using in = in_accessor<1, extent<0, 1, 0, 0>>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::modify<0, -1>) {
+                eval(out()) = eval(out(0, 0, 1)) + eval(in(1, 0, 0));
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::last_level) {
+                eval(out()) = eval(in(1, 0, 0));
+            }
+        };
+
+        struct column_fusion : computation_fixture<1> {
+            column_fusion() : computation_fixture<1>(13, 9, 7) {}
+
+            static double in(int i, int j, int k) { return i + 2 * j + 3 * k; }
+
+            static double prefix(int i, int j, int k) { return (k + 1) * (i + 2 * j) + 3 * k * (k + 1) / 2; }
+
+            double suffix_of_prefix(int i, int j, int k) const {
+                double res = 0;
+                for (int kk = k; kk < (int)d3(); ++kk)
+                    res += prefix(i, j, kk);
+                return res;
+            }
+        };
+
+        TEST_F(column_fusion, forward_then_backward) {
+            auto out = make_storage();
+            make_computation(p_0 = make_storage(in),
+                p_1 = out,
+                make_multistage(execute::forward(), make_stage<prefix_sum>(p_tmp_0, p_0)),
+                make_multistage(execute::backward(), make_stage<suffix_sum>(p_1, p_tmp_0)))
+                .run();
+            verify(make_storage([&](int i, int j, int k) { return suffix_of_prefix(i, j, k); }), out);
+        }
+
+        TEST_F(column_fusion, forward_then_backward_with_fields) {
+            auto tmp = make_storage();
+            auto out = make_storage();
+            make_computation(p_0 = make_storage(in),
+                p_1 = tmp,
+                p_2 = out,
+                make_multistage(execute::forward(), make_stage<prefix_sum>(p_1, p_0)),
+                make_multistage(execute::backward(), make_stage<suffix_sum>(p_2, p_1)),
+                make_multistage(execute::forward(), make_stage<prefix_sum>(p_1, p_2)))
+                .run();
+            verify(make_storage([&](int i, int j, int k) { return suffix_of_prefix(i, j, k); }), out);
+            verify(make_storage([&](int i, int j, int k) {
+                double res = 0;
+                for (int kk = 0; kk <= k; ++kk)
+                    res += suffix_of_prefix(i, j, kk);
+                return res;
+            }),
+                tmp);
+        }
+
+        TEST_F(column_fusion, horizontal_dependency) {
+            auto out = make_storage();
+            make_computation(p_0 = make_storage(in),
+                p_1 = out,
+                make_multistage(execute::forward(), make_stage<prefix_sum>(p_tmp_0, p_0)),
+                make_multistage(execute::backward(), make_stage<shifted_suffix_sum>(p_1, p_tmp_0)))
+                .run();
+            verify(make_storage([&](int i, int j, int k) { return suffix_of_prefix(i + 1, j, k); }), out);
+        }
+    } // namespace
+} // namespace gridtools
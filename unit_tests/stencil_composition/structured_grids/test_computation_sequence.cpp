@@ -0,0 +1,192 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/stencil_composition/computation_sequence.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/computation_fixture.hpp>
+
+namespace gridtools {
+    namespace {
+        struct scale_functor {
+            using out = inout_accessor<0>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                eval(out()) = 2 * eval(in());
+            }
+        };
+
+        struct lap_functor {
+            using out = inout_accessor<0>;
+            using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                eval(out()) = 4 * eval(in()) - eval(in(1, 0)) - eval(in(-1, 0)) - eval(in(0, 1)) - eval(in(0, -1));
+            }
+        };
+
+        using full_t = axis<1>::full_interval;
+
+        struct shift_up_functor {
+            using out = inout_accessor<0>;
+            using in = in_accessor<1, extent<0, 0, 0, 0, 0, 1>>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::modify<0, -1>) {
+                eval(out()) = eval(in(0, 0, 1));
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::last_level) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        struct sequence : computation_fixture<1> {
+            sequence() : computation_fixture<1>(13, 9, 7) {}
+
+            static float_type in(int_t i, int_t j, int_t k) { return i * i + 3 * j + k; }
+
+            static float_type lap(int_t i, int_t j, int_t k) {
+                return 4 * in(i, j, k) - in(i + 1, j, k) - in(i - 1, j, k) - in(i, j + 1, k) - in(i, j - 1, k);
+            }
+        };
+
+        TEST_F(sequence, intermediates) {
+            auto scale = make_computation(make_multistage(execute::parallel(), make_stage<scale_functor>(p_1, p_0)));
+            auto laplacian = make_computation(make_multistage(execute::parallel(), make_stage<lap_functor>(p_2, p_1)));
+            auto seq = make_computation_sequence(intermediates(p_1), std::move(scale), std::move(laplacian));
+            EXPECT_EQ(seq.fused_size(), 1);
+
+            auto out = make_storage();
+            seq.run(p_0 = make_storage(in), p_2 = out);
+            verify(make_storage([](int_t i, int_t j, int_t k) { return 2 * lap(i, j, k); }), out);
+        }
+
+        TEST_F(sequence, pointwise) {
+            auto first = make_computation(make_multistage(execute::parallel(),
+                make_stage<scale_functor>(p_tmp_0, p_0),
+                make_stage<scale_functor>(p_1, p_tmp_0)));
+            auto second = make_computation(make_multistage(execute::forward(),
+                make_stage<scale_functor>(p_tmp_0, p_1),
+                make_stage<scale_functor>(p_2, p_tmp_0)));
+            auto seq = make_computation_sequence(std::move(first), std::move(second));
+            EXPECT_EQ(seq.fused_size(), 1);
+
+            auto mid = make_storage();
+            auto out = make_storage();
+            seq.run(p_0 = make_storage(in), p_1 = mid, p_2 = out);
+            verify(make_storage([](int_t i, int_t j, int_t k) { return 4 * in(i, j, k); }), mid);
+            verify(make_storage([](int_t i, int_t j, int_t k) { return 16 * in(i, j, k); }), out);
+        }
+
+        TEST_F(sequence, read_with_offsets) {
+            auto make_scale = [&] {
+                return make_computation(make_multistage(execute::parallel(), make_stage<scale_functor>(p_1, p_0)));
+            };
+            auto make_laplacian = [&] {
+                return make_computation(make_multistage(execute::parallel(), make_stage<lap_functor>(p_2, p_1)));
+            };
+            // the halo of p_1 is not computed by the first computation, so they can not be fused
+            auto seq = make_computation_sequence(make_scale(), make_laplacian());
+            EXPECT_EQ(seq.fused_size(), 2);
+
+            auto field = make_storage(in);
+            auto mid = make_storage(-1.);
+            auto out = make_storage();
+            seq.run(p_0 = field, p_1 = mid, p_2 = out);
+
+            auto expected_mid = make_storage(-1.);
+            auto expected = make_storage();
+            make_scale().run(p_0 = field, p_1 = expected_mid);
+            make_laplacian().run(p_1 = expected_mid, p_2 = expected);
+            verify(expected_mid, mid);
+            verify(expected, out);
+        }
+
+        TEST_F(sequence, read_with_vertical_offsets) {
+            auto scale = make_computation(make_multistage(execute::parallel(), make_stage<scale_functor>(p_1, p_0)));
+            auto shift = make_computation(make_multistage(execute::parallel(), make_stage<shift_up_functor>(p_2, p_1)));
+            // the backends may run a fused computation level by level, the level above would not be computed yet
+            auto seq = make_computation_sequence(std::move(scale), std::move(shift));
+            EXPECT_EQ(seq.fused_size(), 2);
+
+            auto mid = make_storage();
+            auto out = make_storage();
+            seq.run(p_0 = make_storage(in), p_1 = mid, p_2 = out);
+            int_t k_max = d3() - 1;
+            verify(make_storage([&](int_t i, int_t j, int_t k) { return 2 * in(i, j, std::min(k + 1, k_max)); }), out);
+        }
+
+        TEST_F(sequence, different_grids) {
+            auto make_scale = [&](auto grid) {
+                return gridtools::make_computation<backend_t>(
+                    grid, make_multistage(execute::parallel(), make_stage<scale_functor>(p_1, p_0)));
+            };
+            auto make_laplacian = [&](auto grid) {
+                return gridtools::make_computation<backend_t>(
+                    grid, make_multistage(execute::parallel(), make_stage<lap_functor>(p_2, p_1)));
+            };
+            EXPECT_NO_THROW(make_computation_sequence(make_scale(make_grid()), make_laplacian(make_grid())));
+            // another size
+            EXPECT_THROW(make_computation_sequence(make_scale(make_grid()),
+                             make_laplacian(gridtools::make_grid(i_halo_descriptor(), j_halo_descriptor(), 6))),
+                std::runtime_error);
+            // the same size, but another origin
+            EXPECT_THROW(
+                make_computation_sequence(make_scale(make_grid()), make_laplacian(gridtools::make_grid(11, 7, 7))),
+                std::runtime_error);
+            // the same size, but other splitters
+            EXPECT_THROW(make_computation_sequence(make_scale(gridtools::make_grid(11, 7, axis<2>(3, 4))),
+                             make_laplacian(gridtools::make_grid(11, 7, axis<2>(4, 3)))),
+                std::runtime_error);
+        }
+
+        TEST_F(sequence, write_after_read) {
+            auto laplacian = make_computation(make_multistage(execute::parallel(), make_stage<lap_functor>(p_1, p_0)));
+            auto scale = make_computation(make_multistage(execute::parallel(), make_stage<scale_functor>(p_0, p_2)));
+            auto seq = make_computation_sequence(std::move(laplacian), std::move(scale));
+            EXPECT_EQ(seq.fused_size(), 2);
+
+            static_assert(decltype(seq.get_arg_intent(p_0))::value == intent::inout, "");
+            static_assert(decltype(seq.get_arg_intent(p_1))::value == intent::inout, "");
+            static_assert(decltype(seq.get_arg_intent(p_2))::value == intent::in, "");
+
+            auto field = make_storage(in);
+            auto out = make_storage();
+            seq.run(p_0 = field, p_1 = out, p_2 = make_storage(1.));
+            verify(make_storage(lap), out);
+            verify(make_storage(2.), field);
+        }
+
+        TEST_F(sequence, bound_data_stores) {
+            auto out = make_storage();
+            auto scale = make_computation(
+                p_0 = make_storage(in), make_multistage(execute::parallel(), make_stage<scale_functor>(p_1, p_0)));
+            auto laplacian = make_computation(
+                p_2 = out, make_multistage(execute::parallel(), make_stage<lap_functor>(p_2, p_1)));
+            auto seq = make_computation_sequence(intermediates(p_1), std::move(scale), std::move(laplacian));
+            seq.run();
+            seq.run();
+            EXPECT_EQ(seq.get_count(), 2);
+            verify(make_storage([](int_t i, int_t j, int_t k) { return 2 * lap(i, j, k); }), out);
+        }
+    } // namespace
+} // namespace gridtools
@@ -29,6 +29,13 @@ struct expandable_parameters : computation_fixture<> {
             .run();
     }
 
+    template <class... Args>
+    void run_parallel_computation(Args &&... args) const {
+        gridtools::make_expandable_computation<backend_t>(
+            parallel_expand_factor<2>(), make_grid(), std::forward<Args>(args)...)
+            .run();
+    }
+
     void verify(storages_t const &expected, storages_t const &actual) const {
         EXPECT_EQ(expected.size(), actual.size());
         for (size_t i = 0; i != expected.size(); ++i)
@@ -160,3 +167,33 @@ TEST_F(expandable_parameters, caches) {
             make_stage<copy_functor>(p_out, p_tmp)));
     verify({in, in, in, in, in}, out);
 }
+
+TEST_F(expandable_parameters, parallel_call_shift) {
+    auto expected = [&](float_type value) { return make_storage([=](int_t, int_t, int_t) { return value; }); };
+    auto in = [&](float_type value) {
+        return make_storage([=](int_t, int_t, int_t k) { return k == 0 ? value : -1; });
+    };
+
+    storages_t actual = {in(14), in(15), in(16), in(17), in(18)};
+    arg<0, storages_t> plh;
+    run_parallel_computation(plh = actual, make_multistage(execute::forward(), make_stage<call_shift_functor>(plh)));
+    verify({expected(14), expected(15), expected(16), expected(17), expected(18)}, actual);
+}
+
+TEST_F(expandable_parameters, parallel_temporaries) {
+    storages_t out = {make_storage(1.), make_storage(2.), make_storage(3.), make_storage(4.), make_storage(5.)};
+    storages_t in = {make_storage(-1.), make_storage(-2.), make_storage(-3.), make_storage(-4.), make_storage(-5.)};
+
+    arg<0, storages_t> p_out;
+    arg<1, storages_t> p_in;
+    tmp_arg<0, storages_t> p_tmp;
+    tmp_arg<1, storages_t> p_cached;
+    run_parallel_computation(p_in = in,
+        p_out = out,
+        make_multistage(execute::parallel(),
+            define_caches(cache<cache_type::ij, cache_io_policy::local>(p_cached)),
+            make_stage<copy_functor>(p_tmp, p_in),
+            make_stage<copy_functor>(p_cached, p_tmp),
+            make_stage<copy_functor>(p_out, p_cached)));
+    verify(in, out);
+}
@@ -49,3 +49,15 @@ TEST(test_grid, make_grid_makes_splitters_and_values) {
     EXPECT_EQ(5, testee.k_start(interval2_t()));
     EXPECT_EQ(10, testee.k_size(interval2_t()));
 }
+
+TEST(test_grid, sub_grid) {
+    auto testee = make_grid(halo_descriptor(2, 2, 2, 11, 14), halo_descriptor(1, 1, 1, 8, 10), axis_type<2>{5, 10});
+    auto sub = testee.sub_grid(3, 4, 0, 2);
+
+    EXPECT_EQ(5, tuple_util::get<0>(sub.origin()));
+    EXPECT_EQ(1, tuple_util::get<1>(sub.origin()));
+    EXPECT_EQ(4, sub.i_size());
+    EXPECT_EQ(2, sub.j_size());
+    EXPECT_EQ(testee.k_size(), sub.k_size());
+    EXPECT_EQ(testee.k_start(), sub.k_start());
+}
@@ -0,0 +1,219 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/computation_fixture.hpp>
+
+namespace gridtools {
+    namespace {
+        namespace pipeline_levels {
+            struct a;
+            struct b;
+
+            template <class Plh, class Extent = extent<>>
+            using in = stage_matrix::plh_info<meta::list<Plh>,
+                std::false_type,
+                double,
+                integral_constant<int_t, 1>,
+                std::true_type,
+                Extent,
+                meta::list<>>;
+
+            template <class Plh, class Extent = extent<>>
+            using inout = stage_matrix::plh_info<meta::list<Plh>,
+                std::false_type,
+                double,
+                integral_constant<int_t, 1>,
+                std::false_type,
+                Extent,
+                meta::list<>>;
+
+            template <class Execution, class... PlhInfos>
+            struct item {
+                using execution_t = Execution;
+                using plh_map_t = meta::list<PlhInfos...>;
+            };
+
+            template <class... Items>
+            using can_pipeline = stage_matrix::can_pipeline_levels<stage_matrix::aggregated_view<Items...>>;
+
+            // horizontal extents and accesses to the current or the already produced levels are fine
+            static_assert(can_pipeline<item<execute::forward, inout<a>>,
+                              item<execute::forward, in<a, extent<-1, 1, -1, 1, -1, 0>>, inout<b>>,
+                              item<execute::parallel, in<b>>>::value,
+                "");
+            static_assert(can_pipeline<item<execute::backward, inout<a>>,
+                              item<execute::backward, in<a, extent<0, 0, 0, 0, 0, 2>>, inout<b>>>::value,
+                "");
+
+            // reading levels that are not produced yet
+            static_assert(!can_pipeline<item<execute::forward, inout<a>>,
+                              item<execute::forward, in<a, extent<0, 0, 0, 0, 0, 1>>>>::value,
+                "");
+            static_assert(!can_pipeline<item<execute::backward, inout<a>>,
+                              item<execute::backward, in<a, extent<0, 0, 0, 0, -1, 0>>>>::value,
+                "");
+
+            // reading levels that are already overwritten
+            static_assert(!can_pipeline<item<execute::forward, in<a, extent<0, 0, 0, 0, -1, 0>>>,
+                              item<execute::forward, inout<a>>>::value,
+                "");
+            static_assert(can_pipeline<item<execute::forward, in<a, extent<0, 0, 0, 0, 0, 1>>>,
+                              item<execute::forward, inout<a>>>::value,
+                "");
+
+            // mixed directions
+            static_assert(!can_pipeline<item<execute::forward, inout<a>>, item<execute::backward, inout<b>>>::value, "");
+        } // namespace pipeline_levels
+
+        using axis_t = axis<1>;
+        using full_t = axis_t::full_interval;
+
+        struct prefix_sum {
+            using out = inout_accessor<0, extent<0, 0, 0, 0, -1, 0>>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::modify<1, 0>) {
+                eval(out()) = eval(out(0, 0, -1)) + eval(in());
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::first_level) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        struct suffix_sum {
+            using out = inout_accessor<0, extent<0, 0, 0, 0, 0, 1>>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::modify<0, -1>) {
+                eval(out()) = eval(out(0, 0, 1)) + eval(in());
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::last_level) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        struct neighbours {
+            using out = inout_accessor<0>;
+            using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                eval(out()) = eval(in(-1, 0, 0)) + eval(in(1, 0, 0)) + eval(in(0, -1, 0)) + eval(in(0, 1, 0));
+            }
+        };
+
+        struct look_ahead {
+            using out = inout_accessor<0>;
+            using in = in_accessor<1, extent<0, 0, 0, 0, 0, 1>>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::modify<0, -1>) {
+                eval(out()) = eval(in(0, 0, 1));
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, full_t::last_level) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        struct k_wavefront : computation_fixture<1> {
+            k_wavefront() : computation_fixture<1>(13, 9, 7) {}
+
+            static double in(int i, int j, int k) { return i + 2 * j + 3 * k; }
+
+            static double prefix(int i, int j, int k) { return (k + 1) * (i + 2 * j) + 3 * k * (k + 1) / 2; }
+
+            double suffix(int i, int j, int k) const {
+                double res = 0;
+                for (int kk = k; kk < (int)d3(); ++kk)
+                    res += in(i, j, kk);
+                return res;
+            }
+        };
+
+        TEST_F(k_wavefront, forward) {
+            auto neighbours_of_prefix = [](int i, int j, int k) {
+                return prefix(i - 1, j, k) + prefix(i + 1, j, k) + prefix(i, j - 1, k) + prefix(i, j + 1, k);
+            };
+            auto expected = [&](int i, int j, int k) {
+                double res = 0;
+                for (int kk = 0; kk <= k; ++kk)
+                    res += neighbours_of_prefix(i, j, kk);
+                return res;
+            };
+            auto out = make_storage();
+            make_computation(p_0 = make_storage(in),
+                p_1 = out,
+                make_multistage(execute::forward(),
+                    make_stage<prefix_sum>(p_tmp_0, p_0),
+                    make_stage<neighbours>(p_tmp_1, p_tmp_0)),
+                make_multistage(execute::forward(), make_stage<prefix_sum>(p_1, p_tmp_1)))
+                .run();
+            verify(make_storage(expected), out);
+        }
+
+        TEST_F(k_wavefront, backward) {
+            auto expected = [&](int i, int j, int k) {
+                double res = 0;
+                for (int kk = k; kk < (int)d3(); ++kk)
+                    res += suffix(i, j, kk);
+                return res;
+            };
+            auto out = make_storage();
+            make_computation(p_0 = make_storage(in),
+                p_1 = out,
+                make_multistage(execute::backward(), make_stage<suffix_sum>(p_tmp_0, p_0)),
+                make_multistage(execute::backward(), make_stage<suffix_sum>(p_1, p_tmp_0)))
+                .run();
+            verify(make_storage(expected), out);
+        }
+
+        TEST_F(k_wavefront, reading_ahead) {
+            auto expected = [&](int i, int j, int k) { return prefix(i, j, k + 1 < (int)d3() ? k + 1 : k); };
+            auto out = make_storage();
+            make_computation(p_0 = make_storage(in),
+                p_1 = out,
+                make_multistage(execute::forward(), make_stage<prefix_sum>(p_tmp_0, p_0)),
+                make_multistage(execute::forward(), make_stage<look_ahead>(p_1, p_tmp_0)))
+                .run();
+            verify(make_storage(expected), out);
+        }
+
+        TEST_F(k_wavefront, forward_then_backward) {
+            auto expected = [&](int i, int j, int k) {
+                double res = 0;
+                for (int kk = k; kk < (int)d3(); ++kk)
+                    res += prefix(i, j, kk);
+                return res;
+            };
+            auto out = make_storage();
+            make_computation(p_0 = make_storage(in),
+                p_1 = out,
+                make_multistage(execute::forward(), make_stage<prefix_sum>(p_tmp_0, p_0)),
+                make_multistage(execute::backward(), make_stage<suffix_sum>(p_1, p_tmp_0)))
+                .run();
+            verify(make_storage(expected), out);
+        }
+    } // namespace
+} // namespace gridtools
@@ -52,6 +52,22 @@ namespace {
             eval(out()) = eval(in());
         }
     };
+
+    template <typename Axis>
+    struct parallel_functor_on_odd_intervals {
+        typedef accessor<0> in;
+        typedef accessor<1, intent::inout> out;
+        typedef gridtools::make_param_list<in, out> param_list;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, typename Axis::template get_interval<1>) {
+            eval(out()) = eval(in());
+        }
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, typename Axis::template get_interval<3>) {
+            eval(out()) = 3 * eval(in());
+        }
+    };
 } // namespace
 
 template <typename Axis>
@@ -202,3 +218,51 @@ TEST(structured_grid, kparallel_with_unused_intervals) {
                 EXPECT_EQ(1.5, outv(i, j, k));
         }
 }
+
+TEST(structured_grid, kparallel_with_many_splitters) {
+    using Axis = gridtools::axis<5>;
+
+    constexpr uint_t d1 = 7;
+    constexpr uint_t d2 = 8;
+    constexpr uint_t sizes[] = {1, 2, 3, 1, 9};
+    constexpr uint_t d3 = 16;
+
+    using storage_info_t = typename storage_traits<backend_t>::storage_info_t<1, 3, gridtools::halo<0, 0, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<double, storage_info_t>;
+
+    storage_info_t storage_info(d1, d2, d3);
+
+    storage_t in(storage_info, [](int i, int j, int k) { return (double)(i * 1000 + j * 100 + k); });
+    storage_t out(storage_info, (double)1.5);
+
+    typedef arg<0, storage_t> p_in;
+    typedef arg<1, storage_t> p_out;
+
+    auto grid = gridtools::make_grid(d1, d2, Axis(sizes[0], sizes[1], sizes[2], sizes[3], sizes[4]));
+
+    auto comp = gridtools::make_computation<backend_t>(grid,
+        p_in() = in,
+        p_out() = out,
+        gridtools::make_multistage(gridtools::execute::parallel(),
+            gridtools::make_stage<parallel_functor_on_odd_intervals<Axis>>(p_in(), p_out())));
+
+    comp.run();
+
+    in.sync();
+    out.sync();
+
+    auto outv = make_host_view(out);
+    auto inv = make_host_view(in);
+    for (int i = 0; i < d1; ++i)
+        for (int j = 0; j < d2; ++j) {
+            int k = 0;
+            for (int interval = 0; interval < 5; ++interval)
+                for (int end = k + sizes[interval]; k < end; ++k)
+                    if (interval == 1)
+                        EXPECT_EQ(inv(i, j, k), outv(i, j, k));
+                    else if (interval == 3)
+                        EXPECT_EQ(3 * inv(i, j, k), outv(i, j, k));
+                    else
+                        EXPECT_EQ(1.5, outv(i, j, k));
+        }
+}
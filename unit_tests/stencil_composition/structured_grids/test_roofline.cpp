@@ -0,0 +1,136 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/stencil_composition/roofline.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/expandable_parameters/make_computation.hpp>
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/computation_fixture.hpp>
+
+namespace gridtools {
+    namespace {
+        struct scale_functor {
+            static constexpr int flops = 1;
+
+            using out = inout_accessor<0>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                eval(out()) = 2 * eval(in());
+            }
+        };
+
+        struct lap_functor {
+            static constexpr int flops = 5;
+
+            using out = inout_accessor<0>;
+            using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                eval(out()) = 4 * eval(in()) - eval(in(1, 0)) - eval(in(-1, 0)) - eval(in(0, 1)) - eval(in(0, -1));
+            }
+        };
+
+        struct copy_functor {
+            using out = inout_accessor<0>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        // compute domain: 11 x 7 x 5, with the halo: 13 x 9 x 5
+        struct roofline : computation_fixture<1> {
+            roofline() : computation_fixture<1>(13, 9, 5) {}
+        };
+
+        TEST_F(roofline, traffic) {
+            auto comp = make_computation(make_multistage(execute::parallel(),
+                make_stage<scale_functor>(p_tmp_0, p_0),
+                make_stage<lap_functor>(p_1, p_tmp_0)));
+            auto in = make_storage(1.);
+            auto out = make_storage();
+            comp.run(p_0 = in, p_1 = out);
+
+            // the temporary is not counted, the input is read in the halo, the output is read and written
+            auto traffic = comp.get_roofline().traffic;
+            EXPECT_DOUBLE_EQ(traffic.bytes, sizeof(float_type) * (13 * 9 * 5 + 2 * 11 * 7 * 5));
+            // the temporary is computed in the halo
+            EXPECT_DOUBLE_EQ(traffic.flops, 1 * 13 * 9 * 5 + 5 * 11 * 7 * 5);
+        }
+
+        TEST_F(roofline, undeclared_flops) {
+            auto comp = make_computation(make_multistage(execute::forward(), make_stage<copy_functor>(p_1, p_0)));
+            auto in = make_storage(1.);
+            auto out = make_storage();
+            comp.run(p_0 = in, p_1 = out);
+
+            auto traffic = comp.get_roofline().traffic;
+            EXPECT_DOUBLE_EQ(traffic.bytes, sizeof(float_type) * 3 * 11 * 7 * 5);
+            EXPECT_EQ(traffic.flops, 0);
+        }
+
+        TEST_F(roofline, expandable_parameters) {
+            using storages_t = std::vector<storage_type>;
+            arg<0, storages_t> p_out;
+            arg<1, storages_t> p_in;
+            storages_t in = {make_storage(1.), make_storage(2.), make_storage(3.)};
+            storages_t out = {make_storage(), make_storage(), make_storage()};
+            auto comp = make_expandable_computation<backend_t>(expand_factor<2>(),
+                make_grid(),
+                make_multistage(execute::parallel(), make_stage<copy_functor>(p_out, p_in)));
+            comp.run(p_in = in, p_out = out);
+
+            EXPECT_DOUBLE_EQ(comp.get_roofline().traffic.bytes, sizeof(float_type) * 3 * 3 * 11 * 7 * 5);
+        }
+
+        TEST(roofline_report, to_string) {
+            traffic_estimate traffic;
+            traffic.bytes = 1e9;
+            roofline_report report{traffic, 2., 4};
+            EXPECT_DOUBLE_EQ(report.bandwidth(), 2);
+            EXPECT_EQ(report.arithmetic_intensity(), 0);
+
+            std::string str = report.to_string(8);
+            EXPECT_NE(str.find("[GB/s]\t2"), std::string::npos);
+            EXPECT_NE(str.find("[% of peak]\t25"), std::string::npos);
+            EXPECT_EQ(str.find("flop"), std::string::npos);
+
+            report.traffic.flops = 5e8;
+            EXPECT_DOUBLE_EQ(report.flop_rate(), 1);
+            EXPECT_DOUBLE_EQ(report.arithmetic_intensity(), .5);
+            EXPECT_NE(report.to_string().find("[flop/B]\t0.5"), std::string::npos);
+            EXPECT_EQ(report.to_string().find("peak"), std::string::npos);
+        }
+
+        TEST(roofline_report, stream_bandwidth) { EXPECT_GT(measure_stream_bandwidth(1 << 16, 2), 0); }
+
+        TEST(roofline_report, device_peak_bandwidth) {
+            // the host STREAM triad is not a peak for the device memory
+            unsetenv("GT_STREAM_BANDWIDTH");
+            EXPECT_EQ(peak_bandwidth(backend::cuda()), 0);
+            setenv("GT_STREAM_BANDWIDTH", "900", 1);
+            EXPECT_EQ(peak_bandwidth(backend::cuda()), 900);
+            unsetenv("GT_STREAM_BANDWIDTH");
+        }
+    } // namespace
+} // namespace gridtools
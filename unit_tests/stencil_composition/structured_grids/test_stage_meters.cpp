@@ -0,0 +1,147 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef GT_ENABLE_STAGE_METERS
+#define GT_ENABLE_STAGE_METERS
+#endif
+
+#include <gridtools/stencil_composition/stage_meters.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/computation_fixture.hpp>
+
+namespace gridtools {
+    namespace {
+        struct copy_functor {
+            using out = inout_accessor<0>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        struct sum_functor {
+            using out = inout_accessor<0, extent<0, 0, 0, 0, -1, 0>>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::modify<1, 0>) {
+                eval(out()) = eval(out(0, 0, -1)) + eval(in());
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::first_level) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        struct stage_meters : computation_fixture<1> {
+            stage_meters() : computation_fixture<1>(13, 9, 7) {}
+        };
+
+        // the measured stage region of the given functor
+        region_summary const *find(std::vector<region_summary> const &regions, std::string const &name) {
+            for (auto const &region : regions)
+                if (region.kind == "stage" && region.count > 0 && region.name.find(name) != std::string::npos)
+                    return &region;
+            return nullptr;
+        }
+
+        TEST_F(stage_meters, regions) {
+            auto comp = make_computation(make_multistage(execute::parallel(), make_stage<copy_functor>(p_1, p_0)),
+                make_multistage(execute::forward(), make_stage<sum_functor>(p_2, p_1)));
+            auto in = make_storage([](int_t i, int_t j, int_t k) { return i + j + k; });
+            auto mid = make_storage();
+            auto out = make_storage();
+
+            auto &profiler = region_profiler::instance();
+            profiler.reset();
+            comp.run(p_0 = in, p_1 = mid, p_2 = out);
+            comp.run(p_0 = in, p_1 = mid, p_2 = out);
+            auto regions = profiler.summary();
+
+            auto copy = find(regions, "copy_functor");
+            auto sum = find(regions, "sum_functor");
+            ASSERT_TRUE(copy);
+            ASSERT_TRUE(sum);
+            EXPECT_GE(copy->count, 2);
+            EXPECT_GE(sum->count, 2);
+
+            auto const &first = regions[copy->parent];
+            auto const &second = regions[sum->parent];
+            EXPECT_EQ(first.kind, "multistage");
+            EXPECT_EQ(first.name, "multistage 0");
+            EXPECT_EQ(second.name, "multistage 1");
+            EXPECT_EQ(first.parent, second.parent);
+            EXPECT_EQ(first.count, 2);
+            EXPECT_DOUBLE_EQ(first.time, copy->time);
+
+            auto const &computation = regions[first.parent];
+            EXPECT_EQ(computation.kind, "computation");
+            EXPECT_EQ(computation.parent, -1);
+            EXPECT_EQ(computation.count, 2);
+            EXPECT_GT(computation.time, 0);
+        }
+
+        TEST_F(stage_meters, export) {
+            auto comp = make_computation(make_multistage(execute::parallel(), make_stage<copy_functor>(p_1, p_0)));
+            auto in = make_storage(1.);
+            auto out = make_storage();
+
+            auto &profiler = region_profiler::instance();
+            profiler.reset();
+            comp.run(p_0 = in, p_1 = out);
+
+            std::ostringstream json;
+            profiler.write_json(json);
+            EXPECT_NE(json.str().find("\"kind\":\"computation\""), std::string::npos);
+            EXPECT_NE(json.str().find("copy_functor"), std::string::npos);
+
+            std::ostringstream trace;
+            profiler.write_chrome_trace(trace);
+            EXPECT_NE(trace.str().find("\"ph\":\"X\""), std::string::npos);
+            EXPECT_NE(trace.str().find("\"cat\":\"stage\""), std::string::npos);
+
+            profiler.reset();
+            std::ostringstream empty;
+            profiler.write_chrome_trace(empty);
+            EXPECT_EQ(empty.str().find("\"ph\":\"X\""), std::string::npos);
+        }
+
+        TEST_F(stage_meters, counters) {
+            auto comp = make_computation(make_multistage(execute::parallel(), make_stage<copy_functor>(p_1, p_0)));
+            auto in = make_storage(1.);
+            auto out = make_storage();
+
+            auto &profiler = region_profiler::instance();
+            profiler.reset();
+            profiler.enable_counters();
+            comp.run(p_0 = in, p_1 = out);
+            profiler.enable_counters(false);
+            verify(make_storage(1.), out);
+
+            // the counters might not be available, but the run is still measured
+            auto regions = profiler.summary();
+            auto copy = find(regions, "copy_functor");
+            ASSERT_TRUE(copy);
+            EXPECT_GE(copy->count, 1);
+            EXPECT_EQ(copy->bytes, 64 * copy->llc_misses);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,83 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/stencil_composition/tridiagonal_solver.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/computation_fixture.hpp>
+
+namespace gridtools {
+    namespace {
+        // the solution is known: out = i + j * k + 1
+        double inf(int_t i, int_t j, int_t k) { return -1 - (i + j + k) % 3 * .25; }
+        double diag(int_t i, int_t j, int_t k) { return 4 + (i * k + j) % 5; }
+        double sup(int_t i, int_t j, int_t k) { return -1 + (i + 2 * j + k) % 2 * .5; }
+        double solution(int_t i, int_t j, int_t k) { return i + j * k + 1; }
+
+        struct tridiagonal_solver_test : computation_fixture<1> {
+            tridiagonal_solver_test() : computation_fixture<1>(5, 4, 23) {}
+
+            void run(tridiagonal_method method, tridiagonal_method expected_method) {
+                int_t n = d3();
+                auto rhs = make_storage([n](int_t i, int_t j, int_t k) {
+                    double res = diag(i, j, k) * solution(i, j, k);
+                    if (k > 0)
+                        res += inf(i, j, k) * solution(i, j, k - 1);
+                    if (k < n - 1)
+                        res += sup(i, j, k) * solution(i, j, k + 1);
+                    return res;
+                });
+                auto out = make_storage();
+
+                auto solver = make_tridiagonal_solver<backend_t>(make_grid(), p_0, p_1, p_2, p_3, p_4, method);
+                EXPECT_EQ(solver.method(), expected_method);
+                // the solver is a computation
+                computation<arg<0>, arg<1>, arg<2>, arg<3>, arg<4>> comp = std::move(solver);
+                for (int i = 0; i < 2; ++i)
+                    comp.run(p_4 = out,
+                        p_0 = make_storage(inf),
+                        p_1 = make_storage(diag),
+                        p_2 = make_storage(sup),
+                        p_3 = rhs);
+                EXPECT_EQ(comp.get_arg_intent(p_3), intent::in);
+                EXPECT_EQ(comp.get_arg_intent(p_4), intent::inout);
+                verify(make_storage(solution), out);
+            }
+        };
+
+        TEST_F(tridiagonal_solver_test, thomas) { run(tridiagonal_method::thomas, tridiagonal_method::thomas); }
+
+        TEST_F(tridiagonal_solver_test, cyclic_reduction) {
+            run(tridiagonal_method::cyclic_reduction, tridiagonal_method::cyclic_reduction);
+        }
+
+        TEST_F(tridiagonal_solver_test, automatic) {
+            run(tridiagonal_method::automatic,
+                select_tridiagonal_method(make_grid(), tridiagonal_solver_impl_::default_concurrency()));
+        }
+
+        TEST(select_tridiagonal_method, grid_shape) {
+            // enough columns for all the threads
+            EXPECT_EQ(select_tridiagonal_method(make_grid(64, 64, 80), 16), tridiagonal_method::thomas);
+            // a single thread
+            EXPECT_EQ(select_tridiagonal_method(make_grid(1, 1, 1000), 1), tridiagonal_method::thomas);
+            // few long columns
+            EXPECT_EQ(select_tridiagonal_method(make_grid(1, 1, 1000), 64), tridiagonal_method::cyclic_reduction);
+            EXPECT_EQ(select_tridiagonal_method(make_grid(2, 2, 1000), 256), tridiagonal_method::cyclic_reduction);
+            // few short columns
+            EXPECT_EQ(select_tridiagonal_method(make_grid(2, 2, 4), 64), tridiagonal_method::thomas);
+            // the costs exceed the range of int_t
+            EXPECT_EQ(select_tridiagonal_method(make_grid(2048, 2048, 64), 1), tridiagonal_method::thomas);
+            EXPECT_EQ(select_tridiagonal_method(make_grid(4096, 4096, 4096), 64), tridiagonal_method::thomas);
+            EXPECT_EQ(select_tridiagonal_method(make_grid(1, 1, 1 << 26), 1024), tridiagonal_method::cyclic_reduction);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,98 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil_composition/block_schedule.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace gridtools;
+
+namespace {
+    template <class Schedule>
+    struct block_schedule : testing::Test {};
+
+    using schedules_t = testing::Types<schedule::static_, schedule::guided, schedule::work_stealing>;
+    TYPED_TEST_CASE(block_schedule, schedules_t);
+
+    void spin(double seconds) {
+        double start = omp_get_wtime();
+        while (omp_get_wtime() - start < seconds)
+            ;
+    }
+
+    template <class Schedule>
+    void expect_all_blocks_once(int_t size) {
+        std::vector<std::atomic<int>> visits(size);
+        for (auto &visit : visits)
+            visit = 0;
+        parallel_for_blocks(Schedule(), size, [&](int_t block) { ++visits[block]; });
+        for (int_t block = 0; block < size; ++block)
+            EXPECT_EQ(visits[block], 1) << "block " << block;
+    }
+
+    TYPED_TEST(block_schedule, all_blocks_once) {
+        for (int_t size : {0, 1, 3, 7, 64, 1001})
+            expect_all_blocks_once<TypeParam>(size);
+    }
+
+    TYPED_TEST(block_schedule, fewer_threads) {
+        int threads = omp_get_max_threads();
+        omp_set_num_threads(threads > 1 ? threads - 1 : 1);
+        expect_all_blocks_once<TypeParam>(100);
+        omp_set_num_threads(threads);
+    }
+
+    TYPED_TEST(block_schedule, unbalanced) {
+        // all the work is in the range of the first thread with the static schedule
+        int_t size = 64;
+        std::vector<std::atomic<int>> visits(size);
+        for (auto &visit : visits)
+            visit = 0;
+        parallel_for_blocks(TypeParam(), size, [&](int_t block) {
+            if (block < size / omp_get_num_threads())
+                spin(1e-4);
+            ++visits[block];
+        });
+        for (int_t block = 0; block < size; ++block)
+            EXPECT_EQ(visits[block], 1) << "block " << block;
+    }
+
+    TEST(block_schedule_work_stealing, idle_threads_steal) {
+        if (omp_get_max_threads() < 2)
+            return;
+        int_t size = 64;
+        std::vector<int> thread_of_block(size, -1);
+        parallel_for_blocks(schedule::work_stealing(), size, [&](int_t block) {
+            if (block == 0)
+                spin(1e-2);
+            thread_of_block[block] = omp_get_thread_num();
+        });
+        // the first thread is stuck at block 0, the rest of its initial range is stolen
+        int_t first_range_end = size / omp_get_max_threads();
+        int_t stolen = 0;
+        for (int_t block = 1; block < first_range_end; ++block)
+            stolen += thread_of_block[block] != 0;
+        EXPECT_GT(stolen, 0);
+    }
+
+    TEST(shared_ranges, cache_line_aligned) {
+        for (std::size_t size = 1; size != 9; ++size) {
+            block_schedule_impl_::shared_ranges ranges(size);
+            for (std::size_t i = 0; i != size; ++i) {
+                EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&ranges[i]) % block_schedule_impl_::cache_line_size, 0);
+                EXPECT_EQ(ranges[i].m_value.load(), 0);
+            }
+        }
+    }
+} // namespace
@@ -0,0 +1,113 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/backend_mc/block_tuner.hpp>
+
+using namespace gridtools;
+using namespace gridtools::mc;
+
+namespace {
+    struct stencil_a;
+    struct stencil_b;
+
+    void spin(double seconds) {
+        double start = omp_get_wtime();
+        while (omp_get_wtime() - start < seconds)
+            ;
+    }
+
+    struct tmp_file {
+        std::string name = testing::TempDir() + "gt_block_tuner_test_" + std::to_string(std::rand());
+        ~tmp_file() { std::remove(name.c_str()); }
+    };
+} // namespace
+
+TEST(block_tuner_mc, stencil_hash) {
+    EXPECT_EQ(stencil_hash<stencil_a>(), stencil_hash<stencil_a>());
+    EXPECT_NE(stencil_hash<stencil_a>(), stencil_hash<stencil_b>());
+}
+
+TEST(block_tuner_mc, candidates) {
+    int_t threads = omp_get_max_threads();
+    auto candidates = block_size_candidates(100, 50, threads);
+    ASSERT_GT(candidates.size(), 1);
+
+    execinfo_mc heuristic(100, 50);
+    EXPECT_EQ(candidates.front().i, heuristic.i_block_size());
+    EXPECT_EQ(candidates.front().j, heuristic.j_block_size());
+
+    for (auto const &candidate : candidates) {
+        execinfo_mc info(100, 50, candidate.i, candidate.j);
+        EXPECT_GE(info.i_blocks() * info.j_blocks(), threads);
+    }
+}
+
+TEST(block_tuner_mc, disabled) {
+    block_tuner tuner(false, "");
+    tuning_key key = {stencil_hash<stencil_a>(), 40, 30, 10, omp_get_max_threads()};
+    execinfo_mc heuristic(40, 30);
+    int runs = 0;
+    tuner.run(key, [&](execinfo_mc const &info) {
+        EXPECT_EQ(info.i_block_size(), heuristic.i_block_size());
+        EXPECT_EQ(info.j_block_size(), heuristic.j_block_size());
+        ++runs;
+    });
+    EXPECT_EQ(runs, 1);
+    EXPECT_TRUE(tuner.tuned());
+}
+
+TEST(block_tuner_mc, tuning) {
+    tmp_file cache;
+    tuning_key key = {stencil_hash<stencil_a>(), 300, 40, 10, omp_get_max_threads()};
+    auto candidates = block_size_candidates(key.i_size, key.j_size, key.threads);
+    ASSERT_GT(candidates.size(), 1);
+    block_sizes fastest = candidates.back();
+
+    block_tuner tuner(true, cache.name);
+    std::vector<block_sizes> used;
+    auto fun = [&](execinfo_mc const &info) {
+        block_sizes sizes = {info.i_block_size(), info.j_block_size()};
+        used.push_back(sizes);
+        if (!(sizes == fastest))
+            spin(2e-3);
+    };
+    for (std::size_t run = 0; run <= candidates.size(); ++run) {
+        tuner.run(key, fun);
+        EXPECT_EQ(tuner.tuned(), run == candidates.size());
+    }
+    EXPECT_EQ(tuner.best(), fastest);
+
+    // warm-up run and one run per candidate
+    ASSERT_EQ(used.size(), candidates.size() + 1);
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+        EXPECT_EQ(used[i + 1], candidates[i]);
+
+    used.clear();
+    tuner.run(key, fun);
+    ASSERT_EQ(used.size(), 1);
+    EXPECT_EQ(used.front(), fastest);
+
+    // another computation starts with the tuned blocks
+    block_tuner other(true, cache.name);
+    other.run(key, fun);
+    EXPECT_TRUE(other.tuned());
+    EXPECT_EQ(used.back(), fastest);
+
+    // but not for a different grid size
+    block_tuner different_size(true, cache.name);
+    different_size.run({key.stencil, 301, 40, 10, key.threads}, fun);
+    EXPECT_FALSE(different_size.tuned());
+}
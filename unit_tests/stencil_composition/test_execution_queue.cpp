@@ -0,0 +1,221 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/stencil_composition/execution_queue.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/computation_fixture.hpp>
+
+namespace gridtools {
+    namespace {
+        struct event_log {
+            std::mutex m_mutex;
+            std::vector<std::string> m_events;
+
+            void add(std::string const &event) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_events.push_back(event);
+            }
+
+            int_t position(std::string const &event) const {
+                for (size_t i = 0; i != m_events.size(); ++i)
+                    if (m_events[i] == event)
+                        return i;
+                return -1;
+            }
+        };
+
+        using storage_traits_t = storage_traits<backend_t>;
+        using data_store_t = storage_traits_t::data_store_t<float_type, storage_traits_t::storage_info_t<0, 1>>;
+
+        using out_arg = arg<0, data_store_t>;
+        using in_arg = arg<1, data_store_t>;
+
+        data_store_t data() { return {storage_traits_t::storage_info_t<0, 1>{1}}; }
+
+        // writes out_arg, reads in_arg and records when it starts and ends
+        struct recording_computation {
+            event_log &m_log;
+            std::string m_name;
+            bool m_throws = false;
+
+            template <class... Args, class... DataStores>
+            void run(arg_storage_pair<Args, DataStores> const &...) {
+                m_log.add(m_name + " start");
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                m_log.add(m_name + " end");
+                if (m_throws)
+                    throw std::runtime_error(m_name);
+            }
+
+            static std::integral_constant<intent, intent::inout> get_arg_intent(out_arg) { return {}; }
+            static std::integral_constant<intent, intent::in> get_arg_intent(in_arg) { return {}; }
+        };
+
+        TEST(execution_queue, read_after_write) {
+            event_log log;
+            recording_computation writer{log, "writer"};
+            recording_computation reader{log, "reader"};
+            auto a = data();
+            auto b = data();
+            auto c = data();
+            execution_queue queue(2);
+            queue.enqueue(writer, out_arg() = a, in_arg() = b);
+            queue.enqueue(reader, out_arg() = c, in_arg() = a);
+            queue.wait();
+            EXPECT_LT(log.position("writer end"), log.position("reader start"));
+        }
+
+        TEST(execution_queue, write_after_read) {
+            event_log log;
+            recording_computation reader{log, "reader"};
+            recording_computation writer{log, "writer"};
+            auto a = data();
+            auto b = data();
+            auto c = data();
+            execution_queue queue(2);
+            queue.enqueue(reader, out_arg() = c, in_arg() = a);
+            queue.enqueue(writer, out_arg() = a, in_arg() = b);
+            queue.wait();
+            EXPECT_LT(log.position("reader end"), log.position("writer start"));
+        }
+
+        TEST(execution_queue, independent) {
+            event_log log;
+            recording_computation first{log, "first"};
+            recording_computation second{log, "second"};
+            auto a = data();
+            auto b = data();
+            auto c = data();
+            execution_queue queue(2);
+            // both read `a`, they may run concurrently
+            queue.enqueue(first, out_arg() = b, in_arg() = a);
+            queue.enqueue(second, out_arg() = c, in_arg() = a);
+            queue.wait();
+            EXPECT_LT(log.position("first start"), log.position("second end"));
+            EXPECT_LT(log.position("second start"), log.position("first end"));
+        }
+
+        TEST(execution_queue, same_computation) {
+            event_log log;
+            recording_computation comp{log, "comp"};
+            auto a = data();
+            auto b = data();
+            auto c = data();
+            auto d = data();
+            execution_queue queue(2);
+            queue.enqueue(comp, out_arg() = a, in_arg() = b);
+            queue.enqueue(comp, out_arg() = c, in_arg() = d);
+            queue.wait();
+            ASSERT_EQ(log.m_events.size(), 4);
+            EXPECT_EQ(log.m_events[0], "comp start");
+            EXPECT_EQ(log.m_events[1], "comp end");
+        }
+
+        TEST(execution_queue, exceptions) {
+            event_log log;
+            recording_computation writer{log, "writer", true};
+            recording_computation reader{log, "reader"};
+            auto a = data();
+            auto b = data();
+            auto c = data();
+            execution_queue queue(2);
+            auto written = queue.enqueue(writer, out_arg() = a, in_arg() = b);
+            auto read = run_async(queue, reader, out_arg() = c, in_arg() = a);
+            EXPECT_THROW(written.get(), std::runtime_error);
+            EXPECT_THROW(read.get(), std::runtime_error);
+            EXPECT_EQ(log.position("reader start"), -1);
+        }
+
+        TEST(execution_queue, exceptions_of_finished_runs) {
+            event_log log;
+            recording_computation writer{log, "writer", true};
+            recording_computation reader{log, "reader"};
+            auto a = data();
+            auto b = data();
+            auto c = data();
+            execution_queue queue(2);
+            auto written = queue.enqueue(writer, out_arg() = a, in_arg() = b);
+            written.wait();
+            auto read = queue.enqueue(reader, out_arg() = c, in_arg() = a);
+            EXPECT_THROW(read.get(), std::runtime_error);
+            EXPECT_EQ(log.position("reader start"), -1);
+        }
+
+        TEST(execution_queue, many_reads) {
+            event_log log;
+            recording_computation writer{log, "writer"};
+            recording_computation reader{log, "reader"};
+            auto a = data();
+            auto b = data();
+            auto c = data();
+            execution_queue queue(2);
+            for (int i = 0; i != 4; ++i)
+                queue.enqueue(reader, out_arg() = c, in_arg() = a).wait();
+            queue.enqueue(reader, out_arg() = c, in_arg() = a);
+            queue.enqueue(writer, out_arg() = a, in_arg() = b);
+            queue.wait();
+            ASSERT_EQ(log.m_events.size(), 12);
+            EXPECT_EQ(log.m_events[9], "reader end");
+            EXPECT_EQ(log.m_events[10], "writer start");
+        }
+
+#ifndef GT_ICOSAHEDRAL_GRIDS
+        struct copy_functor {
+            using out = inout_accessor<0>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                eval(out()) = eval(in());
+            }
+        };
+
+        struct stencils : computation_fixture<> {
+            stencils() : computation_fixture<>(13, 9, 7) {}
+        };
+
+        TEST_F(stencils, chain) {
+            arg<0> p_out;
+            arg<1> p_in;
+            auto copy = [&] { return make_computation(make_multistage(execute::parallel(),
+                                  make_stage<copy_functor>(p_out, p_in))); };
+            auto first = copy();
+            auto second = copy();
+            auto third = copy();
+
+            auto in = [](int_t i, int_t j, int_t k) { return i + j * 10 + k * 100; };
+            auto a = make_storage(in);
+            auto b = make_storage();
+            auto c = make_storage();
+            auto d = make_storage(in);
+            auto e = make_storage();
+
+            execution_queue queue(2);
+            run_async(queue, first, p_out = b, p_in = a);
+            run_async(queue, second, p_out = c, p_in = b);
+            run_async(queue, third, p_out = e, p_in = d);
+            queue.wait();
+
+            verify(make_storage(in), c);
+            verify(make_storage(in), e);
+        }
+#endif
+    } // namespace
+} // namespace gridtools
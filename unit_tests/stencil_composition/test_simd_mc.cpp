@@ -0,0 +1,109 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/stencil_composition/backend_mc/simd.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/computation_fixture.hpp>
+
+namespace gridtools {
+    namespace {
+        using mc::simd_ref;
+        using mc::simd_vec;
+
+        TEST(simd_vec, arithmetic) {
+            double data[4] = {1, 2, 3, 4};
+            auto a = simd_vec<double, 4>::load(data, 4);
+            auto b = 2 * a + 1 - a / 2;
+            b *= -a;
+            for (int i = 0; i < 4; ++i)
+                EXPECT_DOUBLE_EQ(b[i], -(2 * data[i] + 1 - data[i] / 2) * data[i]);
+
+            auto c = math::max(math::sqrt(a), simd_vec<double, 4>(1.5));
+            EXPECT_DOUBLE_EQ(c[0], 1.5);
+            EXPECT_DOUBLE_EQ(c[3], 2);
+        }
+
+        TEST(simd_vec, partial) {
+            int data[4] = {5, 6, 7, 8};
+            auto a = simd_vec<int, 4>::load(data, 3);
+            EXPECT_EQ(a[2], 7);
+            // inactive lanes are not loaded
+            EXPECT_EQ(a[3], 5);
+
+            simd_ref<int, 4, int_t> ref(data, 2);
+            ref = a * 10;
+            EXPECT_EQ(data[0], 50);
+            EXPECT_EQ(data[1], 60);
+            EXPECT_EQ(data[2], 7);
+            EXPECT_EQ(data[3], 8);
+
+            ref += 1;
+            EXPECT_EQ(data[0], 51);
+            EXPECT_EQ(data[2], 7);
+        }
+
+        template <bool Simd>
+        struct lap_functor {
+            static constexpr bool simd = Simd;
+
+            using out = inout_accessor<0>;
+            using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval) {
+                using namespace expressions;
+                eval(out()) = eval(4 * in() - in(1, 0) - in(-1, 0)) - eval(in(0, 1)) - eval(in(0, -1));
+            }
+        };
+
+        template <bool Simd>
+        struct sum_functor {
+            static constexpr bool simd = Simd;
+
+            using out = inout_accessor<0, extent<0, 0, 0, 0, -1, 0>>;
+            using in = in_accessor<1>;
+            using param_list = make_param_list<out, in>;
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::modify<1, 0>) {
+                eval(out()) = eval(out(0, 0, -1)) + math::fabs(eval(in()));
+            }
+
+            template <class Eval>
+            GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::first_level) {
+                eval(out()) = math::fabs(eval(in()));
+            }
+        };
+
+        // the i size is not a multiple of the vector length
+        struct simd_mc : computation_fixture<1> {
+            simd_mc() : computation_fixture<1>(13, 9, 7) {}
+
+            template <bool Simd>
+            void run(storage_type in, storage_type out) {
+                make_computation(make_multistage(execute::parallel(), make_stage<lap_functor<Simd>>(p_tmp_0, p_0)),
+                    make_multistage(execute::forward(), make_stage<sum_functor<Simd>>(p_1, p_tmp_0)))
+                    .run(p_0 = in, p_1 = out);
+            }
+        };
+
+        TEST_F(simd_mc, same_as_scalar) {
+            auto in = make_storage([](int_t i, int_t j, int_t k) { return i * i + 3 * j - k * j; });
+            auto expected = make_storage();
+            auto actual = make_storage();
+            run<false>(in, expected);
+            run<true>(in, actual);
+            verify(expected, actual);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,114 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/hymap.hpp>
+#include <gridtools/common/tuple_util.hpp>
+#include <gridtools/stencil_composition/backend_x86/tmp_storage_sid.hpp>
+#include <gridtools/stencil_composition/sid/concept.hpp>
+
+using namespace gridtools;
+using namespace gridtools::literals;
+using namespace gridtools::x86;
+
+static constexpr std::size_t page_size = 4096;
+
+TEST(tmp_storage_sid_x86, arena) {
+    tmp_arena arena;
+    arena.reset();
+    arena.reserve<double>(3);
+    arena.reserve<double>(5);
+    arena.commit();
+    EXPECT_EQ(arena.slab_size() % page_size, 0);
+
+    double *first = arena.allocate<double>(3);
+    double *second = arena.allocate<double>(5);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % page_size, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second) % 64, 0);
+    EXPECT_GE(second, first + 3);
+
+    // the steady state reuses the memory
+    arena.reset();
+    arena.reserve<double>(3);
+    arena.commit();
+    EXPECT_EQ(arena.allocate<double>(3), first);
+
+    // copies don't share the memory
+    tmp_arena copy = arena;
+    EXPECT_EQ(copy.slab_size(), 0);
+}
+
+TEST(tmp_storage_sid_x86, odd_element_size) {
+    struct triple {
+        int a, b, c;
+    };
+    tmp_arena arena;
+    arena.reset();
+    arena.reserve<triple>(3);
+    arena.commit();
+    EXPECT_EQ(arena.slab_size() % page_size, 0);
+    EXPECT_EQ(arena.slab_size() % sizeof(triple), 0);
+}
+
+TEST(tmp_storage_sid_x86, per_thread_slabs) {
+    auto sizes = tuple_util::make<hymap::keys<dim::k, dim::j, dim::i>::values>(7, 4_c, 5_c);
+
+    tmp_arena arena;
+    arena.reset();
+    arena.reserve<int>(11);
+    arena.reserve<double>(7 * 4 * 5);
+    arena.commit();
+    auto other = arena.allocate<int>(11);
+    auto tmp = make_tmp_storage_x86<double, void>(arena, sizes);
+
+    using tmp_t = decltype(tmp);
+    static_assert(is_sid<tmp_t>(), "");
+    static_assert(std::is_same<sid::ptr_type<tmp_t>, double *>(), "");
+
+    auto strides = sid::get_strides(tmp);
+    EXPECT_EQ(sid::get_stride<dim::k>(strides), 1);
+    EXPECT_EQ(sid::get_stride<dim::j>(strides), 7);
+    EXPECT_EQ(sid::get_stride<dim::i>(strides), 28);
+    EXPECT_EQ(sid::get_stride<dim::thread>(strides) * sizeof(double), arena.slab_size());
+
+    auto f = [](int_t i, int_t j, int_t k, int_t t) { return i + j * 100 + k * 200 + t * 400; };
+
+#pragma omp parallel
+    {
+        const int_t thread = omp_get_thread_num();
+        double *ptr = sid::get_origin(tmp)();
+        sid::shift(ptr, sid::get_stride<dim::thread>(strides), thread);
+        EXPECT_NE(reinterpret_cast<void *>(ptr), reinterpret_cast<void *>(other));
+        for (int_t i = 0; i < 5; ++i)
+            for (int_t j = 0; j < 4; ++j)
+                for (int_t k = 0; k < 7; ++k) {
+                    double *p = ptr;
+                    sid::shift(p, sid::get_stride<dim::i>(strides), i);
+                    sid::shift(p, sid::get_stride<dim::j>(strides), j);
+                    sid::shift(p, sid::get_stride<dim::k>(strides), k);
+                    *p = f(i, j, k, thread);
+                }
+
+#pragma omp barrier
+
+        for (int_t i = 0; i < 5; ++i)
+            for (int_t j = 0; j < 4; ++j)
+                for (int_t k = 0; k < 7; ++k) {
+                    double *p = ptr;
+                    sid::shift(p, sid::get_stride<dim::i>(strides), i);
+                    sid::shift(p, sid::get_stride<dim::j>(strides), j);
+                    sid::shift(p, sid::get_stride<dim::k>(strides), k);
+                    EXPECT_EQ(*p, f(i, j, k, thread));
+                }
+    }
+}
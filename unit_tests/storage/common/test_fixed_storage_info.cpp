@@ -0,0 +1,59 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/storage/common/fixed_storage_info.hpp>
+
+#include <type_traits>
+
+#include "gtest/gtest.h"
+
+#include <gridtools/common/tuple_util.hpp>
+
+using namespace gridtools;
+
+namespace {
+    template <typename StorageInfo, uint_t... Sizes>
+    void check_strides() {
+        using testee_t = fixed_storage_info<StorageInfo, Sizes...>;
+        testee_t testee;
+        StorageInfo reference(Sizes...);
+
+        EXPECT_TRUE(testee == reference);
+        EXPECT_EQ(testee.template stride<0>(), (testee_t::template fixed_stride<0>()));
+        EXPECT_EQ(testee.template stride<1>(), (testee_t::template fixed_stride<1>()));
+        EXPECT_EQ(testee.template stride<2>(), (testee_t::template fixed_stride<2>()));
+        EXPECT_EQ(reference.template stride<0>(), (tuple_util::get<0>(typename testee_t::fixed_strides_t{})));
+        EXPECT_EQ(reference.template stride<1>(), (tuple_util::get<1>(typename testee_t::fixed_strides_t{})));
+        EXPECT_EQ(reference.template stride<2>(), (tuple_util::get<2>(typename testee_t::fixed_strides_t{})));
+    }
+} // namespace
+
+TEST(FixedStorageInfo, Strides) {
+    check_strides<storage_info<0, layout_map<0, 1, 2>>, 3, 4, 5>();
+    check_strides<storage_info<0, layout_map<2, 0, 1>>, 3, 4, 5>();
+    check_strides<storage_info<0, layout_map<-1, 0, 1>>, 3, 4, 5>();
+    check_strides<storage_info<0, layout_map<1, 0, -1>>, 3, 4, 5>();
+    check_strides<storage_info<0, layout_map<0, 1, 2>, halo<0, 0, 0>, alignment<32>>, 3, 4, 5>();
+    check_strides<storage_info<0, layout_map<2, 1, 0>, halo<2, 2, 0>, alignment<8>>, 13, 9, 7>();
+
+    using testee_t = fixed_storage_info<storage_info<0, layout_map<0, 1, 2>, halo<0, 0, 0>, alignment<32>>, 3, 4, 5>;
+    static_assert(is_storage_info<testee_t>::value, "");
+    static_assert(testee_t::fixed_stride<0>() == 128, "");
+    static_assert(testee_t::fixed_stride<1>() == 32, "");
+    static_assert(testee_t::fixed_stride<2>() == 1, "");
+    static_assert(std::is_same<tuple_util::element<0, testee_t::fixed_strides_t>, integral_constant<int_t, 128>>(), "");
+}
+
+TEST(FixedStorageInfo, RuntimeSizes) {
+    using testee_t = fixed_storage_info<storage_info<0, layout_map<0, 1, 2>>, 3, 4, 5>;
+    testee_t testee(3, 4, 5);
+    EXPECT_EQ(testee.total_length<2>(), 5);
+    EXPECT_ANY_THROW(testee_t(3, 4, 6));
+}
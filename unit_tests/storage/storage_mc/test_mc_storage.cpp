@@ -0,0 +1,74 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "gtest/gtest.h"
+
+#include <gridtools/storage/data_store.hpp>
+#include <gridtools/storage/storage_mc/data_view_helpers.hpp>
+#include <gridtools/storage/storage_mc/mc_storage.hpp>
+#include <gridtools/storage/storage_mc/mc_storage_info.hpp>
+#include <gridtools/storage/storage_traits_mc.hpp>
+
+using namespace gridtools;
+
+namespace {
+    template <class StorageInfo, class Storage>
+    void expect_zeros(StorageInfo const &info, Storage const &storage) {
+        auto *ptr = storage.get_cpu_ptr();
+        for (uint_t i = 0; i < info.padded_total_length(); ++i)
+            EXPECT_EQ(ptr[i], 0);
+    }
+
+    template <numa_placement Placement, class StorageInfo>
+    void check_first_touch(StorageInfo const &info) {
+        mc_storage<double, Placement> storage(
+            info.padded_total_length(), info.first_index_of_inner_region(), typename StorageInfo::alignment_t{});
+        auto *ptr = storage.get_cpu_ptr();
+        for (uint_t i = 0; i < info.padded_total_length(); ++i)
+            ptr[i] = 42;
+        storage.first_touch(info);
+        expect_zeros(info, storage);
+    }
+} // namespace
+
+TEST(mc_storage, blocked_first_touch) {
+    check_first_touch<numa_placement::blocked>(mc_storage_info<0, layout_map<2, 0, 1>, halo<2, 1, 0>>(13, 27, 5));
+    check_first_touch<numa_placement::blocked>(
+        mc_storage_info<1, layout_map<3, 0, 2, 1>, halo<1, 3, 0, 0>>(9, 7, 4, 3));
+    check_first_touch<numa_placement::blocked>(mc_storage_info<2, layout_map<1, -1, 0>>(10, 11, 12));
+    check_first_touch<numa_placement::blocked>(mc_storage_info<3, layout_map<0>>(100));
+}
+
+TEST(mc_storage, interleaved_first_touch) {
+    check_first_touch<numa_placement::interleave>(mc_storage_info<0, layout_map<2, 0, 1>, halo<2, 1, 0>>(13, 27, 5));
+    check_first_touch<numa_placement::interleave>(mc_storage_info<1, layout_map<2, 0, 1>>(300, 400, 3));
+}
+
+TEST(mc_storage, data_store) {
+    using storage_info_t = mc_storage_info<0, layout_map<2, 0, 1>, halo<1, 1, 0>>;
+    storage_info_t info(17, 19, 7);
+    auto init = [](int i, int j, int k) { return i + 100 * j + 10000 * k; };
+
+    using traits_t = storage_traits_from_id<backend::mc>;
+    traits_t::numa_data_store_t<double, storage_info_t, numa_placement::interleave> interleaved(info, init);
+    data_store<mc_storage<double>, storage_info_t> blocked(info, init);
+
+    auto interleaved_view = make_host_view(interleaved);
+    auto blocked_view = make_host_view(blocked);
+    for (int i = 0; i < 17; ++i)
+        for (int j = 0; j < 19; ++j)
+            for (int k = 0; k < 7; ++k) {
+                EXPECT_EQ(interleaved_view(i, j, k), init(i, j, k));
+                EXPECT_EQ(blocked_view(i, j, k), init(i, j, k));
+            }
+
+    data_store<mc_storage<double>, storage_info_t> uninitialized(info);
+    expect_zeros(info, *uninitialized.get_storage_ptr());
+}
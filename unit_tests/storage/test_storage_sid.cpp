@@ -19,7 +19,9 @@
 #include <gridtools/common/tuple_util.hpp>
 #include <gridtools/meta/macros.hpp>
 #include <gridtools/meta/type_traits.hpp>
+#include <gridtools/stencil_composition/sid/composite.hpp>
 #include <gridtools/stencil_composition/sid/concept.hpp>
+#include <gridtools/stencil_composition/sid/multi_shift.hpp>
 #include <gridtools/storage/storage_facility.hpp>
 #include <gridtools/tools/backend_select.hpp>
 
@@ -119,6 +121,42 @@ namespace gridtools {
             EXPECT_EQ(info.padded_length<3>(), (at_key<dim<3>>(upper_bounds)));
         }
 
+        TEST(storage_sid, fixed_strides) {
+            using fixed_info_t = fixed_storage_info<storage_info_t, 10, 20, 30, 40>;
+            using fixed_data_store_t = traits_t::data_store_t<float_type, fixed_info_t>;
+            using strides_t = sid::strides_type<fixed_data_store_t>;
+
+            static_assert(tu::size<strides_t>() == 4, "");
+            static_assert(std::is_same<tu::element<1, strides_t>, integral_constant<int_t, 0>>(), "");
+            static_assert(std::is_same<tu::element<2, strides_t>, integral_constant<int_t, 1>>(), "");
+            static_assert(std::is_same<sid::strides_kind<fixed_data_store_t>, fixed_info_t>(), "");
+
+            fixed_data_store_t testee = {fixed_info_t{}, 0};
+            data_store_t reference = {{10, 20, 30, 40}, 0};
+            auto strides = sid::get_strides(testee);
+            auto expected_strides = sid::get_strides(reference);
+            static_assert(tu::element<0, strides_t>::value > 0, "");
+            static_assert(tu::element<3, strides_t>::value > 0, "");
+
+            EXPECT_EQ(get<0>(expected_strides), get<0>(strides));
+            EXPECT_EQ(get<3>(expected_strides), get<3>(strides));
+            EXPECT_EQ(testee.strides(), reference.strides());
+
+            auto testee_strides = sid::get_strides(as_host(testee));
+            EXPECT_EQ(get<0>(expected_strides), get<0>(testee_strides));
+
+            // the constant strides are kept by composites
+            struct a;
+            struct b;
+            auto composite = sid::composite::keys<a, b>::values<fixed_data_store_t, fixed_data_store_t>(testee, testee);
+            auto composite_strides = sid::get_strides(composite);
+            using composite_stride_t = std::decay_t<decltype(sid::get_stride<dim<3>>(composite_strides))>;
+            static_assert(std::is_same<tu::element<0, composite_stride_t>, tu::element<3, strides_t>>(), "");
+            auto ptr = sid::get_origin(composite)();
+            sid::multi_shift(ptr, composite_strides, hymap::keys<dim<0>, dim<3>>::values<int_t, int_t>(2, 1));
+            EXPECT_EQ(at_key<b>(ptr) - sid::get_origin(testee)(), 2 * get<0>(strides) + get<3>(strides));
+        }
+
         TEST(storage_sid, scalar) {
             using storage_info_t = traits_t::custom_layout_storage_info_t<0, layout_map<-1>>;
             using testee_t = traits_t::data_store_t<float_type, storage_info_t>;